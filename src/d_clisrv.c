@@ -44,6 +44,9 @@
 #include "m_argv.h"
 #include "p_setup.h"
 #include "lzf.h"
+#ifdef HAVE_ZLIB
+#include "zlib.h"
+#endif
 #include "lua_script.h"
 #include "lua_hook.h"
 #include "k_kart.h"
@@ -108,6 +111,9 @@ boolean nodeingame[MAXNETNODES]; // set false as nodes leave game
 tic_t servermaxping = 20; // server's max delay, in frames. Defaults to 20
 static tic_t nettics[MAXNETNODES]; // what tic the client have received
 static tic_t supposedtics[MAXNETNODES]; // nettics prevision for smaller packet
+static tic_t ticcmdbasefloor[MAXNETNODES]; // first tic that can be a delta base for the node's ticcmds
+static boolean ticcmdspawnpending[MAXNETNODES]; // node hasn't run ticcmdspawntic yet, see SV_SpawnPlayer
+static tic_t ticcmdspawntic[MAXNETNODES];
 static UINT8 nodewaiting[MAXNETNODES];
 static tic_t firstticstosend; // min of the nettics
 static tic_t tictoclear = 0; // optimize d_clearticcmd
@@ -209,6 +215,165 @@ static inline void *G_ScpyTiccmd(ticcmd_t* dest, void* src, const size_t n)
 	return ret+n;
 }
 
+// Delta encoded ticcmds for PT_SERVERTICS
+//
+// Each ticcmd is a byte of TD_* flags for the fields which differ from the
+// same slot in the tic before, followed by those fields. The first tic of a
+// packet is against the tic before starttic: a client only uses a packet when
+// it already has every tic up to starttic, so it always has that one too.
+// The server only has to make sure the client's copy of it is the same as its
+// own, see ticcmdbasefloor and SV_EncodeTiccmds.
+
+#define TD_FORWARDMOVE 0x01
+#define TD_SIDEMOVE    0x02
+#define TD_ANGLETURN   0x04
+#define TD_AIMING      0x08
+#define TD_BUTTONS     0x10
+#define TD_DRIFTTURN   0x20
+#define TD_LATENCY     0x40
+
+static UINT8 ticcmddeltabuf[BACKUPTICS * MAXPLAYERS * (sizeof (ticcmd_t) + 1)];
+static ticcmd_t ticcmddeltacmds[BACKUPTICS][MAXPLAYERS];
+
+static UINT8 *G_WriteTiccmdDelta(UINT8 *p, const ticcmd_t *cmd, const ticcmd_t *base)
+{
+	UINT8 *flags = p++;
+
+	*flags = 0;
+	if (cmd->forwardmove != base->forwardmove)
+	{
+		*flags |= TD_FORWARDMOVE;
+		WRITESINT8(p, cmd->forwardmove);
+	}
+	if (cmd->sidemove != base->sidemove)
+	{
+		*flags |= TD_SIDEMOVE;
+		WRITESINT8(p, cmd->sidemove);
+	}
+	if (cmd->angleturn != base->angleturn)
+	{
+		*flags |= TD_ANGLETURN;
+		WRITEINT16(p, cmd->angleturn);
+	}
+	if (cmd->aiming != base->aiming)
+	{
+		*flags |= TD_AIMING;
+		WRITEINT16(p, cmd->aiming);
+	}
+	if (cmd->buttons != base->buttons)
+	{
+		*flags |= TD_BUTTONS;
+		WRITEUINT16(p, cmd->buttons);
+	}
+	if (cmd->driftturn != base->driftturn)
+	{
+		*flags |= TD_DRIFTTURN;
+		WRITEINT16(p, cmd->driftturn);
+	}
+	if (cmd->latency != base->latency)
+	{
+		*flags |= TD_LATENCY;
+		WRITEUINT8(p, cmd->latency);
+	}
+	return p;
+}
+
+// Returns NULL if the ticcmd runs past end
+static UINT8 *G_ReadTiccmdDelta(UINT8 *p, const UINT8 *end, ticcmd_t *cmd, const ticcmd_t *base)
+{
+	UINT8 flags;
+	size_t size = 0;
+
+	if (p >= end)
+		return NULL;
+	flags = READUINT8(p);
+
+	if (flags & TD_FORWARDMOVE) size += 1;
+	if (flags & TD_SIDEMOVE)    size += 1;
+	if (flags & TD_ANGLETURN)   size += 2;
+	if (flags & TD_AIMING)      size += 2;
+	if (flags & TD_BUTTONS)     size += 2;
+	if (flags & TD_DRIFTTURN)   size += 2;
+	if (flags & TD_LATENCY)     size += 1;
+	if (p + size > end)
+		return NULL;
+
+	*cmd = *base;
+	if (flags & TD_FORWARDMOVE)
+		cmd->forwardmove = READSINT8(p);
+	if (flags & TD_SIDEMOVE)
+		cmd->sidemove = READSINT8(p);
+	if (flags & TD_ANGLETURN)
+		cmd->angleturn = READINT16(p);
+	if (flags & TD_AIMING)
+		cmd->aiming = READINT16(p);
+	if (flags & TD_BUTTONS)
+		cmd->buttons = READUINT16(p);
+	if (flags & TD_DRIFTTURN)
+		cmd->driftturn = READINT16(p);
+	if (flags & TD_LATENCY)
+		cmd->latency = READUINT8(p);
+	return p;
+}
+
+/** Delta encodes the ticcmds of tics firsttic to lasttic-1 for a node into
+  * ticcmddeltabuf.
+  *
+  * \return The encoded size, or 0 if the node can't be sent deltas from firsttic
+  */
+static size_t SV_EncodeTiccmds(INT32 node, tic_t firsttic, tic_t lasttic)
+{
+	UINT8 *p = ticcmddeltabuf;
+	tic_t i;
+	INT32 j;
+
+	// Tics before firstticstosend have been cleared by D_Clearticcmd
+	if (!firsttic || firsttic - 1 < ticcmdbasefloor[node] || firsttic - 1 < firstticstosend)
+		return 0;
+
+	// Don't know yet which of its tics the node's own spawn will rewrite
+	if (ticcmdspawnpending[node])
+		return 0;
+
+	for (i = firsttic; i < lasttic; i++)
+		for (j = 0; j < doomcom->numslots; j++)
+			p = G_WriteTiccmdDelta(p, &netcmds[i%TICQUEUE][j], &netcmds[(i-1)%TICQUEUE][j]);
+
+	return p - ticcmddeltabuf;
+}
+
+/** Decodes the delta encoded ticcmds of a PT_SERVERTICS packet into
+  * ticcmddeltacmds, against the tic before starttic.
+  *
+  * \return Where the textcmds start, or NULL if the packet is malformed
+  */
+static UINT8 *CL_DecodeTiccmds(UINT8 *p, const UINT8 *end, tic_t starttic, UINT8 numtics, UINT8 numslots)
+{
+	const ticcmd_t *base = netcmds[(starttic-1)%TICQUEUE];
+	UINT8 i, j;
+
+	if (numtics > BACKUPTICS || numslots > MAXPLAYERS)
+		return NULL;
+
+	for (i = 0; i < numtics; i++)
+	{
+		for (j = 0; j < numslots; j++)
+			if (!(p = G_ReadTiccmdDelta(p, end, &ticcmddeltacmds[i][j], &base[j])))
+				return NULL;
+		base = ticcmddeltacmds[i];
+	}
+	return p;
+}
+
+// Stops the node from being sent deltas against any tic before floor
+static void SV_InvalidateTiccmdBases(tic_t floor)
+{
+	INT32 node;
+	for (node = 0; node < MAXNETNODES; node++)
+		if (ticcmdbasefloor[node] < floor)
+			ticcmdbasefloor[node] = floor;
+}
+
 
 
 // Some software don't support largest packet
@@ -1110,6 +1275,49 @@ static INT16 Consistancy(void);
 #define JOININGAME
 #endif
 
+#ifdef JOININGAME
+// How a sent savegame is compressed, see cv_savecompression
+#define SAVECODEC_NONE    0
+#define SAVECODEC_LZF     1
+#define SAVECODEC_DEFLATE 2
+
+#ifdef HAVE_ZLIB
+#define SAVECODECS ((1<<SAVECODEC_NONE)|(1<<SAVECODEC_LZF)|(1<<SAVECODEC_DEFLATE))
+#else
+#define SAVECODECS ((1<<SAVECODEC_NONE)|(1<<SAVECODEC_LZF))
+#endif
+
+// A netgame save as sent to a joining client, split up into the
+// sections P_SaveNetGame writes.
+typedef struct
+{
+	UINT8 *data;
+	size_t length;
+	UINT32 hash;
+	size_t sections[NUMNETSAVESECTIONS+1]; // offsets into data, the last one is the length
+} netsave_t;
+
+// The client keeps the last save it got, and tells the server about it
+// when joining; if the server still has that one it sends a delta.
+static netsave_t savebaseline;
+
+// For the savegamestats command
+static struct
+{
+	// server
+	UINT32 sends, deltas;
+	UINT64 rawbytes, sentbytes;
+	UINT32 lzfsends;
+	UINT64 lzfrawbytes, lzfbytes; // what whole LZF saves would have been, DBG_NETPLAY only
+	precise_t savetime, encodetime;
+
+	// client, last join only
+	precise_t joinstart, jointime, loadtime;
+	size_t recvbytes, recvraw;
+	boolean recvdelta;
+} savegamestats;
+#endif
+
 typedef enum
 {
 	CL_SEARCHING,
@@ -1424,6 +1632,16 @@ static boolean CL_SendJoin(void)
 	netbuffer->u.clientcfg.subversion = SUBVERSION;
 	strncpy(netbuffer->u.clientcfg.application, SRB2APPLICATION,
 			sizeof netbuffer->u.clientcfg.application);
+#ifdef JOININGAME
+	netbuffer->u.clientcfg.savecodecs = SAVECODECS;
+	netbuffer->u.clientcfg.savebase = LONG(savebaseline.hash);
+	netbuffer->u.clientcfg.savebaselength = LONG((UINT32)savebaseline.length);
+	savegamestats.joinstart = I_GetPreciseTime();
+#else
+	netbuffer->u.clientcfg.savecodecs = 0;
+	netbuffer->u.clientcfg.savebase = 0;
+	netbuffer->u.clientcfg.savebaselength = 0;
+#endif
 
 	return HSendPacket(servernode, false, 0, sizeof (clientconfig_pak));
 }
@@ -1754,12 +1972,264 @@ static boolean SV_SendServerConfig(INT32 node)
 #ifdef JOININGAME
 #define SAVEGAMESIZE (768*1024)
 
-static void SV_SendSaveGame(INT32 node)
+static CV_PossibleValue_t savecompression_cons_t[] = {
+	{SAVECODEC_NONE, "None"},
+	{SAVECODEC_LZF, "LZF"},
+#ifdef HAVE_ZLIB
+	{SAVECODEC_DEFLATE, "Deflate"},
+#endif
+	{0, NULL}};
+#ifdef HAVE_ZLIB
+static consvar_t cv_savecompression = {"savecompression", "Deflate", CV_SAVE, savecompression_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+#else
+static consvar_t cv_savecompression = {"savecompression", "LZF", CV_SAVE, savecompression_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+#endif
+
+// Each section of a sent savegame is either sent whole, or as a delta
+// against the same section of an older save the client still has.
+#define SAVESECTION_RAW   0
+#define SAVESECTION_DELTA 1
+
+// A delta is a run of ops rebuilding the new section:
+//   SAVEDELTA_LITERAL, UINT32 length, the bytes
+//   SAVEDELTA_COPY, UINT32 offset, UINT32 length, taken from the old section
+#define SAVEDELTA_LITERAL 0
+#define SAVEDELTA_COPY    1
+
+#define SAVEDELTA_BLOCK    16 // smallest run worth a copy
+#define SAVEDELTA_HASHBITS 16
+
+// The last few saves the server sent, any of which a rejoining client may
+// still have as its baseline.
+#define MAXKEYFRAMES 4
+static netsave_t keyframes[MAXKEYFRAMES];
+
+static UINT32 SaveGameHash(const UINT8 *data, size_t length)
 {
-	size_t length, compressedlen;
-	UINT8 *savebuffer;
-	UINT8 *compressedsave;
-	UINT8 *buffertosend;
+	UINT32 hash = 2166136261u;
+
+	while (length--)
+		hash = (hash ^ *data++) * 16777619u;
+
+	return hash ? hash : 1; // 0 means no save
+}
+
+static inline UINT32 SaveDeltaBlockHash(const UINT8 *p)
+{
+	UINT32 hash = 2166136261u;
+	INT32 i;
+
+	for (i = 0; i < SAVEDELTA_BLOCK; i++)
+		hash = (hash ^ p[i]) * 16777619u;
+
+	return hash >> (32 - SAVEDELTA_HASHBITS);
+}
+
+static boolean SaveDeltaLiteral(UINT8 **out, UINT8 *end, const UINT8 *data, size_t length)
+{
+	UINT8 *p = *out;
+
+	if (!length)
+		return true;
+	if ((size_t)(end - p) < 5 + length)
+		return false;
+
+	WRITEUINT8(p, SAVEDELTA_LITERAL);
+	WRITEUINT32(p, (UINT32)length);
+	M_Memcpy(p, data, length);
+	*out = p + length;
+	return true;
+}
+
+/** Encodes a savegame section as copies out of the same section of an older
+  * save, with literal runs for whatever couldn't be found in it. Blocks of
+  * the old section are hashed, so moved data (thinkers coming and going)
+  * still gets matched.
+  *
+  * \return Length of the delta, or 0 if it wouldn't fit in outlength.
+  */
+static size_t SaveDeltaEncode(const UINT8 *base, size_t baselength, const UINT8 *cur, size_t curlength, UINT8 *out, size_t outlength)
+{
+	INT32 *table;
+	UINT8 *p = out, *end = out + outlength;
+	size_t i, lit;
+
+	table = malloc((1<<SAVEDELTA_HASHBITS) * sizeof *table);
+	if (!table)
+		return 0;
+	memset(table, -1, (1<<SAVEDELTA_HASHBITS) * sizeof *table);
+
+	for (i = 0; i + SAVEDELTA_BLOCK <= baselength; i += SAVEDELTA_BLOCK)
+		table[SaveDeltaBlockHash(base + i)] = (INT32)i;
+
+	i = lit = 0;
+	while (i + SAVEDELTA_BLOCK <= curlength)
+	{
+		INT32 pos = table[SaveDeltaBlockHash(cur + i)];
+		size_t from, len;
+
+		if (pos < 0 || memcmp(base + pos, cur + i, SAVEDELTA_BLOCK))
+		{
+			i++;
+			continue;
+		}
+
+		// Grow the match both ways.
+		from = (size_t)pos;
+		while (i > lit && from > 0 && base[from - 1] == cur[i - 1])
+		{
+			i--;
+			from--;
+		}
+		len = SAVEDELTA_BLOCK + ((size_t)pos - from);
+		while (from + len < baselength && i + len < curlength && base[from + len] == cur[i + len])
+			len++;
+
+		if (!SaveDeltaLiteral(&p, end, cur + lit, i - lit) || end - p < 9)
+		{
+			free(table);
+			return 0;
+		}
+		WRITEUINT8(p, SAVEDELTA_COPY);
+		WRITEUINT32(p, (UINT32)from);
+		WRITEUINT32(p, (UINT32)len);
+
+		i += len;
+		lit = i;
+	}
+
+	free(table);
+	if (!SaveDeltaLiteral(&p, end, cur + lit, curlength - lit))
+		return 0;
+	return p - out;
+}
+
+static void SaveDeltaDecode(const UINT8 *base, size_t baselength, UINT8 *delta, size_t deltalength, UINT8 *out, size_t outlength)
+{
+	UINT8 *p = delta, *end = delta + deltalength;
+	size_t written = 0;
+
+	while (p < end)
+	{
+		UINT8 op = READUINT8(p);
+		size_t from = 0, len;
+
+		if (op == SAVEDELTA_COPY)
+			from = READUINT32(p);
+		len = READUINT32(p);
+
+		if (written + len > outlength
+			|| (op == SAVEDELTA_COPY && from + len > baselength)
+			|| (op == SAVEDELTA_LITERAL && len > (size_t)(end - p))
+			|| op > SAVEDELTA_COPY)
+			I_Error("Savegame delta is corrupt");
+
+		if (op == SAVEDELTA_COPY)
+			M_Memcpy(out + written, base + from, len);
+		else
+		{
+			M_Memcpy(out + written, p, len);
+			p += len;
+		}
+		written += len;
+	}
+
+	if (written != outlength)
+		I_Error("Savegame delta is corrupt");
+}
+
+// Returns the compressed length, or 0 if it didn't get any smaller.
+static size_t SaveGameCompress(UINT8 codec, UINT8 *in, size_t inlength, UINT8 *out, size_t outlength)
+{
+	switch (codec)
+	{
+		case SAVECODEC_LZF:
+			return lzf_compress(in, inlength, out, outlength);
+#ifdef HAVE_ZLIB
+		case SAVECODEC_DEFLATE:
+		{
+			uLongf len = outlength;
+			if (compress2(out, &len, in, inlength, Z_BEST_COMPRESSION) != Z_OK)
+				return 0;
+			return len;
+		}
+#endif
+		default:
+			return 0;
+	}
+}
+
+static void SaveGameDecompress(UINT8 codec, UINT8 *in, size_t inlength, UINT8 *out, size_t outlength)
+{
+	size_t len = inlength;
+
+	switch (codec)
+	{
+		case SAVECODEC_NONE:
+			if (inlength != outlength)
+				len = 0;
+			else
+				M_Memcpy(out, in, len);
+			break;
+		case SAVECODEC_LZF:
+			len = lzf_decompress(in, inlength, out, outlength);
+			break;
+#ifdef HAVE_ZLIB
+		case SAVECODEC_DEFLATE:
+		{
+			uLongf zlen = outlength;
+			if (uncompress(out, &zlen, in, inlength) != Z_OK)
+				zlen = 0;
+			len = zlen;
+			break;
+		}
+#endif
+		default:
+			I_Error("Savegame uses a compression this build doesn't support");
+	}
+
+	if (len != outlength)
+		I_Error("Can't decompress savegame sent");
+}
+
+static void SV_StoreKeyframe(netsave_t *save)
+{
+	INT32 i;
+
+	for (i = 0; i < MAXKEYFRAMES; i++)
+		if (keyframes[i].data && keyframes[i].hash == save->hash && keyframes[i].length == save->length)
+		{
+			free(save->data);
+			return;
+		}
+
+	free(keyframes[MAXKEYFRAMES-1].data);
+	memmove(&keyframes[1], &keyframes[0], (MAXKEYFRAMES-1) * sizeof *keyframes);
+	keyframes[0] = *save;
+}
+
+/** Sends the game state to a joining node. Every section of the save goes
+  * as a delta if the client still has one of our recent saves, otherwise
+  * whole; the lot is then compressed with cv_savecompression.
+  *
+  * Sent as: UINT8 codec, UINT32 body length, compressed body. The body is
+  * the hash of the save the deltas are against (0 for none), the hash of
+  * this save, and per section a SAVESECTION_* byte, UINT32 section length,
+  * UINT32 encoded length and the encoded section.
+  */
+static void SV_SendSaveGame(INT32 node, UINT32 basehash, UINT32 baselength, UINT8 codecs)
+{
+	netsave_t save;
+	netsave_t *base = NULL;
+
+	size_t bodylength, compressedlen, length, i;
+	UINT8 *savebuffer, *body, *buffertosend, *p;
+	UINT8 codec;
+	precise_t t = I_GetPreciseTime();
+
+	// The client starts over from this tic, without any ticcmds before it
+	ticcmdbasefloor[node] = gametic;
+	ticcmdspawnpending[node] = false;
 
 	// first save it in a malloced buffer
 	savebuffer = (UINT8 *)malloc(SAVEGAMESIZE);
@@ -1769,8 +2239,7 @@ static void SV_SendSaveGame(INT32 node)
 		return;
 	}
 
-	// Leave room for the uncompressed length.
-	save_p = savebuffer + sizeof(UINT32);
+	save_p = savebuffer;
 
 	P_SaveNetGame();
 
@@ -1781,47 +2250,157 @@ static void SV_SendSaveGame(INT32 node)
 		save_p = NULL;
 		I_Error("Savegame buffer overrun");
 	}
+	save_p = NULL;
+
+	save.data = realloc(savebuffer, length);
+	if (!save.data)
+		save.data = savebuffer;
+	save.length = length;
+	for (i = 0; i < NUMNETSAVESECTIONS; i++)
+		save.sections[i] = netsavesections[i] - savebuffer;
+	save.sections[NUMNETSAVESECTIONS] = length;
+	save.hash = SaveGameHash(save.data, length);
+
+	savegamestats.savetime += I_GetPreciseTime() - t;
+	t = I_GetPreciseTime();
+
+	if (basehash)
+		for (i = 0; i < MAXKEYFRAMES; i++)
+			if (keyframes[i].data && keyframes[i].hash == basehash && keyframes[i].length == baselength)
+			{
+				base = &keyframes[i];
+				break;
+			}
 
-	// Allocate space for compressed save: one byte fewer than for the
-	// uncompressed data to ensure that the compression is worthwhile.
-	compressedsave = malloc(length - 1);
-	if (!compressedsave)
+	body = malloc(8 + NUMNETSAVESECTIONS*9 + length);
+	if (!body)
 	{
+		free(save.data);
 		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
 		return;
 	}
 
-	// Attempt to compress it.
-	if((compressedlen = lzf_compress(savebuffer + sizeof(UINT32), length - sizeof(UINT32), compressedsave + sizeof(UINT32), length - sizeof(UINT32) - 1)))
+	p = body;
+	WRITEUINT32(p, base ? base->hash : 0);
+	WRITEUINT32(p, save.hash);
+	for (i = 0; i < NUMNETSAVESECTIONS; i++)
 	{
-		// Compressing succeeded; send compressed data
+		UINT8 *cur = save.data + save.sections[i];
+		size_t curlength = save.sections[i+1] - save.sections[i];
+		size_t deltalength = 0;
 
-		free(savebuffer);
+		// Deltas only go out if they're actually smaller.
+		if (base)
+			deltalength = SaveDeltaEncode(base->data + base->sections[i], base->sections[i+1] - base->sections[i],
+				cur, curlength, p + 9, curlength);
+
+		if (deltalength)
+		{
+			WRITEUINT8(p, SAVESECTION_DELTA);
+			WRITEUINT32(p, (UINT32)curlength);
+			WRITEUINT32(p, (UINT32)deltalength);
+			p += deltalength;
+		}
+		else
+		{
+			WRITEUINT8(p, SAVESECTION_RAW);
+			WRITEUINT32(p, (UINT32)curlength);
+			WRITEUINT32(p, (UINT32)curlength);
+			M_Memcpy(p, cur, curlength);
+			p += curlength;
+		}
+	}
+	bodylength = p - body;
 
-		// State that we're compressed.
-		buffertosend = compressedsave;
-		WRITEUINT32(compressedsave, length - sizeof(UINT32));
-		length = compressedlen + sizeof(UINT32);
+	codec = (UINT8)cv_savecompression.value;
+	if (!(codecs & (1<<codec)))
+		codec = SAVECODEC_LZF; // old enough to be understood by anyone
+
+	// Leave room for the codec and the uncompressed length.
+	buffertosend = malloc(5 + bodylength);
+	if (!buffertosend)
+	{
+		free(body);
+		free(save.data);
+		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
+		return;
 	}
-	else
+
+	// One byte fewer than the body, to make sure compressing was worthwhile.
+	compressedlen = SaveGameCompress(codec, body, bodylength, buffertosend + 5, bodylength - 1);
+	if (!compressedlen)
 	{
-		// Compression failed to make it smaller; send original
+		codec = SAVECODEC_NONE;
+		M_Memcpy(buffertosend + 5, body, bodylength);
+		compressedlen = bodylength;
+	}
+	free(body);
+
+	p = buffertosend;
+	WRITEUINT8(p, codec);
+	WRITEUINT32(p, (UINT32)bodylength);
+	length = 5 + compressedlen;
 
-		free(compressedsave);
+	savegamestats.encodetime += I_GetPreciseTime() - t;
+	savegamestats.sends++;
+	if (base)
+		savegamestats.deltas++;
+	savegamestats.rawbytes += save.length;
+	savegamestats.sentbytes += length;
 
-		// State that we're not compressed
-		buffertosend = savebuffer;
-		WRITEUINT32(savebuffer, 0);
+	// For comparison, how big the save used to be when sent whole with LZF.
+	// Compressing it again is slow, so only when debugging netplay.
+	if (cv_debug & DBG_NETPLAY)
+	{
+		UINT8 *lzf = malloc(save.length);
+		size_t lzflength = lzf ? lzf_compress(save.data, save.length, lzf, save.length - 1) : 0;
+		savegamestats.lzfsends++;
+		savegamestats.lzfrawbytes += save.length;
+		savegamestats.lzfbytes += lzflength ? lzflength + 4 : save.length + 4;
+		free(lzf);
 	}
 
+	CONS_Debug(DBG_NETPLAY, "Savegame for node %d: %s bytes, sent %s%s\n", node,
+		sizeu1(save.length), sizeu2(length), base ? " as a delta" : "");
+
 	SV_SendRam(node, buffertosend, length, SF_RAM, 0);
-	save_p = NULL;
+	SV_StoreKeyframe(&save);
 
 	// Remember when we started sending the savegame so we can handle timeouts
 	sendingsavegame[node] = true;
 	freezetimeout[node] = I_GetTime() + jointimeout + length / 1024; // 1 extra tic for each kilobyte
 }
 
+static void Command_SavegameStats_f(void)
+{
+	double scale = 1000.0 / I_GetPrecisePrecision();
+
+	if (savegamestats.sends)
+	{
+		CONS_Printf(M_GetText("Sent %u savegames, %u of them as deltas\n"), savegamestats.sends, savegamestats.deltas);
+		CONS_Printf(M_GetText("%s k saved, %s k sent\n"),
+			sizeu1((size_t)(savegamestats.rawbytes>>10)), sizeu2((size_t)(savegamestats.sentbytes>>10)));
+		if (savegamestats.lzfsends)
+			CONS_Printf(M_GetText("%u of them, %s k saved, would have been %s k whole with LZF\n"), savegamestats.lzfsends,
+				sizeu1((size_t)(savegamestats.lzfrawbytes>>10)), sizeu2((size_t)(savegamestats.lzfbytes>>10)));
+		CONS_Printf(M_GetText("%.2f ms saving, %.2f ms encoding per savegame\n"),
+			savegamestats.savetime * scale / savegamestats.sends,
+			savegamestats.encodetime * scale / savegamestats.sends);
+	}
+
+	if (savegamestats.recvraw)
+	{
+		CONS_Printf(M_GetText("Last join: got %s bytes for a %s byte savegame%s\n"),
+			sizeu1(savegamestats.recvbytes), sizeu2(savegamestats.recvraw),
+			savegamestats.recvdelta ? M_GetText(" as a delta") : "");
+		CONS_Printf(M_GetText("%.2f ms from join request to game loaded, %.2f ms of it loading\n"),
+			savegamestats.jointime * scale, savegamestats.loadtime * scale);
+	}
+
+	if (!savegamestats.sends && !savegamestats.recvraw)
+		CONS_Printf(M_GetText("No savegames sent or received yet.\n"));
+}
+
 #ifdef DUMPCONSISTENCY
 #define TMPSAVENAME "badmath.sav"
 static consvar_t cv_dumpconsistency = {"dumpconsistency", "Off", CV_NETVAR, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
@@ -1871,8 +2450,9 @@ static void SV_SavedGame(void)
 static void CL_LoadReceivedSavegame(void)
 {
 	UINT8 *savebuffer = NULL;
-	size_t length, decompressedlen;
+	size_t length;
 	XBOXSTATIC char tmpsave[264];
+	precise_t loadstart = I_GetPreciseTime();
 
 	sprintf(tmpsave, "%s" PATHSEP TMPSAVENAME, srb2home);
 
@@ -1885,16 +2465,84 @@ static void CL_LoadReceivedSavegame(void)
 		return;
 	}
 
-	save_p = savebuffer;
+	else if (length < 5)
+		I_Error("Can't read savegame sent");
 
-	// Decompress saved game if necessary.
-	decompressedlen = READUINT32(save_p);
-	if(decompressedlen > 0)
+	// Decompress it, then put every section back together,
+	// out of the last savegame we got if it's a delta.
 	{
-		UINT8 *decompressedbuffer = Z_Malloc(decompressedlen, PU_STATIC, NULL);
-		lzf_decompress(save_p, length - sizeof(UINT32), decompressedbuffer, decompressedlen);
+		UINT8 codec, *body, *p, *end;
+		size_t bodylength, total, i;
+		UINT32 basehash, hash;
+		netsave_t save;
+
+		save_p = savebuffer;
+		codec = READUINT8(save_p);
+		bodylength = READUINT32(save_p);
+		body = Z_Malloc(bodylength, PU_STATIC, NULL);
+		SaveGameDecompress(codec, save_p, length - 5, body, bodylength);
 		Z_Free(savebuffer);
-		save_p = savebuffer = decompressedbuffer;
+
+		p = body;
+		end = body + bodylength;
+		basehash = READUINT32(p);
+		hash = READUINT32(p);
+		if (basehash && basehash != savebaseline.hash)
+			I_Error("Savegame sent is a delta against one we don't have");
+
+		// First pass for the size, second one to rebuild.
+		for (i = 0, total = 0; i < NUMNETSAVESECTIONS; i++)
+		{
+			size_t enclength;
+			if (end - p < 9)
+				I_Error("Savegame sent is corrupt");
+			p++;
+			total += READUINT32(p);
+			enclength = READUINT32(p);
+			if ((size_t)(end - p) < enclength)
+				I_Error("Savegame sent is corrupt");
+			p += enclength;
+		}
+
+		save.data = malloc(total);
+		if (!save.data)
+			I_Error("No more free memory for savegame");
+		save.length = total;
+
+		p = body + 8;
+		for (i = 0, total = 0; i < NUMNETSAVESECTIONS; i++)
+		{
+			UINT8 type = READUINT8(p);
+			size_t seclength = READUINT32(p);
+			size_t enclength = READUINT32(p);
+
+			save.sections[i] = total;
+			if (type == SAVESECTION_DELTA && basehash)
+				SaveDeltaDecode(savebaseline.data + savebaseline.sections[i],
+					savebaseline.sections[i+1] - savebaseline.sections[i],
+					p, enclength, save.data + total, seclength);
+			else if (type == SAVESECTION_RAW && enclength == seclength)
+				M_Memcpy(save.data + total, p, seclength);
+			else
+				I_Error("Savegame sent is corrupt");
+			p += enclength;
+			total += seclength;
+		}
+		save.sections[NUMNETSAVESECTIONS] = total;
+		Z_Free(body);
+
+		save.hash = SaveGameHash(save.data, save.length);
+		if (save.hash != hash)
+			I_Error("Savegame sent doesn't match the server's");
+
+		savegamestats.recvbytes = length;
+		savegamestats.recvraw = save.length;
+		savegamestats.recvdelta = (basehash != 0);
+
+		// It's the new baseline, P_LoadNetGame only reads from it.
+		free(savebaseline.data);
+		savebaseline = save;
+		save_p = savebuffer = savebaseline.data;
 	}
 
 	paused = false;
@@ -1921,20 +2569,25 @@ static void CL_LoadReceivedSavegame(void)
 	else
 	{
 		CONS_Alert(CONS_ERROR, M_GetText("Can't load the level!\n"));
-		Z_Free(savebuffer);
+		// not something to build on next time
+		free(savebaseline.data);
+		memset(&savebaseline, 0, sizeof savebaseline);
 		save_p = NULL;
 		if (unlink(tmpsave) == -1)
 			CONS_Alert(CONS_ERROR, M_GetText("Can't delete %s\n"), tmpsave);
 		return;
 	}
 
-	// done
-	Z_Free(savebuffer);
+	// done, the buffer stays around as the baseline
 	save_p = NULL;
 	if (unlink(tmpsave) == -1)
 		CONS_Alert(CONS_ERROR, M_GetText("Can't delete %s\n"), tmpsave);
 	consistancy[gametic%TICQUEUE] = Consistancy();
 	CON_ToggleOff();
+
+	savegamestats.loadtime = I_GetPreciseTime() - loadstart;
+	savegamestats.jointime = I_GetPreciseTime() - savegamestats.joinstart;
+	CONS_Debug(DBG_NETPLAY, "Joined in %.2f ms\n", savegamestats.jointime * 1000.0 / I_GetPrecisePrecision());
 }
 #endif
 
@@ -3928,6 +4581,7 @@ void D_ClientServerInit(void)
 #ifdef _DEBUG
 	COM_AddCommand("numnodes", Command_Numnodes);
 #endif
+	COM_AddCommand("savegamestats", Command_SavegameStats_f);
 #endif
 
 	RegisterNetXCmd(XD_KICK, Got_KickCmd);
@@ -3937,6 +4591,7 @@ void D_ClientServerInit(void)
 #ifdef DUMPCONSISTENCY
 	CV_RegisterVar(&cv_dumpconsistency);
 #endif
+	CV_RegisterVar(&cv_savecompression);
 	D_LoadBan(false);
 #endif
 
@@ -3959,6 +4614,8 @@ static void ResetNode(INT32 node)
 	nodetoplayer4[node] = -1;
 	nettics[node] = gametic;
 	supposedtics[node] = gametic;
+	ticcmdbasefloor[node] = gametic;
+	ticcmdspawnpending[node] = false;
 	nodewaiting[node] = 0;
 	playerpernode[node] = 0;
 	sendingsavegame[node] = false;
@@ -4092,6 +4749,8 @@ static inline void SV_AddNode(INT32 node)
 {
 	nettics[node] = gametic;
 	supposedtics[node] = gametic;
+	ticcmdbasefloor[node] = gametic;
+	ticcmdspawnpending[node] = false;
 	// little hack because the server connects to itself and puts
 	// nodeingame when connected not here
 	if (node)
@@ -4534,7 +5193,9 @@ static void HandleConnect(SINT8 node)
 		{
 			if (node && newnode)
 			{
-				SV_SendSaveGame(node); // send a complete game state
+				SV_SendSaveGame(node, // send a complete game state
+					LONG(netbuffer->u.clientcfg.savebase), LONG(netbuffer->u.clientcfg.savebaselength),
+					netbuffer->u.clientcfg.savecodecs);
 				DEBFILE("send savegame\n");
 			}
 			SV_AddWaitingPlayers();
@@ -4963,6 +5624,14 @@ FILESTAMP
 			// Update the nettics
 			nettics[node] = realend;
 
+			// Having run the spawn, the node rewrote at most the tics it had by now
+			if (ticcmdspawnpending[node] && realstart > ticcmdspawntic[node])
+			{
+				ticcmdspawnpending[node] = false;
+				if (ticcmdbasefloor[node] < realend)
+					ticcmdbasefloor[node] = realend;
+			}
+
 			// This should probably still timeout though, as the node should always have a player 1 number
 			if (netconsole == -1)
 				break;
@@ -5243,7 +5912,9 @@ FILESTAMP
 			realstart = ExpandTics(netbuffer->u.serverpak.starttic, maketic);
 			realend = realstart + netbuffer->u.serverpak.numtics;
 
-			if (!txtpak)
+			if (netbuffer->u.serverpak.cmdformat == SERVERTICS_DELTA)
+				; // found by CL_DecodeTiccmds below, if the packet is used
+			else if (!txtpak)
 				txtpak = (UINT8 *)&netbuffer->u.serverpak.cmds[netbuffer->u.serverpak.numslots
 					* netbuffer->u.serverpak.numtics];
 
@@ -5256,14 +5927,29 @@ FILESTAMP
 				tic_t i, j;
 				pak = (UINT8 *)&netbuffer->u.serverpak.cmds;
 
+				if (netbuffer->u.serverpak.cmdformat == SERVERTICS_DELTA)
+				{
+					txtpak = CL_DecodeTiccmds(pak, (UINT8 *)netbuffer + doomcom->datalength, realstart,
+						netbuffer->u.serverpak.numtics, netbuffer->u.serverpak.numslots);
+					if (!txtpak)
+					{
+						DEBFILE("malformed PT_SERVERTICS ticcmds\n");
+						break;
+					}
+				}
+
 				for (i = realstart; i < realend; i++)
 				{
 					// clear first
 					D_Clearticcmd(i);
 
 					// copy the tics
-					pak = G_ScpyTiccmd(netcmds[i%TICQUEUE], pak,
-						netbuffer->u.serverpak.numslots*sizeof (ticcmd_t));
+					if (netbuffer->u.serverpak.cmdformat == SERVERTICS_DELTA)
+						M_Memcpy(netcmds[i%TICQUEUE], ticcmddeltacmds[i - realstart],
+							netbuffer->u.serverpak.numslots*sizeof (ticcmd_t));
+					else
+						pak = G_ScpyTiccmd(netcmds[i%TICQUEUE], pak,
+							netbuffer->u.serverpak.numslots*sizeof (ticcmd_t));
 
 					// copy the textcmds
 					numtxtpak = *txtpak++;
@@ -5458,14 +6144,14 @@ static INT16 Consistancy(void)
 		ret += P_GetRandSeed();
 
 #ifdef MOBJCONSISTANCY
-	if (!thinkercap.next)
+	if (!thlist[THINK_MOBJ].next)
 	{
 		DEBFILE(va("Consistancy = %u\n", ret));
 		return ret;
 	}
 	if (gamestate == GS_LEVEL)
 	{
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -5708,7 +6394,7 @@ static void SV_SendTics(void)
 	tic_t realfirsttic, lasttictosend, i;
 	UINT32 n;
 	INT32 j;
-	size_t packsize;
+	size_t packsize, rawsize, deltasize;
 	UINT8 *bufpos;
 	UINT8 *ntextcmd;
 
@@ -5782,9 +6468,24 @@ static void SV_SendTics(void)
 			netbuffer->u.serverpak.numslots = (UINT8)SHORT(doomcom->numslots);
 			bufpos = (UINT8 *)&netbuffer->u.serverpak.cmds;
 
-			for (i = realfirsttic; i < lasttictosend; i++)
+			// Delta encode the ticcmds if we can and it's worth it,
+			// otherwise send them as they are
+			rawsize = (lasttictosend - realfirsttic) * doomcom->numslots * sizeof (ticcmd_t);
+			deltasize = SV_EncodeTiccmds(n, realfirsttic, lasttictosend);
+			if (deltasize && deltasize < rawsize)
 			{
-				bufpos = G_DcpyTiccmd(bufpos, netcmds[i%TICQUEUE], doomcom->numslots * sizeof (ticcmd_t));
+				netbuffer->u.serverpak.cmdformat = SERVERTICS_DELTA;
+				M_Memcpy(bufpos, ticcmddeltabuf, deltasize);
+				bufpos += deltasize;
+				ticcmdbytessaved += rawsize - deltasize;
+			}
+			else
+			{
+				netbuffer->u.serverpak.cmdformat = SERVERTICS_RAW;
+				for (i = realfirsttic; i < lasttictosend; i++)
+				{
+					bufpos = G_DcpyTiccmd(bufpos, netcmds[i%TICQUEUE], doomcom->numslots * sizeof (ticcmd_t));
+				}
 			}
 
 			// add textcmds
@@ -5870,10 +6571,27 @@ void SV_SpawnPlayer(INT32 playernum, INT32 x, INT32 y, angle_t angle)
 			break;
 		}
 		netcmds[tic%TICQUEUE][playernum].angleturn = (INT16)((angle>>16) | TICCMD_RECEIVED);
-
 		if (!tic) // failsafe for gametic == 0 -- Monster Iestyn 16/01/18
 			break;
 	}
+
+	// Clients may hold either version of the tics that were just changed,
+	// so they can't be used as a base for delta encoded ticcmds anymore.
+	// Each client also changes its own copies when it runs this tic, up to
+	// whatever it has received by then, so it gets raw ticcmds until it
+	// says how far that was.
+	if (server)
+	{
+		INT32 node;
+
+		SV_InvalidateTiccmdBases(maketic + 1);
+
+		for (node = 0; node < MAXNETNODES; node++)
+		{
+			ticcmdspawnpending[node] = true;
+			ticcmdspawntic[node] = gametic;
+		}
+	}
 }
 
 // create missed tic
@@ -5975,12 +6693,25 @@ boolean TryRunTics(tic_t realtics)
 		// run the count * tics
 		while (neededtic > gametic)
 		{
+			precise_t ticstart = 0;
+
 			DEBFILE(va("============ Running tic %d (local %d)\n", gametic, localgametic));
 
+			if (demo.benchmark)
+				ticstart = I_GetPreciseTime();
+
 			G_Ticker((gametic % NEWTICRATERATIO) == 0);
 			ExtraDataTicker();
 			gametic++;
-			consistancy[gametic%TICQUEUE] = Consistancy();
+
+			if (demo.benchmark)
+			{
+				precise_t tictime = I_GetPreciseTime() - ticstart;
+				consistancy[gametic%TICQUEUE] = Consistancy();
+				G_BenchmarkTic(tictime, consistancy[gametic%TICQUEUE]);
+			}
+			else
+				consistancy[gametic%TICQUEUE] = Consistancy();
 
 			// Leave a certain amount of tics present in the net buffer as long as we've ran at least one tic this frame.
 			if (client && gamestate == GS_LEVEL && leveltime > 3 && neededtic <= gametic + cv_netticbuffer.value)
@@ -25,7 +25,7 @@ The 'packet version' is used to distinguish packet formats.
 This version is independent of VERSION and SUBVERSION. Different
 applications may follow different packet versions.
 */
-#define PACKETVERSION 0
+#define PACKETVERSION 2
 
 // Network play related stuff.
 // There is a data struct that stores network
@@ -163,9 +163,17 @@ typedef struct
 	UINT8 starttic;
 	UINT8 numtics;
 	UINT8 numslots; // "Slots filled": Highest player number in use plus one.
+	UINT8 cmdformat; // SERVERTICS_RAW or SERVERTICS_DELTA
 	ticcmd_t cmds[45]; // Normally [BACKUPTIC][MAXPLAYERS] but too large
 } ATTRPACK servertics_pak;
 
+// How the ticcmds of a PT_SERVERTICS packet are stored
+enum
+{
+	SERVERTICS_RAW, // numtics * numslots full ticcmd_t
+	SERVERTICS_DELTA, // each ticcmd as changes from the same slot in the tic before
+};
+
 // Sent to client when all consistency data
 // for players has been restored
 typedef struct
@@ -362,6 +370,9 @@ typedef struct
 	UINT8 subversion; // Contains build version
 	UINT8 localplayers;	// number of splitscreen players
 	UINT8 mode;
+	UINT8 savecodecs; // savegame compression the client understands, bit per codec
+	UINT32 savebase; // hash of the last savegame the client received, 0 if none
+	UINT32 savebaselength;
 } ATTRPACK clientconfig_pak;
 
 #define SV_SPEEDMASK 0x03		// used to send kartspeed
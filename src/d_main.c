@@ -75,6 +75,7 @@ int	snprintf(char *str, size_t n, const char *fmt, ...);
 #include "m_cond.h" // condition initialization
 #include "fastcmp.h"
 #include "r_fps.h" // Frame interpolation/uncapped
+#include "m_perfstats.h"
 #include "keys.h"
 #include "filesrch.h" // refreshdirmenu
 
@@ -274,6 +275,7 @@ static void D_Display(void)
 	boolean forcerefresh = false;
 	static boolean wipe = false;
 	INT32 wipedefindex = 0;
+	precise_t pstime;
 	UINT8 i;
 
 	if (!dedicated)
@@ -432,7 +434,13 @@ static void D_Display(void)
 		if (cv_renderview.value && !automapactive)
 		{
 			R_ApplyLevelInterpolators(R_UsingFrameInterpolation() ? rendertimefrac : FRACUNIT);
+			pstime = M_PerfStart();
 
+#ifdef THREADEDRENDER
+			if (R_UseViewThreads())
+				R_RenderPlayerViews();
+			else
+#endif
 			for (i = 0; i <= splitscreen; i++)
 			{
 				if (players[displayplayers[i]].mo || players[displayplayers[i]].playerstate == PST_DEAD)
@@ -506,6 +514,7 @@ static void D_Display(void)
 				}
 			}
 
+			M_PerfStop(PS_RENDER, pstime);
 			R_RestoreLevelInterpolators();
 		}
 
@@ -599,6 +608,11 @@ static void D_Display(void)
 
 			s[sizeof s - 1] = '\0';
 
+			if (server && savedbps)
+			{
+				snprintf(s, sizeof s - 1, "saved %d b/s", savedbps);
+				V_DrawRightAlignedString(BASEVIDWIDTH, BASEVIDHEIGHT-ST_HEIGHT-50, V_YELLOWMAP, s);
+			}
 			snprintf(s, sizeof s - 1, "get %d b/s", getbps);
 			V_DrawRightAlignedString(BASEVIDWIDTH, BASEVIDHEIGHT-ST_HEIGHT-40, V_YELLOWMAP, s);
 			snprintf(s, sizeof s - 1, "send %d b/s", sendbps);
@@ -612,7 +626,12 @@ static void D_Display(void)
 		if (cv_shittyscreen.value)
 			V_DrawVhsEffect(cv_shittyscreen.value == 2);
 
+		if (cv_perfstats.value)
+			M_DrawPerfStats();
+
+		pstime = M_PerfStart();
 		I_FinishUpdate(); // page flip or blit buffer
+		M_PerfStop(PS_FINISHUPDATE, pstime);
 	}
 }
 
@@ -672,6 +691,7 @@ void D_SRB2Loop(void)
 		precise_t capbudget;
 		precise_t enterprecise = I_GetPreciseTime();
 		precise_t finishprecise = enterprecise;
+		precise_t pstime;
 
 		{
 			// Casting the return value of a function is bad practice (apparently)
@@ -773,7 +793,9 @@ void D_SRB2Loop(void)
 			M_DoScreenShot();
 
 		// consoleplayer -> displayplayers (hear sounds from viewpoint)
+		pstime = M_PerfStart();
 		S_UpdateSounds(); // move positional sounds
+		M_PerfStop(PS_SOUND, pstime);
 
 		// check for media change, loop music..
 		I_UpdateCD();
@@ -794,6 +816,8 @@ void D_SRB2Loop(void)
 #endif
 
 		// Fully completed frame made.
+		if (interp || doDisplay)
+			M_PerfFinishFrame();
 		finishprecise = I_GetPreciseTime();
 		if (!singletics)
 		{
@@ -1118,6 +1142,9 @@ void D_SRB2Main(void)
 #if !defined (_WINDOWS) //already check in win_main.c
 	dedicated = M_CheckParm("-dedicated") != 0;
 #endif
+	// -benchdemo runs headless, the same way as a dedicated server
+	if (M_CheckParm("-benchdemo"))
+		dedicated = true;
 
 	strcpy(title, "SRB2Kart");
 	strcpy(srb2, "SRB2Kart");
@@ -1243,7 +1270,7 @@ void D_SRB2Main(void)
 
 	// get map from parms
 
-	if (M_CheckParm("-server") || dedicated)
+	if (M_CheckParm("-server") || (dedicated && !M_CheckParm("-benchdemo")))
 		netgame = server = true;
 
 	CONS_Printf("Z_Init(): Init zone memory allocation daemon. \n");
@@ -1555,6 +1582,8 @@ void D_SRB2Main(void)
 	p = M_CheckParm("-playdemo");
 	if (!p)
 		p = M_CheckParm("-timedemo");
+	if (!p)
+		p = M_CheckParm("-benchdemo");
 	if (p && M_IsNextParm())
 	{
 		char tmp[MAX_WADPATH];
@@ -1579,6 +1608,8 @@ void D_SRB2Main(void)
 			demo.quitafterplaying = true; // quit after one demo
 			G_DeferedPlayDemo(tmp);
 		}
+		else if (M_CheckParm("-benchdemo"))
+			G_BenchDemo(tmp);
 		else
 			G_TimeDemo(tmp);
 
@@ -97,24 +97,26 @@ bannednode_t *bannednode = NULL;
 static tic_t statstarttic;
 INT32 getbytes = 0;
 INT64 sendbytes = 0;
+INT64 ticcmdbytessaved = 0;
 static INT32 retransmit = 0, duppacket = 0;
 static INT32 sendackpacket = 0, getackpacket = 0;
 INT32 ticruned = 0, ticmiss = 0;
 
 // globals
-INT32 getbps, sendbps;
+INT32 getbps, sendbps, savedbps;
 float lostpercent, duppercent, gamelostpercent;
 INT32 packetheaderlength;
 
 boolean Net_GetNetStat(void)
 {
 	const tic_t t = I_GetTime();
-	static INT64 oldsendbyte = 0;
+	static INT64 oldsendbyte = 0, oldsavedbyte = 0;
 	if (statstarttic+STATLENGTH <= t)
 	{
 		const tic_t df = t-statstarttic;
 		const INT64 newsendbyte = sendbytes - oldsendbyte;
 		sendbps = (INT32)(newsendbyte*TICRATE)/df;
+		savedbps = (INT32)((ticcmdbytessaved - oldsavedbyte)*TICRATE)/df;
 		getbps = (getbytes*TICRATE)/df;
 		if (sendackpacket)
 			lostpercent = 100.0f*(float)retransmit/(float)sendackpacket;
@@ -131,6 +133,7 @@ boolean Net_GetNetStat(void)
 
 		ticmiss = ticruned = 0;
 		oldsendbyte = sendbytes;
+		oldsavedbyte = ticcmdbytessaved;
 		getbytes = 0;
 		sendackpacket = getackpacket = duppacket = retransmit = 0;
 		statstarttic = t;
@@ -852,6 +855,14 @@ static void DebugPrintpacket(const char *header)
 			UINT8 *cmd = (UINT8 *)(&serverpak->cmds[serverpak->numslots * serverpak->numtics]);
 			size_t ntxtcmd = &((UINT8 *)netbuffer)[doomcom->datalength] - cmd;
 
+			if (serverpak->cmdformat != SERVERTICS_RAW)
+			{
+				// The textcmds can't be found without decoding the ticcmds
+				fprintf(debugfile, "    firsttic %u ply %d tics %d delta\n",
+					(UINT32)serverpak->starttic, serverpak->numslots, serverpak->numtics);
+				break;
+			}
+
 			fprintf(debugfile, "    firsttic %u ply %d tics %d ntxtcmd %s\n    ",
 				(UINT32)serverpak->starttic, serverpak->numslots, serverpak->numtics, sizeu1(ntxtcmd));
 			/// \todo Display more readable information about net commands
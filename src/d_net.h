@@ -35,6 +35,8 @@ extern INT32 packetheaderlength;
 boolean Net_GetNetStat(void);
 extern INT32 getbytes;
 extern INT64 sendbytes; // Realtime updated
+extern INT64 ticcmdbytessaved; // Realtime updated, by delta encoding PT_SERVERTICS
+extern INT32 savedbps;
 
 extern SINT8 nodetoplayer[MAXNETNODES];
 extern SINT8 nodetoplayer2[MAXNETNODES]; // Say the numplayer for this node if any (splitscreen)
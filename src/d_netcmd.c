@@ -595,6 +595,12 @@ void D_RegisterServerCommands(void)
 
 	COM_AddCommand("addfile", Command_Addfile);
 	COM_AddCommand("listwad", Command_ListWADS_f);
+	COM_AddCommand("lumpstats", Command_Lumpstats_f);
+	COM_AddCommand("loadtimes", Command_Loadtimes_f);
+	COM_AddCommand("md5cache", Command_Md5cache_f);
+#ifdef HAVE_BLUA
+	COM_AddCommand("luahooks", Command_Luahooks_f);
+#endif
 
 #ifdef DELFILE
 	COM_AddCommand("delfile", Command_Delfile);
@@ -762,6 +768,10 @@ void D_RegisterClientCommands(void)
 
 	COM_AddCommand("numthinkers", Command_Numthinkers_f);
 	COM_AddCommand("countmobjs", Command_CountMobjs_f);
+	COM_AddCommand("mobjpool", Command_Mobjpool_f);
+	COM_AddCommand("intercepts", Command_Intercepts_f);
+	COM_AddCommand("checkthingbench", Command_CheckThingBench_f);
+	COM_AddCommand("thinkerprofile", Command_ThinkerProfile_f);
 
 	COM_AddCommand("changeteam", Command_Teamchange_f);
 	COM_AddCommand("changeteam2", Command_Teamchange2_f);
@@ -5467,7 +5477,7 @@ static void Command_Archivetest_f(void)
 
 	// assign mobjnum
 	i = 1;
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
 			((mobj_t *)th)->mobjnum = i++;
 
@@ -49,6 +49,10 @@ typedef struct thinker_s
 	// killough 11/98: count of how many other objects reference
 	// this one using pointers. Used for garbage collection.
 	INT32 references;
+
+	// Which mobj pool the memory goes back to once it is freed, or 0
+	// to hand it back to the zone. See P_FreeThinkerMemory.
+	UINT8 pool;
 } thinker_t;
 
 #endif
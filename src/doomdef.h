@@ -652,6 +652,23 @@ extern const char *compdate, *comptime, *comprevision, *compbranch;
 ///      	SRB2CB itself ported this from PrBoom+
 //#define NEWCLIP
 
+///	Render splitscreen views on worker threads in the software renderer.
+///	\note	The state a view is rendered with lives in thread-local storage,
+///	     	which the assembly drawers can't address, so they go without.
+#if defined (HAVE_THREADS) && !defined (USEASM)
+#define THREADEDRENDER
+#endif
+
+#ifdef THREADEDRENDER
+#ifdef _MSC_VER
+#define THREADLOCAL __declspec(thread)
+#else
+#define THREADLOCAL __thread
+#endif
+#else
+#define THREADLOCAL
+#endif
+
 /// Hardware renderer: OpenGL
 #define GL_SHADERS
 
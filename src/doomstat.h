@@ -114,9 +114,15 @@ extern boolean lastdraw;
 extern postimg_t postimgtype[MAXSPLITSCREENPLAYERS];
 extern INT32 postimgparam[MAXSPLITSCREENPLAYERS];
 
-extern INT32 viewwindowx, viewwindowy;
+extern THREADLOCAL INT32 viewwindowx, viewwindowy;
 extern INT32 viewwidth, scaledviewwidth;
 
+#ifdef THREADEDRENDER
+// True while views are being rendered on worker threads. The zone and the
+// caches the renderer fills as it goes only lock themselves then.
+extern boolean viewthreadsactive;
+#endif
+
 extern boolean gamedataloaded;
 
 // Player taking events, and displaying.
@@ -3217,7 +3217,7 @@ void G_ChangePlayerReferences(mobj_t *oldmo, mobj_t *newmo)
 	I_Assert((oldmo != NULL) && (newmo != NULL));
 
 	// scan all thinkers
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -5104,7 +5104,8 @@ INT32 G_FindMapByNameOrCode(const char *mapname, char **realmapnamep)
 // DEMO RECORDING
 //
 
-#define DEMOVERSION 0x0002
+// 0x0003: thinkers run per list (polyobjects, sector specials, pushers, then mobjs)
+#define DEMOVERSION 0x0003
 #define DEMOHEADER  "\xF0" "KartReplay" "\x0F"
 
 #define DF_GHOST        0x01 // This demo contains ghost data too!
@@ -5931,7 +5932,7 @@ void G_ConsGhostTic(INT32 playernum)
 				demo_p += sizeof(angle_t); // angle, unnecessary for cons.
 
 				mobj = NULL;
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 				{
 					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 						continue;
@@ -7300,6 +7301,13 @@ void G_LoadDemoInfo(menudemo_t *pdemo)
 		sprintf(pdemo->title, "Legacy Replay");
 		break;
 #endif
+	case 0x0002:
+		// Thinker order changed in 0x0003; these would desync.
+		CONS_Alert(CONS_ERROR, M_GetText("%s was recorded with an older thinker order and cannot be played.\n"), pdemo->filepath);
+		pdemo->type = MD_INVALID;
+		sprintf(pdemo->title, "OUTDATED REPLAY");
+		Z_Free(infobuffer);
+		return;
 	// too old, cannot support.
 	default:
 		CONS_Alert(CONS_ERROR, M_GetText("%s is an incompatible replay format and cannot be played.\n"), pdemo->filepath);
@@ -7549,6 +7557,16 @@ void G_DoPlayDemo(char *defdemoname)
 	case 0x0001:
 		break;
 #endif
+	case 0x0002:
+		snprintf(msg, 1024, M_GetText("%s was recorded with an older thinker order and cannot be played.\n"), pdemoname);
+		CONS_Alert(CONS_ERROR, "%s", msg);
+		M_StartMessage(msg, NULL, MM_NOTHING);
+		Z_Free(pdemoname);
+		Z_Free(demobuffer);
+		demobuffer = NULL;
+		demo.playback = false;
+		demo.title = false;
+		return;
 	// too old, cannot support.
 	default:
 		snprintf(msg, 1024, M_GetText("%s is an incompatible replay format and cannot be played.\n"), pdemoname);
@@ -8411,6 +8429,85 @@ void G_TimeDemo(const char *name)
 	G_DeferedPlayDemo(name);
 }
 
+//
+// G_BenchDemo
+// Like G_TimeDemo, but nothing at all is drawn and the time and consistency
+// of every tic are kept, so the playsim can be compared between builds.
+//
+static precise_t *benchtics;
+static size_t numbenchtics, maxbenchtics;
+static UINT32 benchhash;
+static INT16 benchconsistancy;
+static precise_t benchstart;
+
+void G_BenchDemo(const char *name)
+{
+	nodrawers = noblit = true;
+	demo.timing = demo.benchmark = true;
+	singletics = true;
+	framecount = 0;
+	numbenchtics = 0;
+	benchhash = 2166136261u;
+	benchstart = I_GetPreciseTime();
+	demostarttime = I_GetTime();
+	G_DeferedPlayDemo(name);
+}
+
+// Called by TryRunTics after each tic while benchmarking
+void G_BenchmarkTic(precise_t time, INT16 consistancy)
+{
+	// FNV-1a over every tic's consistancy, so any desync shows up in the result
+	benchhash = (benchhash ^ (UINT16)consistancy) * 16777619u;
+	benchconsistancy = consistancy;
+
+	if (gamestate != GS_LEVEL)
+		return;
+
+	if (numbenchtics == maxbenchtics)
+	{
+		maxbenchtics = maxbenchtics ? maxbenchtics*2 : 8*1024;
+		benchtics = Z_Realloc(benchtics, maxbenchtics * sizeof *benchtics, PU_STATIC, NULL);
+	}
+	benchtics[numbenchtics++] = time;
+}
+
+static int G_CompareBenchTics(const void *a, const void *b)
+{
+	const precise_t ta = *(const precise_t *)a, tb = *(const precise_t *)b;
+	return (ta > tb) - (ta < tb);
+}
+
+static void G_BenchmarkReport(void)
+{
+	UINT64 precision = I_GetPrecisePrecision();
+	precise_t wall = I_GetPreciseTime() - benchstart, total = 0;
+	size_t i;
+
+	if (!numbenchtics)
+	{
+		CONS_Printf(M_GetText("benchmark: no level tics were run\n"));
+		return;
+	}
+
+	for (i = 0; i < numbenchtics; i++)
+		total += benchtics[i];
+	qsort(benchtics, numbenchtics, sizeof *benchtics, G_CompareBenchTics);
+
+	// One line, so that it is easy to pick out of a log
+	CONS_Printf("benchmark: tics %s, wall %.3f s, %.1f tics/sec, p50 %.1f us, p99 %.1f us, max %.1f us, consistancy %04x, hash %08x\n",
+		sizeu1(numbenchtics),
+		(double)wall / precision,
+		total ? (double)numbenchtics * precision / total : 0.0,
+		(double)benchtics[numbenchtics / 2] * 1000000.0 / precision,
+		(double)benchtics[(numbenchtics * 99) / 100] * 1000000.0 / precision,
+		(double)benchtics[numbenchtics - 1] * 1000000.0 / precision,
+		(UINT16)benchconsistancy, benchhash);
+
+	Z_Free(benchtics);
+	benchtics = NULL;
+	numbenchtics = maxbenchtics = 0;
+}
+
 void G_DoPlayMetal(void)
 {
 	lumpnum_t l;
@@ -8427,7 +8524,7 @@ void G_DoPlayMetal(void)
 		metalbuffer = metal_p = W_CacheLumpNum(l, PU_STATIC);
 
 	// find metal sonic
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -8596,6 +8693,11 @@ boolean G_CheckDemoStatus(void)
 			return true;
 		G_StopDemo();
 		demo.timing = false;
+		if (demo.benchmark)
+		{
+			G_BenchmarkReport();
+			I_Quit();
+		}
 		f1 = (double)demotime;
 		f2 = (double)framecount*TICRATE;
 		CONS_Printf(M_GetText("timed %u gametics in %d realtics\n%f seconds, %f avg fps\n"), leveltime,demotime,f1/TICRATE,f2/f1);
@@ -45,6 +45,7 @@ extern consvar_t cv_recordmultiplayerdemos, cv_netdemosyncquality;
 struct demovars_s {
 	char titlename[65];
 	boolean recording, playback, timing;
+	boolean benchmark; // -benchdemo: headless timing of every tic
 	UINT16 version; // Current file format of the demo being played
 	boolean title; // Title Screen demo can be cancelled by any key
 	boolean rewinding; // Rewind in progress
@@ -298,6 +299,8 @@ extern demoghost *ghosts;
 
 void G_DoPlayDemo(char *defdemoname);
 void G_TimeDemo(const char *name);
+void G_BenchDemo(const char *name);
+void G_BenchmarkTic(precise_t time, INT16 consistancy);
 void G_AddGhost(char *defdemoname);
 void G_UpdateStaffGhostName(lumpnum_t l);
 void G_DoPlayMetal(void);
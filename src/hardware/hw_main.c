@@ -3017,37 +3017,28 @@ static void HWR_DrawSpriteShadow(gr_vissprite_t *spr, GLPatch_t *gpatch, float t
 // This is expecting a pointer to an array containing 4 wallVerts for a sprite
 static void HWR_RotateSpritePolyToAim(gr_vissprite_t *spr, FOutVector *wallVerts)
 {
-	if (cv_grspritebillboarding.value && spr && spr->mobj && !(spr->mobj->frame & FF_PAPERSPRITE) && wallVerts)
+	if (!cv_grspritebillboarding.value || !spr || !wallVerts)
+		return;
+
+	if (spr->precip || (spr->mobj && !(spr->mobj->frame & FF_PAPERSPRITE)))
 	{
 		// uncapped/interpolation
 		interpmobjstate_t interp = {0};
 		float basey, lowy;
 
 		// do interpolation
-		if (R_UsingFrameInterpolation() && !paused)
+		if (spr->precip)
+			interp.z = spr->precipz; // already interpolated
+		else if (R_UsingFrameInterpolation() && !paused)
 		{
-			if (spr->precip)
-			{
-				R_InterpolatePrecipMobjState((precipmobj_t *)spr->mobj, rendertimefrac, &interp);
-			}
-			else
-			{
-				R_InterpolateMobjState(spr->mobj, rendertimefrac, &interp);
-			}
+			R_InterpolateMobjState(spr->mobj, rendertimefrac, &interp);
 		}
 		else
 		{
-			if (spr->precip)
-			{
-				R_InterpolatePrecipMobjState((precipmobj_t *)spr->mobj, FRACUNIT, &interp);
-			}
-			else
-			{
-				R_InterpolateMobjState(spr->mobj, FRACUNIT, &interp);
-			}
+			R_InterpolateMobjState(spr->mobj, FRACUNIT, &interp);
 		}
 
-		if (P_MobjFlip(spr->mobj) == -1)
+		if (!spr->precip && P_MobjFlip(spr->mobj) == -1)
 		{
 			basey = FIXED_TO_FLOAT(interp.z + spr->mobj->height);
 		}
@@ -3587,10 +3578,7 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 	GLPatch_t *gpatch; // sprite patch converted to hardware
 	FSurfaceInfo Surf;
 
-	if (!spr->mobj)
-		return;
-
-	if (!spr->mobj->subsector)
+	if (!spr->precipsector)
 		return;
 
 	// cache sprite graphics
@@ -3628,7 +3616,7 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 
 	// colormap test
 	{
-		sector_t *sector = spr->mobj->subsector->sector;
+		sector_t *sector = spr->precipsector;
 		UINT8 lightlevel = 255;
 		extracolormap_t *colormap = sector->extra_colormap;
 
@@ -3636,9 +3624,9 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 		{
 			INT32 light;
 
-			light = R_GetPlaneLight(sector, spr->mobj->z + spr->mobj->height, false); // Always use the light at the top instead of whatever I was doing before
+			light = R_GetPlaneLight(sector, spr->precipz + 4*FRACUNIT, false); // Always use the light at the top instead of whatever I was doing before
 
-			if (!(spr->mobj->frame & FF_FULLBRIGHT))
+			if (!(spr->precipframe & FF_FULLBRIGHT))
 				lightlevel = *sector->lightlist[light].lightlevel > 255 ? 255 : *sector->lightlist[light].lightlevel;
 
 			if (sector->lightlist[light].extra_colormap)
@@ -3646,7 +3634,7 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 		}
 		else
 		{
-			if (!(spr->mobj->frame & FF_FULLBRIGHT))
+			if (!(spr->precipframe & FF_FULLBRIGHT))
 				lightlevel = sector->lightlevel > 255 ? 255 : sector->lightlevel;
 
 			if (sector->extra_colormap)
@@ -3656,13 +3644,8 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 		HWR_Lighting(&Surf, lightlevel, colormap);
 	}
 
-	if (spr->mobj->flags2 & MF2_SHADOW)
-	{
-		Surf.PolyColor.s.alpha = 0x40;
-		blend = PF_Translucent;
-	}
-	else if (spr->mobj->frame & FF_TRANSMASK)
-		blend = HWR_TranstableToAlpha((spr->mobj->frame & FF_TRANSMASK)>>FF_TRANSSHIFT, &Surf);
+	if (spr->precipframe & FF_TRANSMASK)
+		blend = HWR_TranstableToAlpha((spr->precipframe & FF_TRANSMASK)>>FF_TRANSSHIFT, &Surf);
 	else
 	{
 		// BP: i agree that is little better in environement but it don't
@@ -3683,6 +3666,14 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 
 gr_vissprite_t* gr_vsprorder[MAXVISSPRITES];
 
+// Precipitation has no mobj, only its frame.
+static inline int HWR_IsTranslucentVisSprite(gr_vissprite_t *spr)
+{
+	if (spr->precip)
+		return (spr->precipframe & FF_TRANSMASK) != 0;
+	return (spr->mobj->flags2 & MF2_SHADOW) || (spr->mobj->frame & FF_TRANSMASK);
+}
+
 // For more correct transparency the transparent sprites would need to be
 // sorted and drawn together with transparent surfaces.
 static int CompareVisSprites(const void *p1, const void *p2)
@@ -3695,8 +3686,8 @@ static int CompareVisSprites(const void *p1, const void *p2)
 	// make transparent sprites last
 	// "boolean to int"
 	
-	int transparency1 = (spr1->mobj->flags2 & MF2_SHADOW) || (spr1->mobj->frame & FF_TRANSMASK);
-	int transparency2 = (spr2->mobj->flags2 & MF2_SHADOW) || (spr2->mobj->frame & FF_TRANSMASK);
+	int transparency1 = HWR_IsTranslucentVisSprite(spr1);
+	int transparency2 = HWR_IsTranslucentVisSprite(spr2);
 	idiff = transparency1 - transparency2;
 	if (idiff != 0) return idiff;
 
@@ -4043,7 +4034,6 @@ void HWR_DrawSprites(void)
 void HWR_AddSprites(sector_t *sec)
 {
 	mobj_t *thing;
-	precipmobj_t *precipthing;
 	fixed_t approx_dist, limit_dist;
 
 	INT32 splitflags;
@@ -4145,23 +4135,6 @@ void HWR_AddSprites(sector_t *sec)
 			HWR_ProjectSprite(thing);
 		}
 	}
-
-	// No to infinite precipitation draw distance.
-	if ((limit_dist = (fixed_t)cv_drawdist_precip.value << FRACBITS))
-	{
-		for (precipthing = sec->preciplist; precipthing; precipthing = precipthing->snext)
-		{
-			if (precipthing->precipflags & PCF_INVISIBLE)
-				continue;
-
-			approx_dist = P_AproxDistance(viewx-precipthing->x, viewy-precipthing->y);
-
-			if (approx_dist > limit_dist)
-				continue;
-
-			HWR_ProjectPrecipitationSprite(precipthing);
-		}
-	}
 }
 
 // --------------------------------------------------------------------------
@@ -4419,7 +4392,7 @@ void HWR_ProjectSprite(mobj_t *thing)
 }
 
 // Precipitation projector for hardware mode
-void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
+static void HWR_ProjectPrecipitationSprite(size_t i)
 {
 	gr_vissprite_t *vis;
 	float tr_x, tr_y;
@@ -4433,25 +4406,17 @@ void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
 	unsigned rot = 0;
 	UINT8 flip;
 
-	// uncapped/interpolation
-	interpmobjstate_t interp = {0};
-
-	if (!thing)
-		return;
+	const spritenum_t sprite = precip.state[i]->sprite;
+	const UINT32 frame = precip.frame[i];
+	fixed_t z = precip.z[i];
 
 	// do interpolation
 	if (R_UsingFrameInterpolation() && !paused)
-	{
-		R_InterpolatePrecipMobjState(thing, rendertimefrac, &interp);
-	}
-	else
-	{
-		R_InterpolatePrecipMobjState(thing, FRACUNIT, &interp);
-	}
+		z = R_InterpolateFixed(precip.oldz[i], z);
 
 	// transform the origin point
-	tr_x = FIXED_TO_FLOAT(interp.x) - gr_viewx;
-	tr_y = FIXED_TO_FLOAT(interp.y) - gr_viewy;
+	tr_x = FIXED_TO_FLOAT(precip.x[i]) - gr_viewx;
+	tr_y = FIXED_TO_FLOAT(precip.y[i]) - gr_viewy;
 
 	// rotation around vertical axis
 	tz = (tr_x * gr_viewcos) + (tr_y * gr_viewsin);
@@ -4460,29 +4425,29 @@ void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
 	if (tz < ZCLIP_PLANE)
 		return;
 
-	tr_x = FIXED_TO_FLOAT(interp.x);
-	tr_y = FIXED_TO_FLOAT(interp.y);
+	tr_x = FIXED_TO_FLOAT(precip.x[i]);
+	tr_y = FIXED_TO_FLOAT(precip.y[i]);
 
 	// decide which patch to use for sprite relative to player
-	if ((unsigned)thing->sprite >= numsprites)
+	if ((unsigned)sprite >= numsprites)
 #ifdef RANGECHECK
 		I_Error("HWR_ProjectPrecipitationSprite: invalid sprite number %i ",
-		        thing->sprite);
+		        sprite);
 #else
 		return;
 #endif
 
-	sprdef = &sprites[thing->sprite];
+	sprdef = &sprites[sprite];
 
-	if ((size_t)(thing->frame&FF_FRAMEMASK) >= sprdef->numframes)
+	if ((size_t)(frame&FF_FRAMEMASK) >= sprdef->numframes)
 #ifdef RANGECHECK
 		I_Error("HWR_ProjectPrecipitationSprite: invalid sprite frame %i : %i for %s",
-		        thing->sprite, thing->frame, sprnames[thing->sprite]);
+		        sprite, frame, sprnames[sprite]);
 #else
 		return;
 #endif
 
-	sprframe = &sprdef->spriteframes[ thing->frame & FF_FRAMEMASK];
+	sprframe = &sprdef->spriteframes[ frame & FF_FRAMEMASK];
 
 	// use single rotation for all views
 	lumpoff = sprframe->lumpid[0];
@@ -4506,16 +4471,6 @@ void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
 	x1 = tr_x + x1 * rightcos;
 	x2 = tr_x - x2 * rightcos;
 
-	// okay, we can't return now... this is a hack, but weather isn't networked, so it should be ok
-	if (!(thing->precipflags & PCF_THUNK))
-	{
-		if (thing->precipflags & PCF_RAIN)
-			P_RainThinker(thing);
-		else
-			P_SnowThinker(thing);
-		thing->precipflags |= PCF_THUNK;
-	}
-
 	//
 	// store information in a vissprite
 	//
@@ -4528,21 +4483,55 @@ void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
 	vis->dispoffset = 0; // Monster Iestyn: 23/11/15: HARDWARE SUPPORT AT LAST
 	vis->patchlumpnum = sprframe->lumppat[rot];
 	vis->flip = flip;
-	vis->mobj = (mobj_t *)thing;
+	vis->mobj = NULL;
+	vis->precipsector = precip.subsector[i]->sector;
+	vis->precipframe = frame;
+	vis->precipz = z;
 
 	vis->colormap = colormaps;
 
 #ifdef GLENCORE
-	if (encoremap && !(thing->flags & MF_DONTENCOREMAP))
+	if (encoremap && !(mobjinfo[precip.type].flags & MF_DONTENCOREMAP))
 		vis->colormap += (256*32);
 #endif
 
 	// set top/bottom coords
-	vis->ty = FIXED_TO_FLOAT(thing->z + spritecachedinfo[lumpoff].topoffset);
+	vis->ty = FIXED_TO_FLOAT(z + spritecachedinfo[lumpoff].topoffset);
 
 	vis->precip = true;
 }
 
+// Adds this view's rain and snow, for the sectors the BSP went through.
+// The particles only move in P_RunPrecipitation, so this just reads them.
+static void HWR_AddPrecipitationSprites(void)
+{
+	// No to infinite precipitation draw distance.
+	const fixed_t limit_dist = (fixed_t)cv_drawdist_precip.value << FRACBITS;
+	size_t i, end;
+
+	if (!limit_dist || precip.hidden || viewssnum >= precip.numcameras)
+		return;
+
+	i = viewssnum * precip.percamera;
+	end = i + precip.percamera;
+	if (end > precip.count)
+		return;
+
+	for (; i < end; i++)
+	{
+		if (!precip.subsector[i])
+			continue;
+
+		if (precip.subsector[i]->sector->validcount != validcount)
+			continue;
+
+		if (P_AproxDistance(viewx - precip.x[i], viewy - precip.y[i]) > limit_dist)
+			continue;
+
+		HWR_ProjectPrecipitationSprite(i);
+	}
+}
+
 static boolean drewsky = false;
 
 void HWR_DrawSkyBackground(float fpov)
@@ -4741,6 +4730,10 @@ void HWR_RenderFrame(INT32 viewnumber, player_t *player, boolean skybox)
 	// Recursively "render" the BSP tree.
 	HWR_RenderBSPNode((INT32)numnodes-1);
 
+	// Not in the skybox, where the particles around the camera would be somewhere else
+	if (!skybox)
+		HWR_AddPrecipitationSprites();
+
 	if (cv_grbatching.value)
 	{
 		int dummy = 0;// the vars in RenderBatches are meant for render stats. But we don't have that stuff in this branch
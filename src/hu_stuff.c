@@ -54,6 +54,7 @@
 
 #include "s_sound.h" // song credits
 #include "k_kart.h"
+#include "m_perfstats.h"
 
 // coords are scaled
 #define HU_INPUTX 0
@@ -2400,12 +2401,16 @@ void HU_Drawer(void)
 #endif
 				HU_DrawRankings();
 #ifdef HAVE_BLUA
-		if (renderisnewtic)
 		{
-			LUA_HUD_ClearDrawList(luahuddrawlist_scores);
-			LUAh_ScoresHUD(luahuddrawlist_scores);
+			precise_t pstime = M_PerfStart();
+			if (renderisnewtic)
+			{
+				LUA_HUD_ClearDrawList(luahuddrawlist_scores);
+				LUAh_ScoresHUD(luahuddrawlist_scores);
+			}
+			LUA_HUD_DrawList(luahuddrawlist_scores);
+			M_PerfStop(PS_LUAHUD, pstime);
 		}
-		LUA_HUD_DrawList(luahuddrawlist_scores);
 #endif
 		}
 		if (demo.playback)
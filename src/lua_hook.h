@@ -114,4 +114,7 @@ void LUAh_IntermissionThinker(void); // Hook for Y_Ticker
 void LUAh_VoteThinker(void);	// Hook for Y_VoteTicker
 #define LUAh_PlayerThink(player) LUAh_PlayerHook(player, hook_PlayerThink) // Hook for P_PlayerThink
 
+extern precise_t luahooktime; // total time spent in hooks
+void Command_Luahooks_f(void);
+
 #endif
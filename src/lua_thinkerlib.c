@@ -57,8 +57,8 @@ static int lib_iterateThinkers(lua_State *L)
 	struct iterationState *it = luaL_checkudata(L, 1, META_ITERATIONSTATE);
 	lua_settop(L, 2);
 
-	if (lua_isnil(L, 2))
-		th = &thinkercap;
+	if (lua_isnil(L, 2)) // mobjs all live in their own list
+		th = &thlist[it->filter == (actionf_p1)P_MobjThinker ? THINK_MOBJ : 0];
 	else if (lua_isuserdata(L, 2))
 	{
 		if (lua_islightuserdata(L, 2))
@@ -88,18 +88,30 @@ static int lib_iterateThinkers(lua_State *L)
 	if (!next)
 		return luaL_error(L, "next thinker invalidated during iteration");
 
-	for (; next != &thinkercap; next = next->next)
+	for (;; next = next->next)
+	{
+		// Reached the end of a list; carry on into the next one
+		// unless we only wanted mobjs.
+		if (next >= thlist && next < &thlist[NUM_THINKERLISTS])
+		{
+			size_t list = next - thlist;
+			if (list == NUM_THINKERLISTS-1 || it->filter == (actionf_p1)P_MobjThinker)
+				return 0;
+			next = &thlist[list+1];
+			continue;
+		}
+
 		if (!it->filter || next->function.acp1 == it->filter)
 		{
 			push_thinker(next);
-			if (next->next != &thinkercap)
+			if (next->next != &thlist[NUM_THINKERLISTS-1])
 			{
 				push_thinker(next->next);
 				it->next = luaL_ref(L, LUA_REGISTRYINDEX);
 			}
 			return 1;
 		}
-	return 0;
+	}
 }
 
 static int lib_startIterate(lua_State *L)
@@ -0,0 +1,255 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2020 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_perfstats.c
+/// \brief Frame time breakdown, shown with the perfstats variable
+
+#include "m_perfstats.h"
+#include "d_main.h" // srb2home
+#include "r_state.h" // viewssnum
+#include "i_video.h" // rendermode
+#include "v_video.h"
+#include "z_zone.h"
+#include "console.h"
+
+#ifdef THREADEDRENDER
+#include "i_threads.h"
+
+static I_mutex perfstats_mutex;
+#  define Lock_perfstats()   do { if (viewthreadsactive) I_lock_mutex(&perfstats_mutex); } while (0)
+#  define Unlock_perfstats() do { if (viewthreadsactive) I_unlock_mutex(perfstats_mutex); } while (0)
+#else
+#  define Lock_perfstats()
+#  define Unlock_perfstats()
+#endif
+
+static void PerfStats_OnChange(void);
+
+consvar_t cv_perfstats = {"perfstats", "Off", 0, CV_OnOff, PerfStats_OnChange, 0, NULL, NULL, 0, 0, NULL};
+
+// The last PERFSTATSFRAMES frames are kept, for the overlay's averages and
+// for perfstatsdump.
+#define PERFSTATSFRAMES 2048
+
+static perfframe_t perfframe; // the one being measured
+static perfframe_t *perfhistory;
+static UINT32 perfframes; // how many were ever finished, since perfstats was turned on
+static precise_t perflastframe;
+
+static void PerfStats_OnChange(void)
+{
+	if (!cv_perfstats.value)
+		return;
+
+	if (!perfhistory)
+		perfhistory = Z_Malloc(PERFSTATSFRAMES * sizeof (*perfhistory), PU_STATIC, NULL);
+
+	memset(&perfframe, 0, sizeof perfframe);
+	perfframes = 0;
+	perflastframe = I_GetPreciseTime();
+}
+
+precise_t M_PerfStart(void)
+{
+	return cv_perfstats.value ? I_GetPreciseTime() : 0;
+}
+
+void M_PerfStop(perftimer_t timer, precise_t start)
+{
+	if (!cv_perfstats.value || !start)
+		return;
+
+	perfframe.time[timer] += I_GetPreciseTime() - start;
+}
+
+void M_PerfStopView(perfviewtimer_t timer, precise_t *start)
+{
+	precise_t now;
+
+	if (!cv_perfstats.value || !*start)
+		return;
+
+	now = I_GetPreciseTime();
+
+	Lock_perfstats();
+	perfframe.viewtime[viewssnum][timer] += now - *start;
+	Unlock_perfstats();
+
+	*start = now;
+}
+
+void M_PerfCountView(UINT32 drawsegs, UINT32 visplanes, UINT32 vissprites, UINT32 spans)
+{
+	UINT32 *count = perfframe.count[viewssnum];
+
+	if (!cv_perfstats.value)
+		return;
+
+	Lock_perfstats();
+	count[PS_DRAWSEGS] += drawsegs;
+	count[PS_VISPLANES] += visplanes;
+	count[PS_VISSPRITES] += vissprites;
+	count[PS_SPANS] += spans;
+	Unlock_perfstats();
+}
+
+//
+// M_PerfFinishFrame
+// Files away the frame that was just displayed, and starts the next one.
+//
+void M_PerfFinishFrame(void)
+{
+	precise_t now;
+	INT32 i;
+
+	if (!cv_perfstats.value || !perfhistory)
+		return;
+
+	now = I_GetPreciseTime();
+	perfframe.time[PS_FRAME] = now - perflastframe;
+	perflastframe = now;
+
+	// The sort happens inside R_DrawMasked.
+	for (i = 0; i < MAXSPLITSCREENPLAYERS; i++)
+	{
+		precise_t *viewtime = perfframe.viewtime[i];
+		viewtime[PS_MASKED] -= min(viewtime[PS_SORT], viewtime[PS_MASKED]);
+	}
+
+	perfhistory[perfframes % PERFSTATSFRAMES] = perfframe;
+	perfframes++;
+
+	memset(&perfframe, 0, sizeof perfframe);
+}
+
+static UINT32 M_PerfMicros(precise_t t)
+{
+	return (UINT32)(t * 1000000 / I_GetPrecisePrecision());
+}
+
+//
+// M_DrawPerfStats
+// Shows where the time went, averaged over the last second of frames.
+//
+void M_DrawPerfStats(void)
+{
+	const INT32 flags = V_SNAPTOTOP|V_SNAPTOLEFT|V_MONOSPACE|V_ALLOWLOWERCASE;
+	static const char *timernames[NUMPERFTIMERS] = {"frame", "render", "hud", "lua hud", "finish", "sound"};
+	precise_t time[NUMPERFTIMERS] = {0};
+	precise_t viewtime[MAXSPLITSCREENPLAYERS][NUMPERFVIEWTIMERS] = {{0}};
+	UINT64 count[MAXSPLITSCREENPLAYERS][NUMPERFCOUNTERS] = {{0}};
+	UINT32 n, i, j, k;
+	INT32 y = 4;
+	char s[64];
+
+	if (!perfframes)
+		return;
+
+	n = min(perfframes, (UINT32)TICRATE);
+	for (i = 0; i < n; i++)
+	{
+		const perfframe_t *f = &perfhistory[(perfframes - 1 - i) % PERFSTATSFRAMES];
+
+		for (j = 0; j < NUMPERFTIMERS; j++)
+			time[j] += f->time[j];
+
+		for (j = 0; j < MAXSPLITSCREENPLAYERS; j++)
+		{
+			for (k = 0; k < NUMPERFVIEWTIMERS; k++)
+				viewtime[j][k] += f->viewtime[j][k];
+			for (k = 0; k < NUMPERFCOUNTERS; k++)
+				count[j][k] += f->count[j][k];
+		}
+	}
+
+	for (j = 0; j < NUMPERFTIMERS; j++)
+	{
+		const UINT32 us = M_PerfMicros(time[j] / n);
+
+		snprintf(s, sizeof s, "%-8s%3u.%02u ms", timernames[j], us / 1000, us % 1000 / 10);
+		V_DrawThinString(4, y, flags|V_YELLOWMAP, s);
+		y += 8;
+
+		if (j != PS_RENDER || gamestate != GS_LEVEL || rendermode != render_soft)
+			continue;
+
+		for (k = 0; k <= splitscreen; k++)
+		{
+			snprintf(s, sizeof s, " view %u: bsp %u planes %u sort %u masked %u us", k + 1,
+				M_PerfMicros(viewtime[k][PS_BSP] / n), M_PerfMicros(viewtime[k][PS_PLANES] / n),
+				M_PerfMicros(viewtime[k][PS_SORT] / n), M_PerfMicros(viewtime[k][PS_MASKED] / n));
+			V_DrawThinString(4, y, flags, s);
+			y += 8;
+
+			snprintf(s, sizeof s, "   segs %u planes %u sprites %u spans %u",
+				(UINT32)(count[k][PS_DRAWSEGS] / n), (UINT32)(count[k][PS_VISPLANES] / n),
+				(UINT32)(count[k][PS_VISSPRITES] / n), (UINT32)(count[k][PS_SPANS] / n));
+			V_DrawThinString(4, y, flags|V_GRAYMAP, s);
+			y += 8;
+		}
+	}
+}
+
+//
+// Command_Perfstatsdump_f
+// Writes the frames perfstats has kept to a CSV file, oldest first.
+//
+static void Command_Perfstatsdump_f(void)
+{
+	const char *name = (COM_Argc() > 1) ? COM_Argv(1) : "perfstats.csv";
+	const char *path;
+	UINT32 i, j, k, first;
+	FILE *f;
+
+	if (!perfframes)
+	{
+		CONS_Printf(M_GetText("No frames to write. Turn perfstats on first.\n"));
+		return;
+	}
+
+	path = va("%s"PATHSEP"%s", srb2home, name);
+	f = fopen(path, "w");
+	if (!f)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't open %s for writing\n"), path);
+		return;
+	}
+
+	fputs("frame_us,render_us,hud_us,luahud_us,finishupdate_us,sound_us", f);
+	for (j = 0; j < MAXSPLITSCREENPLAYERS; j++)
+		fprintf(f, ",v%u_bsp_us,v%u_planes_us,v%u_sort_us,v%u_masked_us,v%u_drawsegs,v%u_visplanes,v%u_vissprites,v%u_spans",
+			j+1, j+1, j+1, j+1, j+1, j+1, j+1, j+1);
+	fputc('\n', f);
+
+	first = (perfframes > PERFSTATSFRAMES) ? perfframes - PERFSTATSFRAMES : 0;
+	for (i = first; i < perfframes; i++)
+	{
+		const perfframe_t *frame = &perfhistory[i % PERFSTATSFRAMES];
+
+		for (j = 0; j < NUMPERFTIMERS; j++)
+			fprintf(f, j ? ",%u" : "%u", M_PerfMicros(frame->time[j]));
+
+		for (j = 0; j < MAXSPLITSCREENPLAYERS; j++)
+		{
+			for (k = 0; k < NUMPERFVIEWTIMERS; k++)
+				fprintf(f, ",%u", M_PerfMicros(frame->viewtime[j][k]));
+			for (k = 0; k < NUMPERFCOUNTERS; k++)
+				fprintf(f, ",%u", frame->count[j][k]);
+		}
+		fputc('\n', f);
+	}
+
+	fclose(f);
+	CONS_Printf(M_GetText("Wrote %u frames to %s\n"), perfframes - first, path);
+}
+
+void M_InitPerfStats(void)
+{
+	CV_RegisterVar(&cv_perfstats);
+	COM_AddCommand("perfstatsdump", Command_Perfstatsdump_f);
+}
@@ -0,0 +1,75 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2020 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_perfstats.h
+/// \brief Frame time breakdown, shown with the perfstats variable
+
+#ifndef __M_PERFSTATS_H__
+#define __M_PERFSTATS_H__
+
+#include "doomdef.h"
+#include "doomstat.h" // MAXSPLITSCREENPLAYERS
+#include "command.h"
+#include "i_system.h" // precise_t
+
+extern consvar_t cv_perfstats;
+
+// Timed once a frame.
+typedef enum
+{
+	PS_FRAME,        // from the start of one frame to the next
+	PS_RENDER,       // every view, start to end
+	PS_HUD,          // K_drawKartHUD, for every view
+	PS_LUAHUD,       // Lua HUD hooks and draw lists
+	PS_FINISHUPDATE, // I_FinishUpdate
+	PS_SOUND,        // S_UpdateSounds
+	NUMPERFTIMERS
+} perftimer_t;
+
+// Timed for each view. With the view drawn in strips, these are the strips'
+// times added together.
+typedef enum
+{
+	PS_BSP,    // R_RenderBSPNode, portals included
+	PS_PLANES, // R_DrawPlanes
+	PS_SORT,   // R_SortVisSprites
+	PS_MASKED, // R_DrawMasked, less the sort
+	NUMPERFVIEWTIMERS
+} perfviewtimer_t;
+
+typedef enum
+{
+	PS_DRAWSEGS,
+	PS_VISPLANES,
+	PS_VISSPRITES,
+	PS_SPANS,
+	NUMPERFCOUNTERS
+} perfcounter_t;
+
+typedef struct
+{
+	precise_t time[NUMPERFTIMERS];
+	precise_t viewtime[MAXSPLITSCREENPLAYERS][NUMPERFVIEWTIMERS];
+	UINT32 count[MAXSPLITSCREENPLAYERS][NUMPERFCOUNTERS];
+} perfframe_t;
+
+void M_InitPerfStats(void);
+
+// Returns the time to pass to M_PerfStop, or 0 if perfstats is off.
+precise_t M_PerfStart(void);
+void M_PerfStop(perftimer_t timer, precise_t start);
+
+// Adds the time since *start to the view being drawn, then sets *start
+// to now, so the next part of the view can be timed from there.
+void M_PerfStopView(perfviewtimer_t timer, precise_t *start);
+void M_PerfCountView(UINT32 drawsegs, UINT32 visplanes, UINT32 vissprites, UINT32 spans);
+
+void M_PerfFinishFrame(void);
+void M_DrawPerfStats(void);
+
+#endif
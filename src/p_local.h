@@ -64,11 +64,22 @@
 // P_TICK
 //
 
-// both the head and tail of the thinker list
-extern thinker_t thinkercap;
+// Thinkers are kept in one list per kind, so code looking for one kind
+// doesn't have to step over the rest. P_RunThinkers runs them in this order.
+typedef enum
+{
+	THINK_POLYOBJ,
+	THINK_MAIN, // sector movers, lights and other level specials
+	THINK_PUSH, // scrollers, friction and pushers
+	THINK_MOBJ,
+	NUM_THINKERLISTS
+} thinklistnum_t;
+
+// both the head and tail of each thinker list
+extern thinker_t thlist[NUM_THINKERLISTS];
 
 void P_InitThinkers(void);
-void P_AddThinker(thinker_t *thinker);
+void P_AddThinker(const thinklistnum_t n, thinker_t *thinker);
 void P_RemoveThinker(thinker_t *thinker);
 
 //
@@ -339,7 +350,6 @@ extern line_t *ceilingline;
 extern line_t *blockingline;
 extern msecnode_t *sector_list;
 
-extern mprecipsecnode_t *precipsector_list;
 
 void P_UnsetThingPosition(mobj_t *thing);
 void P_SetThingPosition(mobj_t *thing);
@@ -360,7 +370,6 @@ void P_CheckHoopPosition(mobj_t *hoopthing, fixed_t x, fixed_t y, fixed_t z, fix
 boolean P_CheckSector(sector_t *sector, boolean crunch);
 
 void P_DelSeclist(msecnode_t *node);
-void P_DelPrecipSeclist(mprecipsecnode_t *node);
 
 void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y);
 void P_Initsecnode(void);
@@ -372,6 +381,8 @@ boolean PIT_PushableMoved(mobj_t *thing);
 
 boolean P_DoSpring(mobj_t *spring, mobj_t *object);
 
+void Command_CheckThingBench_f(void);
+
 //
 // P_SETUP
 //
@@ -425,6 +436,11 @@ void P_DoNightsScore(player_t *player);
 //
 #include "p_spec.h"
 
+//
+// P_PRECIP
+//
+#include "p_precip.h"
+
 extern INT32 ceilmovesound;
 
 // Factor to scale scrolling effect into mobj-carrying properties = 3/32.
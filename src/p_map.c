@@ -44,9 +44,6 @@ static INT32 tmflags;
 fixed_t tmx;
 fixed_t tmy;
 
-static precipmobj_t *tmprecipthing;
-static fixed_t preciptmbbox[4];
-
 // If "floatok" true, move would be ok
 // if within "tmfloorz - tmceilingz".
 boolean floatok;
@@ -66,7 +63,6 @@ line_t *ceilingline;
 line_t *blockingline;
 
 msecnode_t *sector_list = NULL;
-mprecipsecnode_t *precipsector_list = NULL;
 camera_t *mapcampointer;
 
 //
@@ -3950,7 +3946,7 @@ static boolean PIT_ChangeSector(mobj_t *thing, boolean realcrush)
 						thinker_t *think;
 						elevator_t *crumbler;
 
-						for (think = thinkercap.next; think != &thinkercap; think = think->next)
+						for (think = thlist[THINK_MAIN].next; think != &thlist[THINK_MAIN]; think = think->next)
 						{
 							if (think->function.acp1 != (actionf_p1)T_StartCrumble)
 								continue;
@@ -4146,12 +4142,10 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 */
 
 static msecnode_t *headsecnode = NULL;
-static mprecipsecnode_t *headprecipsecnode = NULL;
 
 void P_Initsecnode(void)
 {
 	headsecnode = NULL;
-	headprecipsecnode = NULL;
 }
 
 // P_GetSecnode() retrieves a node from the freelist. The calling routine
@@ -4171,20 +4165,6 @@ static msecnode_t *P_GetSecnode(void)
 	return node;
 }
 
-static mprecipsecnode_t *P_GetPrecipSecnode(void)
-{
-	mprecipsecnode_t *node;
-
-	if (headprecipsecnode)
-	{
-		node = headprecipsecnode;
-		headprecipsecnode = headprecipsecnode->m_thinglist_next;
-	}
-	else
-		node = Z_Calloc(sizeof (*node), PU_LEVEL, NULL);
-	return node;
-}
-
 // P_PutSecnode() returns a node to the freelist.
 
 static inline void P_PutSecnode(msecnode_t *node)
@@ -4193,13 +4173,6 @@ static inline void P_PutSecnode(msecnode_t *node)
 	headsecnode = node;
 }
 
-// Tails 08-25-2002
-static inline void P_PutPrecipSecnode(mprecipsecnode_t *node)
-{
-	node->m_thinglist_next = headprecipsecnode;
-	headprecipsecnode = node;
-}
-
 // P_AddSecnode() searches the current list to see if this sector is
 // already there. If not, it adds a sector node at the head of the list of
 // sectors this object appears in. This is called when creating a list of
@@ -4245,47 +4218,6 @@ static msecnode_t *P_AddSecnode(sector_t *s, mobj_t *thing, msecnode_t *nextnode
 	return node;
 }
 
-// More crazy crap Tails 08-25-2002
-static mprecipsecnode_t *P_AddPrecipSecnode(sector_t *s, precipmobj_t *thing, mprecipsecnode_t *nextnode)
-{
-	mprecipsecnode_t *node;
-
-	node = nextnode;
-	while (node)
-	{
-		if (node->m_sector == s) // Already have a node for this sector?
-		{
-			node->m_thing = thing; // Yes. Setting m_thing says 'keep it'.
-			return nextnode;
-		}
-		node = node->m_sectorlist_next;
-	}
-
-	// Couldn't find an existing node for this sector. Add one at the head
-	// of the list.
-
-	node = P_GetPrecipSecnode();
-
-	// mark new nodes unvisited.
-	node->visited = 0;
-
-	node->m_sector = s; // sector
-	node->m_thing = thing; // mobj
-	node->m_sectorlist_prev = NULL; // prev node on Thing thread
-	node->m_sectorlist_next = nextnode; // next node on Thing thread
-	if (nextnode)
-		nextnode->m_sectorlist_prev = node; // set back link on Thing
-
-	// Add new node at head of sector thread starting at s->touching_thinglist
-
-	node->m_thinglist_prev = NULL; // prev node on sector thread
-	node->m_thinglist_next = s->touching_preciplist; // next node on sector thread
-	if (s->touching_preciplist)
-		node->m_thinglist_next->m_thinglist_prev = node;
-	s->touching_preciplist = node;
-	return node;
-}
-
 // P_DelSecnode() deletes a sector node from the list of
 // sectors this object appears in. Returns a pointer to the next node
 // on the linked list, or NULL.
@@ -4328,45 +4260,6 @@ static msecnode_t *P_DelSecnode(msecnode_t *node)
 	return tn;
 }
 
-// Tails 08-25-2002
-static mprecipsecnode_t *P_DelPrecipSecnode(mprecipsecnode_t *node)
-{
-	mprecipsecnode_t *tp; // prev node on thing thread
-	mprecipsecnode_t *tn; // next node on thing thread
-	mprecipsecnode_t *sp; // prev node on sector thread
-	mprecipsecnode_t *sn; // next node on sector thread
-
-	if (!node)
-		return NULL;
-
-	// Unlink from the Thing thread. The Thing thread begins at
-	// sector_list and not from mobj_t->touching_sectorlist.
-
-	tp = node->m_sectorlist_prev;
-	tn = node->m_sectorlist_next;
-	if (tp)
-		tp->m_sectorlist_next = tn;
-	if (tn)
-		tn->m_sectorlist_prev = tp;
-
-	// Unlink from the sector thread. This thread begins at
-	// sector_t->touching_thinglist.
-
-	sp = node->m_thinglist_prev;
-	sn = node->m_thinglist_next;
-	if (sp)
-		sp->m_thinglist_next = sn;
-	else
-		node->m_sector->touching_preciplist = sn;
-	if (sn)
-		sn->m_thinglist_prev = sp;
-
-	// Return this node to the freelist
-
-	P_PutPrecipSecnode(node);
-	return tn;
-}
-
 // Delete an entire sector list
 void P_DelSeclist(msecnode_t *node)
 {
@@ -4374,13 +4267,6 @@ void P_DelSeclist(msecnode_t *node)
 		node = P_DelSecnode(node);
 }
 
-// Tails 08-25-2002
-void P_DelPrecipSeclist(mprecipsecnode_t *node)
-{
-	while (node)
-		node = P_DelPrecipSecnode(node);
-}
-
 // PIT_GetSectors
 // Locates all the sectors the object is in by looking at the lines that
 // cross through it. You have already decided that the object is allowed
@@ -4421,41 +4307,6 @@ static inline boolean PIT_GetSectors(line_t *ld)
 	return true;
 }
 
-// Tails 08-25-2002
-static inline boolean PIT_GetPrecipSectors(line_t *ld)
-{
-	if (preciptmbbox[BOXRIGHT] <= ld->bbox[BOXLEFT] ||
-		preciptmbbox[BOXLEFT] >= ld->bbox[BOXRIGHT] ||
-		preciptmbbox[BOXTOP] <= ld->bbox[BOXBOTTOM] ||
-		preciptmbbox[BOXBOTTOM] >= ld->bbox[BOXTOP])
-	return true;
-
-	if (P_BoxOnLineSide(preciptmbbox, ld) != -1)
-		return true;
-
-	if (ld->polyobj) // line belongs to a polyobject, don't add it
-		return true;
-
-	// This line crosses through the object.
-
-	// Collect the sector(s) from the line and add to the
-	// sector_list you're examining. If the Thing ends up being
-	// allowed to move to this position, then the sector_list
-	// will be attached to the Thing's mobj_t at touching_sectorlist.
-
-	precipsector_list = P_AddPrecipSecnode(ld->frontsector, tmprecipthing, precipsector_list);
-
-	// Don't assume all lines are 2-sided, since some Things
-	// like MT_TFOG are allowed regardless of whether their radius takes
-	// them beyond an impassable linedef.
-
-	// Use sidedefs instead of 2s flag to determine two-sidedness.
-	if (ld->backsector)
-		precipsector_list = P_AddPrecipSecnode(ld->backsector, tmprecipthing, precipsector_list);
-
-	return true;
-}
-
 // P_CreateSecNodeList alters/creates the sector_list that shows what sectors
 // the object resides in.
 
@@ -4542,73 +4393,6 @@ void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y)
 	}
 }
 
-// More crazy crap Tails 08-25-2002
-void P_CreatePrecipSecNodeList(precipmobj_t *thing,fixed_t x,fixed_t y)
-{
-	INT32 xl, xh, yl, yh, bx, by;
-	mprecipsecnode_t *node = precipsector_list;
-	precipmobj_t *saved_tmthing = tmprecipthing; /* cph - see comment at func end */
-
-	// First, clear out the existing m_thing fields. As each node is
-	// added or verified as needed, m_thing will be set properly. When
-	// finished, delete all nodes where m_thing is still NULL. These
-	// represent the sectors the Thing has vacated.
-
-	while (node)
-	{
-		node->m_thing = NULL;
-		node = node->m_sectorlist_next;
-	}
-
-	tmprecipthing = thing;
-
-	preciptmbbox[BOXTOP] = y + 2*FRACUNIT;
-	preciptmbbox[BOXBOTTOM] = y - 2*FRACUNIT;
-	preciptmbbox[BOXRIGHT] = x + 2*FRACUNIT;
-	preciptmbbox[BOXLEFT] = x - 2*FRACUNIT;
-
-	validcount++; // used to make sure we only process a line once
-
-	xl = (unsigned)(preciptmbbox[BOXLEFT] - bmaporgx)>>MAPBLOCKSHIFT;
-	xh = (unsigned)(preciptmbbox[BOXRIGHT] - bmaporgx)>>MAPBLOCKSHIFT;
-	yl = (unsigned)(preciptmbbox[BOXBOTTOM] - bmaporgy)>>MAPBLOCKSHIFT;
-	yh = (unsigned)(preciptmbbox[BOXTOP] - bmaporgy)>>MAPBLOCKSHIFT;
-
-	BMBOUNDFIX(xl, xh, yl, yh);
-
-	for (bx = xl; bx <= xh; bx++)
-		for (by = yl; by <= yh; by++)
-			P_BlockLinesIterator(bx, by, PIT_GetPrecipSectors);
-
-	// Add the sector of the (x, y) point to sector_list.
-	precipsector_list = P_AddPrecipSecnode(thing->subsector->sector, thing, precipsector_list);
-
-	// Now delete any nodes that won't be used. These are the ones where
-	// m_thing is still NULL.
-	node = precipsector_list;
-	while (node)
-	{
-		if (!node->m_thing)
-		{
-			if (node == precipsector_list)
-				precipsector_list = node->m_sectorlist_next;
-			node = P_DelPrecipSecnode(node);
-		}
-		else
-			node = node->m_sectorlist_next;
-	}
-
-	/* cph -
-	* This is the strife we get into for using global variables. tmthing
-	*  is being used by several different functions calling
-	*  P_BlockThingIterator, including functions that can be called *from*
-	*  P_BlockThingIterator. Using a global tmthing is not reentrant.
-	* OTOH for Boom/MBF demos we have to preserve the buggy behavior.
-	*  Fun. We restore its previous value unless we're in a Boom/MBF demo.
-	*/
-	tmprecipthing = saved_tmthing;
-}
-
 /* cphipps 2004/08/30 -
  * Must clear tmthing at tic end, as it might contain a pointer to a removed thinker, or the level might have ended/been ended and we clear the objects it was pointing too. Hopefully we don't need to carry this between tics for sync. */
 void P_MapStart(void)
@@ -4675,3 +4459,173 @@ fixed_t P_FloorzAtPos(fixed_t x, fixed_t y, fixed_t z, fixed_t height)
 
 	return floorz;
 }
+
+// =========================================================================
+//                                                  BLOCKMAP THING BENCHMARK
+// =========================================================================
+
+#define BENCHGRIDSIZE 4 // 4x4, like a full 16 player start grid
+
+static UINT32 benchchecks;
+
+//
+// P_BlockThingsIteratorRefcount
+// P_BlockThingsIterator as it was before blockmapepoch, holding a
+// reference on bnext for every mobj visited. Only kept to compare against.
+//
+static boolean P_BlockThingsIteratorRefcount(INT32 x, INT32 y, boolean (*func)(mobj_t *))
+{
+	mobj_t *mobj, *bnext = NULL;
+
+	if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+		return true;
+
+	for (mobj = blocklinks[y*bmapwidth + x]; mobj; mobj = bnext)
+	{
+		P_SetTarget(&bnext, mobj->bnext);
+		if (!func(mobj))
+		{
+			P_SetTarget(&bnext, NULL);
+			return false;
+		}
+		if (P_MobjWasRemoved(tmthing)
+		|| (bnext && P_MobjWasRemoved(bnext)))
+		{
+			P_SetTarget(&bnext, NULL);
+			return true;
+		}
+	}
+	P_SetTarget(&bnext, NULL);
+	return true;
+}
+
+//
+// PIT_BenchCheckThing
+// Runs PIT_CheckThing only on things it would find out of reach anyway,
+// so the benchmark can't bump, hurt or pick up anything.
+//
+static boolean PIT_BenchCheckThing(mobj_t *thing)
+{
+	fixed_t blockdist = thing->radius + tmthing->radius;
+
+	if (thing != tmthing && abs(thing->x - tmx) < blockdist && abs(thing->y - tmy) < blockdist)
+		return true;
+
+	benchchecks++;
+	return PIT_CheckThing(thing);
+}
+
+//
+// P_BenchCheckThings
+// The thing half of P_CheckPosition, using the given iterator.
+//
+static void P_BenchCheckThings(mobj_t *thing, boolean (*iterator)(INT32, INT32, boolean (*)(mobj_t *)))
+{
+	INT32 xl, xh, yl, yh, bx, by;
+
+	P_SetTarget(&tmthing, thing);
+	tmflags = thing->flags;
+
+	tmx = thing->x;
+	tmy = thing->y;
+
+	tmbbox[BOXTOP] = tmy + thing->radius;
+	tmbbox[BOXBOTTOM] = tmy - thing->radius;
+	tmbbox[BOXRIGHT] = tmx + thing->radius;
+	tmbbox[BOXLEFT] = tmx - thing->radius;
+
+	xl = (unsigned)(tmbbox[BOXLEFT] - bmaporgx - MAXRADIUS)>>MAPBLOCKSHIFT;
+	xh = (unsigned)(tmbbox[BOXRIGHT] - bmaporgx + MAXRADIUS)>>MAPBLOCKSHIFT;
+	yl = (unsigned)(tmbbox[BOXBOTTOM] - bmaporgy - MAXRADIUS)>>MAPBLOCKSHIFT;
+	yh = (unsigned)(tmbbox[BOXTOP] - bmaporgy + MAXRADIUS)>>MAPBLOCKSHIFT;
+
+	BMBOUNDFIX(xl, xh, yl, yh);
+
+	for (bx = xl; bx <= xh; bx++)
+		for (by = yl; by <= yh; by++)
+			iterator(bx, by, PIT_BenchCheckThing);
+}
+
+//
+// Command_CheckThingBench_f
+// Packs a start grid of solid things around the player and times
+// PIT_CheckThing over it with the refcounting and epoch iterators.
+//
+void Command_CheckThingBench_f(void)
+{
+	mobj_t *grid[BENCHGRIDSIZE*BENCHGRIDSIZE];
+	mobj_t *pmo = players[consoleplayer].mo;
+	mobj_t *saved_tmthing = tmthing;
+	fixed_t saved_tmx = tmx, saved_tmy = tmy;
+	INT32 saved_tmflags = tmflags;
+	UINT64 precision = I_GetPrecisePrecision();
+	precise_t time[2] = {0, 0}, t;
+	UINT32 checks[2] = {0, 0};
+	fixed_t spacing;
+	INT32 runs = 1000, run, i, j;
+
+	if (COM_Argc() > 1)
+		runs = max(atoi(COM_Argv(1)), 1);
+
+	if (gamestate != GS_LEVEL || !pmo || P_MobjWasRemoved(pmo))
+	{
+		CONS_Printf(M_GetText("You must be in a level to use this.\n"));
+		return;
+	}
+
+	if (netgame || demo.recording || demo.playback)
+	{
+		CONS_Printf(M_GetText("This only works in a local game that isn't being recorded.\n"));
+		return;
+	}
+
+	// Solid things a little more than their width apart, just north of us
+	spacing = 3*mobjinfo[MT_GARGOYLE].radius;
+	for (i = 0; i < BENCHGRIDSIZE; i++)
+		for (j = 0; j < BENCHGRIDSIZE; j++)
+			grid[i*BENCHGRIDSIZE + j] = P_SpawnMobj(
+				pmo->x + (j - BENCHGRIDSIZE/2)*spacing,
+				pmo->y + (i + 1)*spacing,
+				pmo->z, MT_GARGOYLE);
+
+	for (run = 0; run < runs; run++)
+	{
+		benchchecks = 0;
+		t = I_GetPreciseTime();
+		for (i = 0; i < BENCHGRIDSIZE*BENCHGRIDSIZE; i++)
+			P_BenchCheckThings(grid[i], P_BlockThingsIteratorRefcount);
+		time[0] += I_GetPreciseTime() - t;
+		checks[0] += benchchecks;
+
+		benchchecks = 0;
+		t = I_GetPreciseTime();
+		for (i = 0; i < BENCHGRIDSIZE*BENCHGRIDSIZE; i++)
+			P_BenchCheckThings(grid[i], P_BlockThingsIterator);
+		time[1] += I_GetPreciseTime() - t;
+		checks[1] += benchchecks;
+	}
+
+	for (i = 0; i < BENCHGRIDSIZE*BENCHGRIDSIZE; i++)
+		P_RemoveMobj(grid[i]);
+
+	P_SetTarget(&tmthing, saved_tmthing);
+	tmx = saved_tmx, tmy = saved_tmy;
+	tmflags = saved_tmflags;
+	if (tmthing)
+	{
+		tmbbox[BOXTOP] = tmy + tmthing->radius;
+		tmbbox[BOXBOTTOM] = tmy - tmthing->radius;
+		tmbbox[BOXRIGHT] = tmx + tmthing->radius;
+		tmbbox[BOXLEFT] = tmx - tmthing->radius;
+	}
+
+	for (i = 0; i < 2; i++)
+	{
+		CONS_Printf(M_GetText("%s: %u checks in %u us, %u checks per ms\n"),
+			i ? "Epoch" : "Refcount", checks[i],
+			(UINT32)(time[i] * 1000000 / precision),
+			time[i] ? (UINT32)((UINT64)checks[i] * precision / 1000 / time[i]) : 0);
+	}
+}
+
+#undef BENCHGRIDSIZE
@@ -22,6 +22,8 @@
 #include "p_polyobj.h"
 #include "p_slopes.h"
 #include "z_zone.h"
+#include "console.h"
+#include "command.h"
 
 //
 // P_ClosestPointOnLine
@@ -791,20 +793,10 @@ void P_UnsetThingPosition(mobj_t *thing)
 		mobj_t *bnext, **bprev = thing->bprev;
 		if (bprev && (*bprev = bnext = thing->bnext) != NULL)  // unlink from block map
 			bnext->bprev = bprev;
+		blockmapepoch++;
 	}
 }
 
-void P_UnsetPrecipThingPosition(precipmobj_t *thing)
-{
-	precipmobj_t **sprev = thing->sprev;
-	precipmobj_t  *snext = thing->snext;
-	if ((*sprev = snext) != NULL)  // unlink from sector list
-		snext->sprev = sprev;
-
-	precipsector_list = thing->touching_sectorlist;
-	thing->touching_sectorlist = NULL; //to be restored by P_SetPrecipThingPosition
-}
-
 //
 // P_SetThingPosition
 // Links a thing into both a block and a subsector
@@ -931,22 +923,6 @@ void P_SetUnderlayPosition(mobj_t *thing)
 	sector_list = NULL; // clear for next time
 }
 
-void P_SetPrecipitationThingPosition(precipmobj_t *thing)
-{
-	subsector_t *ss = thing->subsector = R_PointInSubsector(thing->x, thing->y);
-
-	precipmobj_t **link = &ss->sector->preciplist;
-	precipmobj_t *snext = *link;
-	if ((thing->snext = snext) != NULL)
-		snext->sprev = &thing->snext;
-	thing->sprev = link;
-	*link = thing;
-
-	P_CreatePrecipSecNodeList(thing, thing->x, thing->y);
-	thing->touching_sectorlist = precipsector_list; // Attach to Thing's precipmobj_t
-	precipsector_list = NULL; // clear for next time
-}
-
 //
 // BLOCK MAP ITERATORS
 // For each line/thing in the given mapblock,
@@ -1019,34 +995,49 @@ boolean P_BlockLinesIterator(INT32 x, INT32 y, boolean (*func)(line_t *))
 }
 
 
+// Bumped whenever a mobj is removed or unlinked from a blockmap cell.
+UINT32 blockmapepoch = 0;
+
+// Nonzero while P_BlockThingsIterator is running its callback.
+// P_RemoveMobj holds off freeing MF_NOTHINK mobjs until the thinkers next run.
+INT32 blockthingsdepth = 0;
+
 //
 // P_BlockThingsIterator
 //
+// No mobj gets freed while we're in here, so the bnext we saved stays valid
+// memory even if func removes it. If blockmapepoch didn't move, nothing was
+// removed or unlinked either, and we don't need to look at bnext at all.
+//
 boolean P_BlockThingsIterator(INT32 x, INT32 y, boolean (*func)(mobj_t *))
 {
-	mobj_t *mobj, *bnext = NULL;
+	mobj_t *mobj, *bnext;
+	UINT32 epoch;
+	boolean ret = true;
 
 	if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
 		return true;
 
+	blockthingsdepth++;
+
 	// Check interaction with the objects in the blockmap.
 	for (mobj = blocklinks[y*bmapwidth + x]; mobj; mobj = bnext)
 	{
-		P_SetTarget(&bnext, mobj->bnext); // We want to note our reference to bnext here incase it is MF_NOTHINK and gets removed!
+		bnext = mobj->bnext;
+		epoch = blockmapepoch;
 		if (!func(mobj))
 		{
-			P_SetTarget(&bnext, NULL);
-			return false;
-		}
-		if (P_MobjWasRemoved(tmthing) // func just popped our tmthing, cannot continue.
-		|| (bnext && P_MobjWasRemoved(bnext))) // func just broke blockmap chain, cannot continue.
-		{
-			P_SetTarget(&bnext, NULL);
-			return true;
+			ret = false;
+			break;
 		}
+		if (P_MobjWasRemoved(tmthing)) // func just popped our tmthing, cannot continue.
+			break;
+		if (epoch != blockmapepoch && bnext && P_MobjWasRemoved(bnext)) // func just broke blockmap chain, cannot continue.
+			break;
 	}
-	P_SetTarget(&bnext, NULL);
-	return true;
+
+	blockthingsdepth--;
+	return ret;
 }
 
 //
@@ -1057,9 +1048,15 @@ boolean P_BlockThingsIterator(INT32 x, INT32 y, boolean (*func)(mobj_t *))
 static intercept_t *intercepts = NULL;
 static intercept_t *intercept_p = NULL;
 
+// Binary min-heap of indices into intercepts, ordered by frac.
+static UINT32 *interceptheap = NULL;
+
 divline_t trace;
 static boolean earlyout;
 
+// Traversal stats, see Command_Intercepts_f
+static UINT32 traversecount, interceptcount, interceptvisits, interceptmax;
+
 //SoM: 4/6/2000: Remove limit on intercepts.
 static void P_CheckIntercepts(void)
 {
@@ -1074,6 +1071,7 @@ static void P_CheckIntercepts(void)
 			max_intercepts *= 2;
 
 		intercepts = Z_Realloc(intercepts, sizeof (*intercepts) * max_intercepts, PU_STATIC, NULL);
+		interceptheap = Z_Realloc(interceptheap, sizeof (*interceptheap) * max_intercepts, PU_STATIC, NULL);
 
 		intercept_p = intercepts + count;
 	}
@@ -1191,43 +1189,102 @@ static boolean PIT_AddThingIntercepts(mobj_t *thing)
 	return true; // Keep going.
 }
 
+//
+// P_InterceptBefore
+// Ties go to whichever intercept was added first,
+// same as the old linear scan for the nearest one.
+//
+FUNCINLINE static ATTRINLINE boolean P_InterceptBefore(UINT32 a, UINT32 b)
+{
+	if (intercepts[a].frac != intercepts[b].frac)
+		return intercepts[a].frac < intercepts[b].frac;
+	return a < b;
+}
+
+static void P_SiftInterceptDown(size_t i, size_t count)
+{
+	UINT32 top = interceptheap[i];
+	size_t child;
+
+	while ((child = 2*i + 1) < count)
+	{
+		if (child + 1 < count && P_InterceptBefore(interceptheap[child + 1], interceptheap[child]))
+			child++;
+		if (!P_InterceptBefore(interceptheap[child], top))
+			break;
+		interceptheap[i] = interceptheap[child];
+		i = child;
+	}
+
+	interceptheap[i] = top;
+}
+
 //
 // P_TraverseIntercepts
 // Returns true if the traverser function returns true
 // for all lines.
 //
+// The intercepts are heaped once and then popped nearest first, so a
+// traverse that stops early only pays for the ones it looked at.
+//
 static boolean P_TraverseIntercepts(traverser_t func, fixed_t maxfrac)
 {
-	size_t count;
-	fixed_t dist;
-	intercept_t *scan, *in = NULL;
+	size_t count, i;
+	intercept_t *in;
 
 	count = intercept_p - intercepts;
 
-	while (count--)
+	traversecount++;
+	interceptcount += (UINT32)count;
+	if (count > interceptmax)
+		interceptmax = (UINT32)count;
+
+	for (i = 0; i < count; i++)
+		interceptheap[i] = (UINT32)i;
+	for (i = count/2; i-- > 0;)
+		P_SiftInterceptDown(i, count);
+
+	while (count)
 	{
-		dist = INT32_MAX;
-		for (scan = intercepts; scan < intercept_p; scan++)
-		{
-			if (scan->frac < dist)
-			{
-				dist = scan->frac;
-				in = scan;
-			}
-		}
+		in = &intercepts[interceptheap[0]];
 
-		if (dist > maxfrac)
+		if (in->frac > maxfrac)
 			return true; // Checked everything in range.
 
+		interceptvisits++;
+
 		if (!func(in))
 			return false; // Don't bother going farther.
 
-		in->frac = INT32_MAX;
+		if (--count)
+		{
+			interceptheap[0] = interceptheap[count];
+			P_SiftInterceptDown(0, count);
+		}
 	}
 
 	return true; // Everything was traversed.
 }
 
+//
+// Command_Intercepts_f
+// Shows how many intercepts path traversals collect and visit.
+//
+void Command_Intercepts_f(void)
+{
+	if (COM_Argc() > 1 && !stricmp(COM_Argv(1), "reset"))
+	{
+		traversecount = interceptcount = interceptvisits = interceptmax = 0;
+		return;
+	}
+
+	CONS_Printf(M_GetText("%u traverses, %u intercepts (%u.%02u per traverse, %u at most), %u visited\n"),
+		traversecount, interceptcount,
+		traversecount ? interceptcount / traversecount : 0,
+		traversecount ? (UINT32)((UINT64)(interceptcount % traversecount) * 100 / traversecount) : 0,
+		interceptmax, interceptvisits);
+}
+
 //
 // P_PathTraverse
 // Traces a line from x1, y1 to x2, y2,
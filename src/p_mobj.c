@@ -30,6 +30,7 @@
 #include "m_misc.h"
 #include "info.h"
 #include "i_video.h"
+#include "lua_script.h"
 #include "lua_hook.h"
 #include "b_bot.h"
 #include "p_slopes.h"
@@ -338,25 +339,6 @@ boolean P_SetMobjStateNF(mobj_t *mobj, statenum_t state)
 	return true;
 }
 
-static boolean P_SetPrecipMobjState(precipmobj_t *mobj, statenum_t state)
-{
-	state_t *st;
-
-	if (state == S_NULL)
-	{ // Remove mobj
-		P_RemovePrecipMobj(mobj);
-		return false;
-	}
-	st = &states[state];
-	mobj->state = st;
-	mobj->tics = st->tics;
-	mobj->sprite = st->sprite;
-	mobj->frame = st->frame;
-	mobj->anim_duration = (UINT16)st->var2; // only used if FF_ANIMATE is set
-
-	return true;
-}
-
 //
 // P_MobjFlip
 //
@@ -420,7 +402,7 @@ boolean P_WeaponOrPanel(mobjtype_t type)
 		spawnpoints[i] = NULL;
 	}
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
 	{
 		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -3403,7 +3385,7 @@ void P_DestroyRobots(void)
 	mobj_t *mo;
 	thinker_t *think;
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
 	{
 		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -3734,123 +3716,6 @@ animonly:
 	}
 }
 
-static void CalculatePrecipFloor(precipmobj_t *mobj)
-{
-	// recalculate floorz each time
-	const sector_t *mobjsecsubsec;
-	if (mobj && mobj->subsector && mobj->subsector->sector)
-		mobjsecsubsec = mobj->subsector->sector;
-	else
-		return;
-	mobj->floorz =
-				mobjsecsubsec->f_slope ? P_GetZAt(mobjsecsubsec->f_slope, mobj->x, mobj->y) :
-				mobjsecsubsec->floorheight;
-	if (mobjsecsubsec->ffloors)
-	{
-		ffloor_t *rover;
-		fixed_t topheight;
-
-		for (rover = mobjsecsubsec->ffloors; rover; rover = rover->next)
-		{
-			// If it exists, it'll get rained on.
-			if (!(rover->flags & FF_EXISTS))
-				continue;
-
-			if (!(rover->flags & FF_BLOCKOTHERS) && !(rover->flags & FF_SWIMMABLE))
-				continue;
-
-			if (*rover->t_slope)
-				topheight = P_GetZAt(*rover->t_slope, mobj->x, mobj->y);
-			else
-			topheight = *rover->topheight;
-
-			if (topheight > mobj->floorz)
-				mobj->floorz = topheight;
-		}
-	}
-}
-
-void P_RecalcPrecipInSector(sector_t *sector)
-{
-	mprecipsecnode_t *psecnode;
-
-	if (!sector)
-		return;
-
-	sector->moved = true; // Recalc lighting and things too, maybe
-
-	for (psecnode = sector->touching_preciplist; psecnode; psecnode = psecnode->m_thinglist_next)
-		CalculatePrecipFloor(psecnode->m_thing);
-}
-
-//
-// P_NullPrecipThinker
-//
-// For "Blank" precipitation
-//
-void P_NullPrecipThinker(precipmobj_t *mobj)
-{
-	//(void)mobj;
-	mobj->precipflags &= ~PCF_THUNK;
-}
-
-void P_SnowThinker(precipmobj_t *mobj)
-{
-	R_ResetPrecipitationMobjInterpolationState(mobj);
-
-	P_CycleStateAnimation((mobj_t *)mobj);
-
-	// adjust height
-	if ((mobj->z += mobj->momz) <= mobj->floorz)
-	{
-		mobj->z = mobj->ceilingz;
-		R_ResetPrecipitationMobjInterpolationState(mobj);
-	}
-}
-
-void P_RainThinker(precipmobj_t *mobj)
-{
-	R_ResetPrecipitationMobjInterpolationState(mobj);
-
-	P_CycleStateAnimation((mobj_t *)mobj);
-
-	if (mobj->state != &states[S_RAIN1])
-	{
-		// cycle through states,
-		// calling action functions at transitions
-		if (mobj->tics <= 0)
-			return;
-
-		if (--mobj->tics)
-			return;
-
-		if (!P_SetPrecipMobjState(mobj, mobj->state->nextstate))
-			return;
-
-		if (mobj->state != &states[S_RAINRETURN])
-			return;
-
-		mobj->z = mobj->ceilingz;
-		R_ResetPrecipitationMobjInterpolationState(mobj);
-		P_SetPrecipMobjState(mobj, S_RAIN1);
-
-		return;
-	}
-
-	// adjust height
-	if ((mobj->z += mobj->momz) <= mobj->floorz)
-	{
-		// no splashes on sky or bottomless pits
-		if (mobj->precipflags & PCF_PIT)
-			mobj->z = mobj->ceilingz;
-		else
-		{
-			mobj->z = mobj->floorz;
-			P_SetPrecipMobjState(mobj, S_SPLASH1);
-		}
-	}
-}
-
 static void P_RingThinker(mobj_t *mobj)
 {
 	if (mobj->momx || mobj->momy)
@@ -4212,7 +4077,7 @@ static void P_Boss3Thinker(mobj_t *mobj)
 
 			// scan the thinkers to make sure all the old pinch dummies are gone before making new ones
 			// this can happen if the boss was hurt earlier than expected
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 			{
 				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 					continue;
@@ -4303,7 +4168,7 @@ static void P_Boss3Thinker(mobj_t *mobj)
 		// scan the thinkers
 		// to find a point that matches
 		// the number
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -4924,7 +4789,7 @@ static void P_Boss7Thinker(mobj_t *mobj)
 				closestdist = 16384*FRACUNIT; // Just in case...
 
 				// Find waypoint he is closest to
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 				{
 					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 						continue;
@@ -4979,7 +4844,7 @@ static void P_Boss7Thinker(mobj_t *mobj)
 
 		// scan the thinkers to find
 		// the waypoint to use
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -5102,7 +4967,7 @@ static void P_Boss9Thinker(mobj_t *mobj)
 
 		// Run through the thinkers ONCE and find all of the MT_BOSS9GATHERPOINT in the map.
 		// Build a hoop linked list of 'em!
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -5536,7 +5401,7 @@ mobj_t *P_GetClosestAxis(mobj_t *source)
 	fixed_t dist1, dist2 = 0;
 
 	// scan the thinkers to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -9505,6 +9370,112 @@ void P_SceneryThinker(mobj_t *mobj)
 // GAME SPAWN FUNCTIONS
 //
 
+//
+// MOBJ POOLS
+//
+// Freed mobjs are chained up by their thinker's next pointer here instead
+// of being handed back to the zone, and spawning takes from these lists
+// first. Nothing is put in until P_RemoveThinkerDelayed sees its reference
+// count drop to zero, so a pooled object is never one something still
+// points at. The memory itself is still PU_LEVEL, so the lists are simply
+// dropped when the level is purged.
+//
+typedef struct
+{
+	const char *name;
+	size_t size;
+	thinker_t *free;
+	UINT32 numfree, maxfree;
+	UINT32 allocs, reused, returned;
+} mobjpooldata_t;
+
+static mobjpooldata_t mobjpools[NUMMOBJPOOLS] = {
+	{NULL, 0, NULL, 0, 0, 0, 0, 0},
+	{"Mobjs", sizeof (mobj_t), NULL, 0, 0, 0, 0, 0},
+};
+
+// Zeroed memory for a new object, like Z_Calloc would give.
+void *P_AllocMobjMemory(mobjpool_t poolnum)
+{
+	mobjpooldata_t *pool = &mobjpools[poolnum];
+	thinker_t *thinker = pool->free;
+
+	pool->allocs++;
+
+	if (!thinker)
+		return Z_Calloc(pool->size, PU_LEVEL, NULL);
+
+	pool->free = thinker->next;
+	pool->numfree--;
+	pool->reused++;
+	memset(thinker, 0, pool->size);
+	return thinker;
+}
+
+void P_FreeThinkerMemory(thinker_t *thinker)
+{
+	mobjpooldata_t *pool;
+
+	if (thinker->pool == MOBJPOOL_NONE || thinker->pool >= NUMMOBJPOOLS)
+	{
+		Z_Free(thinker);
+		return;
+	}
+
+#ifdef HAVE_BLUA
+	// As Z_Free would; a Lua handle must not follow the memory to the next mobj
+	LUA_InvalidateUserdata(thinker);
+#endif
+
+	pool = &mobjpools[thinker->pool];
+	thinker->next = pool->free;
+	pool->free = thinker;
+	pool->returned++;
+	if (++pool->numfree > pool->maxfree)
+		pool->maxfree = pool->numfree;
+}
+
+void P_ClearMobjPools(void)
+{
+	INT32 i;
+
+	for (i = 0; i < NUMMOBJPOOLS; i++)
+	{
+		mobjpools[i].free = NULL;
+		mobjpools[i].numfree = 0;
+	}
+}
+
+//
+// Command_Mobjpool_f
+// Shows how much spawning is served by the pools.
+//
+void Command_Mobjpool_f(void)
+{
+	INT32 i;
+
+	if (COM_Argc() > 1 && !stricmp(COM_Argv(1), "reset"))
+	{
+		for (i = 1; i < NUMMOBJPOOLS; i++)
+		{
+			mobjpools[i].allocs = mobjpools[i].reused = mobjpools[i].returned = 0;
+			mobjpools[i].maxfree = mobjpools[i].numfree;
+		}
+		return;
+	}
+
+	for (i = 1; i < NUMMOBJPOOLS; i++)
+	{
+		const mobjpooldata_t *pool = &mobjpools[i];
+
+		CONS_Printf(M_GetText("%s: %u spawned, %u%% reused, %u freed, %u pooled now (%s KB), %u at most\n"),
+			pool->name, pool->allocs,
+			pool->allocs ? (UINT32)((UINT64)pool->reused * 100 / pool->allocs) : 0,
+			pool->returned, pool->numfree,
+			sizeu1((pool->numfree * pool->size) >> 10), pool->maxfree);
+	}
+}
+
 //
 // P_SpawnMobj
 //
@@ -9512,7 +9483,7 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 {
 	const mobjinfo_t *info = &mobjinfo[type];
 	state_t *st;
-	mobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+	mobj_t *mobj = P_AllocMobjMemory(MOBJPOOL_MOBJ);
 
 	// this is officially a mobj, declared as soon as possible.
 	mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
@@ -9894,7 +9865,7 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	}
 
 	if (!(mobj->flags & MF_NOTHINK))
-		P_AddThinker(&mobj->thinker); // Needs to come before the shadow spawn, or else the shadow's reference gets forgotten
+		P_AddThinker(THINK_MOBJ, &mobj->thinker); // Needs to come before the shadow spawn, or else the shadow's reference gets forgotten
 
 	switch (mobj->type)
 	{
@@ -9961,7 +9932,7 @@ mobj_t *P_SpawnShadowMobj(mobj_t * caster)
 {
 	const mobjinfo_t *info = &mobjinfo[MT_SHADOW];
 	state_t *st;
-	mobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+	mobj_t *mobj = P_AllocMobjMemory(MOBJPOOL_MOBJ);
 
 	// this is officially a mobj, declared as soon as possible.
 	mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
@@ -10030,7 +10001,7 @@ mobj_t *P_SpawnShadowMobj(mobj_t * caster)
 		mobj->eflags |= MFE_ONGROUND;
 
 	if (!(mobj->flags & MF_NOTHINK))
-		P_AddThinker(&mobj->thinker);
+		P_AddThinker(THINK_MOBJ, &mobj->thinker);
 
 	// Call action functions when the state is set
 	if (st->action.acp1 && (mobj->flags & MF_RUNSPAWNFUNC))
@@ -10068,71 +10039,6 @@ mobj_t *P_SpawnShadowMobj(mobj_t * caster)
 	return mobj;
 }
 
-static precipmobj_t *P_SpawnPrecipMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
-{
-	state_t *st;
-	precipmobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
-	fixed_t starting_floorz;
-
-	mobj->x = x;
-	mobj->y = y;
-	mobj->flags = mobjinfo[type].flags;
-
-	// do not set the state with P_SetMobjState,
-	// because action routines can not be called yet
-	st = &states[mobjinfo[type].spawnstate];
-
-	mobj->state = st;
-	mobj->tics = st->tics;
-	mobj->sprite = st->sprite;
-	mobj->frame = st->frame; // FF_FRAMEMASK for frame, and other bits..
-	mobj->anim_duration = (UINT16)st->var2; // only used if FF_ANIMATE is set
-
-	// set subsector and/or block links
-	P_SetPrecipitationThingPosition(mobj);
-
-	mobj->floorz = starting_floorz =
-				mobj->subsector->sector->f_slope ? P_GetZAt(mobj->subsector->sector->f_slope, x, y) :
-				mobj->subsector->sector->floorheight;
-	mobj->ceilingz =
-				mobj->subsector->sector->c_slope ? P_GetZAt(mobj->subsector->sector->c_slope, x, y) :
-				mobj->subsector->sector->ceilingheight;
-
-	mobj->z = z;
-	mobj->momz = mobjinfo[type].speed;
-
-	mobj->thinker.function.acp1 = (actionf_p1)P_NullPrecipThinker;
-	P_AddThinker(&mobj->thinker);
-
-	CalculatePrecipFloor(mobj);
-
-	if (mobj->floorz != starting_floorz)
-		mobj->precipflags |= PCF_FOF;
-	else if (GETSECSPECIAL(mobj->subsector->sector->special, 1) == 7
-	 || GETSECSPECIAL(mobj->subsector->sector->special, 1) == 6
-	 || mobj->subsector->sector->floorpic == skyflatnum)
-		mobj->precipflags |= PCF_PIT;
-
-	R_ResetPrecipitationMobjInterpolationState(mobj);
-
-	return mobj;
-}
-
-static inline precipmobj_t *P_SpawnRainMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
-{
-	precipmobj_t *mo = P_SpawnPrecipMobj(x,y,z,type);
-	mo->precipflags |= PCF_RAIN;
-	//mo->thinker.function.acp1 = (actionf_p1)P_RainThinker;
-	return mo;
-}
-
-static inline precipmobj_t *P_SpawnSnowMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
-{
-	precipmobj_t *mo = P_SpawnPrecipMobj(x,y,z,type);
-	//mo->thinker.function.acp1 = (actionf_p1)P_SnowThinker;
-	return mo;
-}
-
 //
 // P_RemoveMobj
 //
@@ -10157,6 +10063,8 @@ void P_RemoveMobj(mobj_t *mobj)
 	I_Assert(!P_MobjWasRemoved(mobj));
 #endif
 
+	blockmapepoch++; // let P_BlockThingsIterator know to check its next mobj
+
 	// Rings only, please!
 	if (mobj->spawnpoint &&
 		(mobj->type == MT_RING
@@ -10235,22 +10143,29 @@ void P_RemoveMobj(mobj_t *mobj)
 		}
 	}
 
+	// Before it can be freed, as this finds it by its index.
+	R_RemoveMobjInterpolator(mobj);
+
 	// free block
 	// DBG: set everything in mobj_t to 0xFF instead of leaving it. debug memory error.
 	if (mobj->flags & MF_NOTHINK && !mobj->thinker.next)
 	{ // Uh-oh, the mobj doesn't think, P_RemoveThinker would never go through!
-		if (!mobj->thinker.references)
+		if (!mobj->thinker.references && !blockthingsdepth) // P_BlockThingsIterator may still be looking at us
 		{
 #ifdef SCRAMBLE_REMOVED
 			// Invalidate mobj_t data to cause crashes if accessed!
 			memset(mobj, 0xff, sizeof(mobj_t));
 #endif
-			Z_Free(mobj); // No refrences? Can be removed immediately! :D
+			mobj->thinker.pool = MOBJPOOL_MOBJ;
+			P_FreeThinkerMemory(&mobj->thinker); // No refrences? Can be removed immediately! :D
 		}
 		else
 		{ // Add thinker just to delay removing it until refrences are gone.
+			INT32 references = mobj->thinker.references; // P_AddThinker zeroes it
 			mobj->flags &= ~MF_NOTHINK;
-			P_AddThinker((thinker_t *)mobj);
+			P_AddThinker(THINK_MOBJ, (thinker_t *)mobj);
+			mobj->thinker.references = references;
+			mobj->thinker.pool = MOBJPOOL_MOBJ;
 #ifdef SCRAMBLE_REMOVED
 			// Invalidate mobj_t data to cause crashes if accessed!
 			memset((UINT8 *)mobj + sizeof(thinker_t), 0xff, sizeof(mobj_t) - sizeof(thinker_t));
@@ -10264,10 +10179,9 @@ void P_RemoveMobj(mobj_t *mobj)
 		// Invalidate mobj_t data to cause crashes if accessed!
 		memset((UINT8 *)mobj + sizeof(thinker_t), 0xff, sizeof(mobj_t) - sizeof(thinker_t));
 #endif
+		mobj->thinker.pool = MOBJPOOL_MOBJ;
 		P_RemoveThinker((thinker_t *)mobj);
 	}
-
-	R_RemoveMobjInterpolator(mobj);
 }
 
 // This does not need to be added to Lua.
@@ -10279,46 +10193,19 @@ boolean P_MobjWasRemoved(mobj_t *mobj)
 	return true;
 }
 
-void P_RemovePrecipMobj(precipmobj_t *mobj)
-{
-	// unlink from sector and block lists
-	P_UnsetPrecipThingPosition(mobj);
-
-	if (precipsector_list)
-	{
-		P_DelPrecipSeclist(precipsector_list);
-		precipsector_list = NULL;
-	}
-
-	// free block
-	P_RemoveThinker((thinker_t *)mobj);
-}
-
 // Clearing out stuff for savegames
 void P_RemoveSavegameMobj(mobj_t *mobj)
 {
+	mobj->thinker.pool = MOBJPOOL_MOBJ;
+
 	// unlink from sector and block lists
-	if (((thinker_t *)mobj)->function.acp1 == (actionf_p1)P_NullPrecipThinker)
-	{
-		P_UnsetPrecipThingPosition((precipmobj_t *)mobj);
+	P_UnsetThingPosition(mobj);
 
-		if (precipsector_list)
-		{
-			P_DelPrecipSeclist(precipsector_list);
-			precipsector_list = NULL;
-		}
-	}
-	else
+	// Remove touching_sectorlist from mobj.
+	if (sector_list)
 	{
-		// unlink from sector and block lists
-		P_UnsetThingPosition(mobj);
-
-		// Remove touching_sectorlist from mobj.
-		if (sector_list)
-		{
-			P_DelSeclist(sector_list);
-			sector_list = NULL;
-		}
+		P_DelSeclist(sector_list);
+		sector_list = NULL;
 	}
 
 	// stop any playing sound
@@ -10331,7 +10218,7 @@ void P_RemoveSavegameMobj(mobj_t *mobj)
 		thinker_t *thinker = (thinker_t *)mobj;
 		thinker_t *next = thinker->next;
 		(next->prev = thinker->prev)->next = next;
-		Z_Free(thinker);
+		P_FreeThinkerMemory(thinker);
 	}
 }
 
@@ -10342,74 +10229,6 @@ static CV_PossibleValue_t flagtime_cons_t[] = {{0, "MIN"}, {300, "MAX"}, {0, NUL
 consvar_t cv_flagtime = {"flagtime", "30", CV_NETVAR|CV_CHEAT|CV_NOSHOWHELP, flagtime_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 consvar_t cv_suddendeath = {"suddendeath", "Off", CV_NETVAR|CV_CHEAT|CV_NOSHOWHELP, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 
-void P_SpawnPrecipitation(void)
-{
-	INT32 i, mrand;
-	fixed_t basex, basey, x, y, height;
-	subsector_t *precipsector = NULL;
-	precipmobj_t *rainmo = NULL;
-
-	if (dedicated || /*!cv_precipdensity*/!cv_drawdist_precip.value || curWeather == PRECIP_NONE) // SRB2Kart
-		return;
-
-	// Use the blockmap to narrow down our placing patterns
-	for (i = 0; i < bmapwidth*bmapheight; ++i)
-	{
-		basex = bmaporgx + (i % bmapwidth) * MAPBLOCKSIZE;
-		basey = bmaporgy + (i / bmapwidth) * MAPBLOCKSIZE;
-
-		//for (j = 0; j < cv_precipdensity.value; ++j) -- density is 1 for kart always
-		{
-			x = basex + ((M_RandomKey(MAPBLOCKUNITS<<3)<<FRACBITS)>>3);
-			y = basey + ((M_RandomKey(MAPBLOCKUNITS<<3)<<FRACBITS)>>3);
-
-			precipsector = R_IsPointInSubsector(x, y);
-
-			// No sector? Stop wasting time,
-			// move on to the next entry in the blockmap
-			if (!precipsector)
-				continue;
-
-			// Not in a sector with visible sky?
-			if (precipsector->sector->ceilingpic != skyflatnum)
-				continue;
-
-			// Exists, but is too small for reasonable precipitation.
-			if (!(precipsector->sector->floorheight <= precipsector->sector->ceilingheight - (32<<FRACBITS)))
-				continue;
-
-			// Don't set height yet...
-			height = precipsector->sector->ceilingheight;
-
-			if (curWeather == PRECIP_SNOW)
-			{
-				rainmo = P_SpawnSnowMobj(x, y, height, MT_SNOWFLAKE);
-				mrand = M_RandomByte();
-				if (mrand < 64)
-					P_SetPrecipMobjState(rainmo, S_SNOW3);
-				else if (mrand < 144)
-					P_SetPrecipMobjState(rainmo, S_SNOW2);
-			}
-			else // everything else.
-				rainmo = P_SpawnRainMobj(x, y, height, MT_RAIN);
-
-			// Randomly assign a height, now that floorz is set.
-			rainmo->z = M_RandomRange(rainmo->floorz>>FRACBITS, rainmo->ceilingz>>FRACBITS)<<FRACBITS;
-		}
-	}
-
-	if (curWeather == PRECIP_BLANK)
-	{
-		curWeather = PRECIP_RAIN;
-		P_SwitchWeather(PRECIP_BLANK);
-	}
-	else if (curWeather == PRECIP_STORM_NORAIN)
-	{
-		curWeather = PRECIP_RAIN;
-		P_SwitchWeather(PRECIP_STORM_NORAIN);
-	}
-}
-
 //
 // P_PrecipitationEffects
 //
@@ -10546,7 +10365,7 @@ void P_RespawnSpecials(void)
 	{
 		thinker_t *th;
 
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			mobj_t *box;
 			mobj_t *newmobj;
@@ -11676,7 +11495,7 @@ ML_NOCLIMB : Direction not controllable
 		mobj->health = (mthing->angle / 360) + 1;
 
 		// See if other starposts exist in this level that have the same value.
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -249,23 +249,6 @@ typedef enum
 	// free: to and including 1<<15
 } mobjeflag_t;
 
-//
-// PRECIPITATION flags ?! ?! ?!
-//
-typedef enum {
-	// Don't draw.
-	PCF_INVISIBLE = 1,
-	// Above pit.
-	PCF_PIT = 2,
-	// Above FOF.
-	PCF_FOF = 4,
-	// Above MOVING FOF (this means we need to keep floorz up to date...)
-	PCF_MOVINGFOF = 8,
-	// Is rain.
-	PCF_RAIN = 16,
-	// Ran the thinker this tic.
-	PCF_THUNK = 32,
-} precipflag_t;
 // Map Object definition.
 typedef struct mobj_s
 {
@@ -377,61 +360,12 @@ typedef struct mobj_s
 	struct pslope_s *standingslope; // The slope that the object is standing on (shouldn't need synced in savegames, right?)
 
 	boolean resetinterp; // if true, some fields should not be interpolated (see R_InterpolateMobjState implementation)
+	size_t interpindex; // where its interpolation state is kept (see r_fps.c), not synced
 	boolean colorized; // Whether the mobj uses the rainbow colormap
 
 	// WARNING: New fields must be added separately to savegame and Lua.
 } mobj_t;
 
-//
-// For precipitation
-//
-// Sometimes this is casted to a mobj_t,
-// so please keep the start of the
-// structure the same.
-//
-typedef struct precipmobj_s
-{
-	// List: thinker links.
-	thinker_t thinker;
-
-	// Info for drawing: position.
-	fixed_t x, y, z;
-	fixed_t old_x, old_y, old_z; // position interpolation
-	fixed_t old_x2, old_y2, old_z2;
-
-	// More list: links in sector (if needed)
-	struct precipmobj_s *snext;
-	struct precipmobj_s **sprev; // killough 8/11/98: change to ptr-to-ptr
-
-	// More drawing info: to determine current sprite.
-	angle_t angle;  // orientation
-	angle_t old_angle; // orientation interpolation
-	angle_t old_angle2;
-	spritenum_t sprite; // used to find patch_t and flip value
-	UINT32 frame; // frame number, plus bits see p_pspr.h
-	UINT16 anim_duration; // for FF_ANIMATE states
-
-	struct mprecipsecnode_s *touching_sectorlist; // a linked list of sectors where this object appears
-
-	struct subsector_s *subsector; // Subsector the mobj resides in.
-
-	// The closest interval over all contacted sectors (or things).
-	fixed_t floorz; // Nearest floor below.
-	fixed_t ceilingz; // Nearest ceiling above.
-
-	// For movement checking.
-	fixed_t radius; // Fixed at 2*FRACUNIT
-	fixed_t height; // Fixed at 4*FRACUNIT
-
-	// Momentums, used to update position.
-	fixed_t momx, momy, momz;
-	fixed_t precipflags; // fixed_t so it uses the same spot as "pmomz" even as we use precipflags_t for it
-
-	INT32 tics; // state tic counter
-	state_t *state;
-	INT32 flags; // flags from mobjinfo tables
-} precipmobj_t;
-
 typedef struct actioncache_s
 {
 	struct actioncache_s *next;
@@ -460,15 +394,24 @@ void P_AfterPlayerSpawn(INT32 playernum);
 void P_SpawnMapThing(mapthing_t *mthing);
 void P_SpawnHoopsAndRings(mapthing_t *mthing);
 void P_SpawnHoopOfSomething(fixed_t x, fixed_t y, fixed_t z, fixed_t radius, INT32 number, mobjtype_t type, angle_t rotangle);
-void P_SpawnPrecipitation(void);
 void P_SpawnParaloop(fixed_t x, fixed_t y, fixed_t z, fixed_t radius, INT32 number, mobjtype_t type, statenum_t nstate, angle_t rotangle, boolean spawncenter);
 boolean P_BossTargetPlayer(mobj_t *actor, boolean closest);
 boolean P_SupermanLook4Players(mobj_t *actor);
 void P_DestroyRobots(void);
-void P_SnowThinker(precipmobj_t *mobj);
-void P_RainThinker(precipmobj_t *mobj);
-void P_NullPrecipThinker(precipmobj_t *mobj);
-void P_RemovePrecipMobj(precipmobj_t *mobj);
+
+// Freed mobjs are kept for reuse rather than going
+// back to the zone, so short-lived effects don't churn it.
+typedef enum
+{
+	MOBJPOOL_NONE,
+	MOBJPOOL_MOBJ,
+	NUMMOBJPOOLS
+} mobjpool_t;
+
+void *P_AllocMobjMemory(mobjpool_t pool);
+void P_FreeThinkerMemory(thinker_t *thinker);
+void P_ClearMobjPools(void);
+void Command_Mobjpool_f(void);
 void P_SetScale(mobj_t *mobj, fixed_t newscale);
 void P_XYMovement(mobj_t *mo);
 void P_EmeraldManager(void);
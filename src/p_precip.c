@@ -0,0 +1,423 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2020 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  p_precip.c
+/// \brief Rain and snow particles
+
+#include "p_precip.h"
+#include "doomstat.h"
+#include "g_game.h" // players
+#include "p_local.h"
+#include "p_slopes.h"
+#include "r_main.h" // cv_drawdist_precip
+#include "r_sky.h"
+#include "m_random.h"
+#include "z_zone.h"
+
+precippool_t precip;
+
+// All the arrays share one PU_LEVEL block, see P_AllocPrecipitation.
+static UINT8 *precipblock;
+static size_t precipmax;
+
+#define PRECIPPARTICLESIZE (2*sizeof (void *) + 6*sizeof (fixed_t) + sizeof (INT32) + sizeof (UINT32) + sizeof (UINT16) + sizeof (UINT8))
+
+static void P_AllocPrecipitation(size_t count)
+{
+	UINT8 *p;
+
+	if (count <= precipmax)
+		return;
+
+	if (precipblock)
+		Z_Free(precipblock);
+
+	precipmax = count;
+	p = precipblock = Z_Malloc(count * PRECIPPARTICLESIZE, PU_LEVEL, NULL);
+
+	// Widest first, so each array stays aligned
+	precip.subsector = (subsector_t **)p; p += count * sizeof (*precip.subsector);
+	precip.state = (state_t **)p;         p += count * sizeof (*precip.state);
+	precip.z = (fixed_t *)p;              p += count * sizeof (*precip.z);
+	precip.oldz = (fixed_t *)p;           p += count * sizeof (*precip.oldz);
+	precip.floorz = (fixed_t *)p;         p += count * sizeof (*precip.floorz);
+	precip.ceilingz = (fixed_t *)p;       p += count * sizeof (*precip.ceilingz);
+	precip.x = (fixed_t *)p;              p += count * sizeof (*precip.x);
+	precip.y = (fixed_t *)p;              p += count * sizeof (*precip.y);
+	precip.tics = (INT32 *)p;             p += count * sizeof (*precip.tics);
+	precip.frame = (UINT32 *)p;           p += count * sizeof (*precip.frame);
+	precip.anim_duration = (UINT16 *)p;   p += count * sizeof (*precip.anim_duration);
+	precip.flags = (UINT8 *)p;
+}
+
+// Not drawn, and held in place by P_RunPrecipitation, until it wraps somewhere else.
+static void P_SetPrecipDormant(size_t i)
+{
+	precip.subsector[i] = NULL;
+	precip.z[i] = precip.oldz[i] = precip.floorz[i] = 0;
+}
+
+static boolean P_SetPrecipState(size_t i, statenum_t state)
+{
+	state_t *st;
+
+	if (state == S_NULL)
+	{
+		// Gone until it wraps around to somewhere new
+		P_SetPrecipDormant(i);
+		return false;
+	}
+
+	st = &states[state];
+	precip.state[i] = st;
+	precip.tics[i] = st->tics;
+	precip.frame[i] = st->frame;
+	precip.anim_duration[i] = (UINT16)st->var2; // only used if FF_ANIMATE is set
+
+	return true;
+}
+
+static void P_SetPrecipSpawnState(size_t i)
+{
+	statenum_t state = mobjinfo[precip.type].spawnstate;
+
+	if (precip.type == MT_SNOWFLAKE)
+	{
+		INT32 mrand = M_RandomByte();
+		if (mrand < 64)
+			state = S_SNOW3;
+		else if (mrand < 144)
+			state = S_SNOW2;
+	}
+
+	P_SetPrecipState(i, state);
+}
+
+// Floor is the highest of the sector's floor and anything solid or
+// swimmable in it, as it gets rained on.
+static void P_CalcPrecipHeights(size_t i)
+{
+	const sector_t *sec = precip.subsector[i]->sector;
+	const fixed_t x = precip.x[i], y = precip.y[i];
+	const fixed_t sectorfloorz = sec->f_slope ? P_GetZAt(sec->f_slope, x, y) : sec->floorheight;
+	fixed_t floorz = sectorfloorz;
+	ffloor_t *rover;
+
+	for (rover = sec->ffloors; rover; rover = rover->next)
+	{
+		fixed_t topheight;
+
+		if (!(rover->flags & FF_EXISTS))
+			continue;
+
+		if (!(rover->flags & FF_BLOCKOTHERS) && !(rover->flags & FF_SWIMMABLE))
+			continue;
+
+		topheight = *rover->t_slope ? P_GetZAt(*rover->t_slope, x, y) : *rover->topheight;
+		if (topheight > floorz)
+			floorz = topheight;
+	}
+
+	precip.floorz[i] = floorz;
+	precip.ceilingz[i] = sec->c_slope ? P_GetZAt(sec->c_slope, x, y) : sec->ceilingheight;
+
+	precip.flags[i] = 0;
+	if (floorz == sectorfloorz
+	&& (GETSECSPECIAL(sec->special, 1) == 7
+	 || GETSECSPECIAL(sec->special, 1) == 6
+	 || sec->floorpic == skyflatnum))
+		precip.flags[i] |= PCF_PIT;
+}
+
+// Finds what a particle at a new x and y is over, and picks it a height.
+static void P_PlacePrecipParticle(size_t i)
+{
+	subsector_t *ss = R_IsPointInSubsector(precip.x[i], precip.y[i]);
+
+	// Not in a sector with visible sky?
+	if (!ss || ss->sector->ceilingpic != skyflatnum)
+	{
+		P_SetPrecipDormant(i);
+		return;
+	}
+
+	// Exists, but is too small for reasonable precipitation.
+	if (ss->sector->floorheight > ss->sector->ceilingheight - (32<<FRACBITS))
+	{
+		P_SetPrecipDormant(i);
+		return;
+	}
+
+	precip.subsector[i] = ss;
+	P_CalcPrecipHeights(i);
+
+	if (precip.floorz[i] >= precip.ceilingz[i])
+	{
+		P_SetPrecipDormant(i);
+		return;
+	}
+
+	// Don't bring a splash along
+	if (precip.tics[i] != -1)
+		P_SetPrecipSpawnState(i);
+
+	// Anywhere between the floor and the sky, so new ones don't all start at the top
+	precip.z[i] = precip.oldz[i] = M_RandomRange(precip.floorz[i]>>FRACBITS, precip.ceilingz[i]>>FRACBITS)<<FRACBITS;
+}
+
+// Where a view's weather is centered.
+static boolean P_GetPrecipCamera(UINT8 view, fixed_t *x, fixed_t *y)
+{
+	player_t *player = &players[displayplayers[view]];
+
+	if (player->awayviewtics && player->awayviewmobj && !P_MobjWasRemoved(player->awayviewmobj))
+	{
+		*x = player->awayviewmobj->x;
+		*y = player->awayviewmobj->y;
+	}
+	else if (camera[view].chase)
+	{
+		*x = camera[view].x;
+		*y = camera[view].y;
+	}
+	else if (player->mo && !P_MobjWasRemoved(player->mo))
+	{
+		*x = player->mo->x;
+		*y = player->mo->y;
+	}
+	else
+		return false;
+
+	return true;
+}
+
+// Moves whatever is out of the camera's square across to the other side,
+// keeping its place in the grid, so the square stays evenly filled.
+static void P_WrapPrecipitation(UINT8 view)
+{
+	const INT64 size = 2 * (INT64)precip.radius;
+	const fixed_t left = precip.centerx[view] - precip.radius;
+	const fixed_t bottom = precip.centery[view] - precip.radius;
+	size_t i = view * precip.percamera;
+	const size_t end = i + precip.percamera;
+
+	for (; i < end; i++)
+	{
+		INT64 dx = (INT64)precip.x[i] - left;
+		INT64 dy = (INT64)precip.y[i] - bottom;
+
+		if (dx >= 0 && dx < size && dy >= 0 && dy < size)
+			continue;
+
+		dx %= size;
+		if (dx < 0)
+			dx += size;
+		dy %= size;
+		if (dy < 0)
+			dy += size;
+
+		precip.x[i] = left + (fixed_t)dx;
+		precip.y[i] = bottom + (fixed_t)dy;
+		P_PlacePrecipParticle(i);
+	}
+}
+
+//
+// P_SpawnPrecipitation
+//
+// Fills every view's square with one particle per blockmap sized cell,
+// at a random spot in it.
+//
+void P_SpawnPrecipitation(void)
+{
+	const INT32 cells = 2 * cv_drawdist_precip.value / MAPBLOCKUNITS;
+	size_t i;
+	INT32 cell;
+	UINT8 view;
+
+	P_RemovePrecipitation();
+
+	precip.radius = cv_drawdist_precip.value << FRACBITS;
+	precip.numcameras = (UINT8)(splitscreen + 1);
+
+	if (dedicated || /*!cv_precipdensity*/!cv_drawdist_precip.value || curWeather == PRECIP_NONE) // SRB2Kart
+		return;
+
+	precip.percamera = cells * cells;
+	precip.count = precip.percamera * precip.numcameras;
+	P_AllocPrecipitation(precip.count);
+
+	precip.type = (curWeather == PRECIP_SNOW) ? MT_SNOWFLAKE : MT_RAIN;
+	precip.momz = mobjinfo[precip.type].speed;
+	precip.hidden = false;
+
+	for (view = 0, i = 0; view < precip.numcameras; view++)
+	{
+		// No camera yet? The first tic wraps it all over to it.
+		if (!P_GetPrecipCamera(view, &precip.centerx[view], &precip.centery[view]))
+			precip.centerx[view] = precip.centery[view] = 0;
+
+		for (cell = 0; cell < cells * cells; cell++, i++)
+		{
+			precip.x[i] = precip.centerx[view] - precip.radius + (cell % cells) * MAPBLOCKSIZE
+				+ ((M_RandomKey(MAPBLOCKUNITS<<3)<<FRACBITS)>>3);
+			precip.y[i] = precip.centery[view] - precip.radius + (cell / cells) * MAPBLOCKSIZE
+				+ ((M_RandomKey(MAPBLOCKUNITS<<3)<<FRACBITS)>>3);
+
+			P_SetPrecipSpawnState(i);
+			P_PlacePrecipParticle(i);
+		}
+	}
+
+	if (curWeather == PRECIP_BLANK)
+	{
+		curWeather = PRECIP_RAIN;
+		P_SwitchWeather(PRECIP_BLANK);
+	}
+	else if (curWeather == PRECIP_STORM_NORAIN)
+	{
+		curWeather = PRECIP_RAIN;
+		P_SwitchWeather(PRECIP_STORM_NORAIN);
+	}
+}
+
+//
+// P_SetPrecipitationType
+//
+// Turns rain into snow or the other way around, without respawning it.
+//
+void P_SetPrecipitationType(mobjtype_t type)
+{
+	size_t i;
+
+	precip.type = type;
+	precip.momz = mobjinfo[type].speed;
+	precip.hidden = false;
+
+	for (i = 0; i < precip.count; i++)
+		P_SetPrecipSpawnState(i);
+}
+
+void P_RemovePrecipitation(void)
+{
+	precip.count = 0;
+}
+
+// The block went with the rest of the level.
+void P_ClearPrecipitation(void)
+{
+	precipblock = NULL;
+	precipmax = 0;
+	precip.count = 0;
+}
+
+void P_RecalcPrecipInSector(sector_t *sector)
+{
+	size_t i;
+
+	if (!sector)
+		return;
+
+	sector->moved = true; // Recalc lighting and things too, maybe
+
+	for (i = 0; i < precip.count; i++)
+		if (precip.subsector[i] && precip.subsector[i]->sector == sector)
+			P_CalcPrecipHeights(i);
+}
+
+// For the particles the bulk fall in P_RunPrecipitation isn't all of:
+// splashing, animated, or on the floor.
+static void P_PrecipParticleThink(size_t i)
+{
+	// Same as P_CycleStateAnimation
+	if ((precip.frame[i] & FF_ANIMATE) && --precip.anim_duration[i] == 0)
+	{
+		const state_t *st = precip.state[i];
+
+		precip.anim_duration[i] = (UINT16)st->var2;
+		if (((++precip.frame[i]) & FF_FRAMEMASK) - (st->frame & FF_FRAMEMASK) > (UINT32)st->var1)
+			precip.frame[i] = (st->frame & FF_FRAMEMASK) | (precip.frame[i] & ~FF_FRAMEMASK);
+	}
+
+	if (precip.tics[i] != -1)
+	{
+		// Splashes stay put while they cycle through their states
+		precip.z[i] = precip.oldz[i];
+
+		if (precip.tics[i] <= 0 || --precip.tics[i])
+			return;
+
+		if (!P_SetPrecipState(i, precip.state[i]->nextstate))
+			return;
+
+		if (precip.state[i] != &states[S_RAINRETURN])
+			return;
+
+		precip.z[i] = precip.oldz[i] = precip.ceilingz[i];
+		P_SetPrecipState(i, S_RAIN1);
+		return;
+	}
+
+	if (precip.z[i] > precip.floorz[i])
+		return;
+
+	// no splashes for snow, or on sky or bottomless pits
+	if (precip.type == MT_RAIN && !(precip.flags[i] & PCF_PIT))
+	{
+		precip.z[i] = precip.floorz[i];
+		P_SetPrecipState(i, S_SPLASH1);
+	}
+	else
+		precip.z[i] = precip.oldz[i] = precip.ceilingz[i];
+}
+
+//
+// P_RunPrecipitation
+//
+// Moves the weather on by a tic. Called once a tic, before any view draws it,
+// so the renderers only ever read the particles.
+//
+void P_RunPrecipitation(void)
+{
+	size_t i;
+	UINT8 view;
+
+	if (dedicated || curWeather == PRECIP_NONE)
+		return;
+
+	// The draw distance or the number of views changed
+	if (precip.radius != cv_drawdist_precip.value << FRACBITS || precip.numcameras != splitscreen + 1)
+	{
+		P_SpawnPrecipitation();
+		return;
+	}
+
+	if (!precip.count || precip.hidden)
+		return;
+
+	for (view = 0; view < precip.numcameras; view++)
+		if (P_GetPrecipCamera(view, &precip.centerx[view], &precip.centery[view]))
+			P_WrapPrecipitation(view);
+
+	// Everything falls at once
+	M_Memcpy(precip.oldz, precip.z, precip.count * sizeof (*precip.z));
+	for (i = 0; i < precip.count; i++)
+		precip.z[i] += precip.momz;
+
+	// Then only the few that need it go further
+	for (i = 0; i < precip.count; i++)
+	{
+		if (precip.z[i] > precip.floorz[i] && precip.tics[i] == -1 && !(precip.frame[i] & FF_ANIMATE))
+			continue;
+
+		if (precip.subsector[i])
+			P_PrecipParticleThink(i);
+		else
+			precip.z[i] = precip.oldz[i]; // dormant, see P_SetPrecipDormant
+	}
+}
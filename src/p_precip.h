@@ -0,0 +1,65 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2020 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  p_precip.h
+/// \brief Rain and snow particles
+
+#ifndef __P_PRECIP_H__
+#define __P_PRECIP_H__
+
+#include "doomdef.h"
+#include "doomstat.h" // MAXSPLITSCREENPLAYERS
+#include "info.h"
+#include "r_defs.h"
+
+// Particle flags
+typedef enum
+{
+	PCF_PIT = 1, // above a pit or sky floor, so no splash
+} precipflag_t;
+
+//
+// Every view has a square of weather around its camera, as wide as twice
+// the precipitation draw distance, with a particle in each blockmap sized
+// cell of it. A particle that falls out of the square as the camera moves
+// wraps to the opposite edge, into the ring the camera is heading for.
+// Particles aren't mobjs or thinkers; the pool is kept as parallel arrays
+// so the per-tic fall is one pass over the heights.
+//
+typedef struct
+{
+	size_t count; // percamera * numcameras
+	size_t percamera;
+	UINT8 numcameras;
+	fixed_t radius; // half the width of each camera's square
+	fixed_t centerx[MAXSPLITSCREENPLAYERS], centery[MAXSPLITSCREENPLAYERS];
+
+	mobjtype_t type; // MT_RAIN or MT_SNOWFLAKE, for every particle
+	fixed_t momz;
+	boolean hidden; // PRECIP_BLANK and PRECIP_STORM_NORAIN keep it for later
+
+	fixed_t *z, *oldz; // oldz is where it was last tic, for interpolation
+	fixed_t *floorz, *ceilingz;
+	fixed_t *x, *y;
+	subsector_t **subsector; // NULL if not under the sky, and not drawn
+	state_t **state;
+	INT32 *tics;
+	UINT32 *frame;
+	UINT16 *anim_duration;
+	UINT8 *flags; // precipflag_t
+} precippool_t;
+
+extern precippool_t precip;
+
+void P_SpawnPrecipitation(void);
+void P_SetPrecipitationType(mobjtype_t type);
+void P_RemovePrecipitation(void);
+void P_ClearPrecipitation(void);
+void P_RunPrecipitation(void);
+
+#endif
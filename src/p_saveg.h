@@ -28,6 +28,21 @@ boolean P_LoadNetGame(void);
 
 mobj_t *P_FindNewPosition(UINT32 oldposition);
 
+// Sections of a netgame save, in the order P_SaveNetGame writes them.
+// Joining clients may get each one as a delta against an older save.
+typedef enum
+{
+	NETSAVE_MISC, // netvars, misc
+	NETSAVE_PLAYERS,
+	NETSAVE_WORLD, // world, polyobjects
+	NETSAVE_THINKERS, // thinkers, specials
+	NETSAVE_LUA, // Lua, consistency marker
+	NUMNETSAVESECTIONS
+} netsavesection_t;
+
+// Where each section starts in the buffer written by the last P_SaveNetGame.
+extern UINT8 *netsavesections[NUMNETSAVESECTIONS];
+
 typedef struct
 {
 	UINT8 skincolor;
@@ -713,8 +713,6 @@ static void P_LoadRawSectors(UINT8 *data, size_t i)
 
 		ss->thinglist = NULL;
 		ss->touching_thinglist = NULL;
-		ss->preciplist = NULL;
-		ss->touching_preciplist = NULL;
 
 		ss->floordata = NULL;
 		ss->ceilingdata = NULL;
@@ -835,7 +833,7 @@ void P_ReloadRings(void)
 	mapthing_t *mt = mapthings;
 
 	// scan the thinkers to find rings/wings/hoops to unset
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -2447,7 +2445,7 @@ void P_LoadThingsOnly(void)
 	mobj_t *mo;
 	thinker_t *think;
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
 	{
 		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -2801,6 +2799,83 @@ static boolean P_CanSave(void)
 #endif
 }
 
+//
+// Level load timing, one entry per stage of P_SetupLevel.
+// Printed with DBG_SETUP after every load, and by the loadtimes command.
+//
+#define MAXLOADSTAGES 16
+
+static struct
+{
+	const char *name;
+	precise_t time;
+} loadstages[MAXLOADSTAGES];
+static size_t numloadstages;
+static precise_t loadstagemark;
+
+static void P_StartLoadStages(void)
+{
+	numloadstages = 0;
+	loadstagemark = I_GetPreciseTime();
+}
+
+// Ends the stage running since the last call.
+static void P_EndLoadStage(const char *name)
+{
+	precise_t now = I_GetPreciseTime();
+
+	if (numloadstages < MAXLOADSTAGES)
+	{
+		loadstages[numloadstages].name = name;
+		loadstages[numloadstages].time = now - loadstagemark;
+		numloadstages++;
+	}
+	loadstagemark = now;
+}
+
+static void P_PrintLoadStages(boolean debug)
+{
+	precise_t total = 0;
+	double scale = 1000.0 / I_GetPrecisePrecision();
+	size_t i;
+
+	for (i = 0; i < numloadstages; i++)
+	{
+		if (debug)
+			CONS_Debug(DBG_SETUP, "%-16s %8.2f ms\n", loadstages[i].name, loadstages[i].time * scale);
+		else
+			CONS_Printf("%-16s %8.2f ms\n", loadstages[i].name, loadstages[i].time * scale);
+		total += loadstages[i].time;
+	}
+
+	if (debug)
+		CONS_Debug(DBG_SETUP, "%-16s %8.2f ms\n", "total", total * scale);
+	else
+		CONS_Printf("%-16s %8.2f ms\n", "total", total * scale);
+}
+
+void Command_Loadtimes_f(void)
+{
+	if (!numloadstages)
+	{
+		CONS_Printf(M_GetText("No level has been loaded yet.\n"));
+		return;
+	}
+
+	CONS_Printf(M_GetText("Last level load (%s):\n"), G_BuildMapName(gamemap));
+	P_PrintLoadStages(false);
+}
+
+// Starts inflating the graphics the level is about to use in the
+// background. Only the wall textures and flats are known this early.
+static void P_PrefetchLevelGraphics(void)
+{
+	if (rendermode == render_none || M_CheckParm("-noprefetch"))
+		return;
+
+	R_PrefetchLevelTextures();
+}
+
 /** Loads a level from a lump or external wad.
   *
   * \param skipprecip If true, don't spawn precipitation.
@@ -2819,6 +2894,7 @@ boolean P_SetupLevel(boolean skipprecip)
 	boolean chase;
 
 	levelloading = true;
+	P_StartLoadStages();
 
 	// This is needed. Don't touch.
 	maptol = mapheaderinfo[gamemap-1]->typeoflevel;
@@ -2981,6 +3057,8 @@ boolean P_SetupLevel(boolean skipprecip)
 		I_UpdateNoVsync();
 	}*/
 
+	P_EndLoadStage("fade");
+
 #ifdef HAVE_BLUA
 	LUA_InvalidateLevel();
 #endif
@@ -2992,9 +3070,15 @@ boolean P_SetupLevel(boolean skipprecip)
 	}
 
 	// Clear pointers that would be left dangling by the purge
-	R_FlushTranslationColormapCache();
+	R_ResetTranslationColormapCache();
 
 	Z_FreeTags(PU_LEVEL, PU_PURGELEVEL - 1);
+	P_ClearMobjPools(); // whatever was in them went with the purge
+	P_ClearPrecipitation();
+
+	// Build the players' colormaps while the rest of the level loads
+	if (!dedicated)
+		R_PrebuildTranslationColormaps();
 
 #if defined (WALLSPLATS) || defined (FLOORSPLATS)
 	// clear the splats from previous level
@@ -3007,6 +3091,8 @@ boolean P_SetupLevel(boolean skipprecip)
 	R_InitMobjInterpolators();
 	P_InitCachedActions();
 
+	P_EndLoadStage("purge");
+
 	/// \note for not spawning precipitation, etc. when loading netgame snapshots
 	if (skipprecip)
 	{
@@ -3075,6 +3161,10 @@ boolean P_SetupLevel(boolean skipprecip)
 		{
 			rejectmatrix = NULL;
 		}
+		P_EndLoadStage("map lumps");
+
+		P_PrefetchLevelGraphics();
+		P_EndLoadStage("prefetch queue");
 
 		// Important: take care of the ordering of the next functions.
 		if (!loadedbm)
@@ -3106,6 +3196,10 @@ boolean P_SetupLevel(boolean skipprecip)
 		P_LoadNodes(lastloadedmaplumpnum + ML_NODES);
 		P_LoadSegs(lastloadedmaplumpnum + ML_SEGS);
 		P_LoadReject(lastloadedmaplumpnum + ML_REJECT);
+		P_EndLoadStage("map lumps");
+
+		P_PrefetchLevelGraphics();
+		P_EndLoadStage("prefetch queue");
 
 		// Important: take care of the ordering of the next functions.
 		if (!loadedbm)
@@ -3124,12 +3218,19 @@ boolean P_SetupLevel(boolean skipprecip)
 		P_PrepareThings(lastloadedmaplumpnum + ML_THINGS);
 	}
 
+	P_EndLoadStage("geometry");
+
 	P_ResetDynamicSlopes();
 
 	P_LoadThings();
 
 	P_SpawnSecretItems(loademblems);
 
+	if (rendermode != render_none && !M_CheckParm("-noprefetch"))
+		R_PrefetchLevelSprites();
+
+	P_EndLoadStage("things");
+
 	for (numcoopstarts = 0; numcoopstarts < MAXPLAYERS; numcoopstarts++)
 		if (!playerstarts[numcoopstarts])
 			break;
@@ -3142,6 +3243,8 @@ boolean P_SetupLevel(boolean skipprecip)
 	if (loadprecip) //  ugly hack for P_NetUnArchiveMisc (and P_LoadNetGame)
 		P_SpawnPrecipitation();
 
+	P_EndLoadStage("specials");
+
 #ifdef HWRENDER // not win32 only 19990829 by Kin
 	if (rendermode != render_soft && rendermode != render_none)
 	{
@@ -3149,6 +3252,7 @@ boolean P_SetupLevel(boolean skipprecip)
 		HWR_CorrectSWTricks();
 		HWR_CreatePlanePolygons((INT32)numnodes - 1);
 	}
+	P_EndLoadStage("polygons");
 #endif
 
 	// oh god I hope this helps
@@ -3282,6 +3386,8 @@ boolean P_SetupLevel(boolean skipprecip)
 	// landing point for netgames.
 	netgameskip:
 
+	P_EndLoadStage("players");
+
 	if (!dedicated)
 	{
 		if (!demo.freecam)
@@ -3370,8 +3476,15 @@ boolean P_SetupLevel(boolean skipprecip)
 	if (rendermode != render_none)
 		V_DrawFill(0, 0, BASEVIDWIDTH, BASEVIDHEIGHT, levelfadecol);
 
+	P_EndLoadStage("cache prep");
+
 	if (precache || dedicated)
 		R_PrecacheLevel();
+	P_EndLoadStage("precache");
+
+	// Anything prefetched but not used yet goes into the cache as is.
+	W_FinishPrefetch();
+	P_EndLoadStage("prefetch wait");
 
 	nextmapoverride = 0;
 	skipstats = false;
@@ -3418,6 +3531,9 @@ boolean P_SetupLevel(boolean skipprecip)
 
 	G_AddMapToBuffer(gamemap-1);
 
+	P_EndLoadStage("map start");
+	P_PrintLoadStages(true);
+
 	return true;
 }
 
@@ -3644,6 +3760,7 @@ boolean P_MultiSetupWadFiles(boolean fullsetup)
 	{
 		partadd_important = false;
 		partadd_replacescurrentmap = false;
+		W_FlushMD5Cache(); // the batch of addons is in
 		return true;
 	}
 	else
@@ -87,6 +87,7 @@ SINT8 P_PartialAddGetStage(void);
 boolean P_RunSOC(const char *socfilename);
 void P_WriteThings(lumpnum_t lump);
 size_t P_PrecacheLevelFlats(void);
+void Command_Loadtimes_f(void);
 void P_AllocMapHeader(INT16 i);
 
 // Needed for NiGHTS
@@ -28,6 +28,9 @@ extern mobj_t *skyboxmo[2];
 // at game start
 void P_InitPicAnims(void);
 
+// at map load (textures)
+void P_MarkAnimatedTextures(char *present);
+
 // at map load (sectors)
 void P_SetupLevelFlatAnims(void);
 
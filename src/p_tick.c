@@ -26,6 +26,8 @@
 #include "r_main.h"
 #include "r_fps.h"
 #include "i_video.h" // rendermode
+#include "i_system.h" // I_GetPreciseTime
+#include "d_main.h" // srb2home
 
 // Object place
 #include "m_cheat.h"
@@ -40,12 +42,12 @@ tic_t leveltime;
 // but the first element must be thinker_t.
 //
 
-// Both the head and tail of the thinker list.
-thinker_t thinkercap;
+// Both the head and tail of each thinker list.
+thinker_t thlist[NUM_THINKERLISTS];
 
 void Command_Numthinkers_f(void)
 {
-	INT32 num;
+	INT32 num, i;
 	INT32 count = 0;
 	actionf_p1 action;
 	thinker_t *think;
@@ -63,10 +65,9 @@ void Command_Numthinkers_f(void)
 			"\t1: P_MobjThinker\n"
 			/*"\t2: P_RainThinker\n"
 			"\t3: P_SnowThinker\n"*/
-			"\t2: P_NullPrecipThinker\n"
-			"\t3: T_Friction\n"
-			"\t4: T_Pusher\n"
-			"\t5: P_RemoveThinkerDelayed\n");
+			"\t2: T_Friction\n"
+			"\t3: T_Pusher\n"
+			"\t4: P_RemoveThinkerDelayed\n");
 		return;
 	}
 
@@ -87,18 +88,14 @@ void Command_Numthinkers_f(void)
 			CONS_Printf(M_GetText("Number of %s: "), "P_SnowThinker");
 			break;*/
 		case 2:
-			action = (actionf_p1)P_NullPrecipThinker;
-			CONS_Printf(M_GetText("Number of %s: "), "P_NullPrecipThinker");
-			break;
-		case 3:
 			action = (actionf_p1)T_Friction;
 			CONS_Printf(M_GetText("Number of %s: "), "T_Friction");
 			break;
-		case 4:
+		case 3:
 			action = (actionf_p1)T_Pusher;
 			CONS_Printf(M_GetText("Number of %s: "), "T_Pusher");
 			break;
-		case 5:
+		case 4:
 			action = (actionf_p1)P_RemoveThinkerDelayed;
 			CONS_Printf(M_GetText("Number of %s: "), "P_RemoveThinkerDelayed");
 			break;
@@ -107,13 +104,14 @@ void Command_Numthinkers_f(void)
 			return;
 	}
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
-	{
-		if (think->function.acp1 != action)
-			continue;
+	for (i = 0; i < NUM_THINKERLISTS; i++)
+		for (think = thlist[i].next; think != &thlist[i]; think = think->next)
+		{
+			if (think->function.acp1 != action)
+				continue;
 
-		count++;
-	}
+			count++;
+		}
 
 	CONS_Printf("%d\n", count);
 }
@@ -144,7 +142,7 @@ void Command_CountMobjs_f(void)
 
 			count = 0;
 
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 			{
 				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 					continue;
@@ -164,7 +162,7 @@ void Command_CountMobjs_f(void)
 	{
 		count = 0;
 
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -183,22 +181,26 @@ void Command_CountMobjs_f(void)
 //
 void P_InitThinkers(void)
 {
-	thinkercap.prev = thinkercap.next = &thinkercap;
+	INT32 i;
+
+	for (i = 0; i < NUM_THINKERLISTS; i++)
+		thlist[i].prev = thlist[i].next = &thlist[i];
 	waypointcap = NULL;
 }
 
 //
 // P_AddThinker
-// Adds a new thinker at the end of the list.
+// Adds a new thinker at the end of the given list.
 //
-void P_AddThinker(thinker_t *thinker)
+void P_AddThinker(const thinklistnum_t n, thinker_t *thinker)
 {
-	thinkercap.prev->next = thinker;
-	thinker->next = &thinkercap;
-	thinker->prev = thinkercap.prev;
-	thinkercap.prev = thinker;
+	thlist[n].prev->next = thinker;
+	thinker->next = &thlist[n];
+	thinker->prev = thlist[n].prev;
+	thlist[n].prev = thinker;
 
 	thinker->references = 0;    // killough 11/98: init reference counter to 0
+	thinker->pool = MOBJPOOL_NONE;
 }
 
 //
@@ -234,7 +236,7 @@ void P_RemoveThinkerDelayed(void *pthinker)
 			(next->prev = currentthinker = thinker->prev)->next = next;
 		}
 		R_DestroyLevelInterpolators(thinker);
-		Z_Free(thinker);
+		P_FreeThinkerMemory(thinker);
 	}
 }
 
@@ -279,6 +281,313 @@ if ((*mop = targ) != NULL) // Set new target and if non-NULL, increase its count
 	return targ;
 }
 
+//
+// Thinker profiler
+//
+// When enabled with "thinkerprofile on", P_RunThinkers times every thinker
+// and adds it up by thinker function and, for mobjs, by mobj type. The time
+// of each whole tic is also kept for the last PROFILETICS tics, so that
+// spikes can be told apart from a generally slow level.
+//
+
+#define PROFILETICS (10*TICRATE)
+
+typedef struct
+{
+	actionf_p1 func;
+	const char *name;
+	UINT32 calls;
+	precise_t time;
+} thinkerprofile_t;
+
+#define PROFILEFUNC(f) {(actionf_p1)f, #f, 0, 0}
+
+// P_MobjThinker comes first, since it is by far the most common
+static thinkerprofile_t thinkerprofile[] =
+{
+	PROFILEFUNC(P_MobjThinker),
+	PROFILEFUNC(P_RemoveThinkerDelayed),
+	PROFILEFUNC(T_MoveCeiling),
+	PROFILEFUNC(T_CrushCeiling),
+	PROFILEFUNC(T_MoveFloor),
+	PROFILEFUNC(T_LightningFlash),
+	PROFILEFUNC(T_StrobeFlash),
+	PROFILEFUNC(T_Glow),
+	PROFILEFUNC(T_FireFlicker),
+	PROFILEFUNC(T_MoveElevator),
+	PROFILEFUNC(T_ContinuousFalling),
+	PROFILEFUNC(T_ThwompSector),
+	PROFILEFUNC(T_NoEnemiesSector),
+	PROFILEFUNC(T_EachTimeThinker),
+	PROFILEFUNC(T_RaiseSector),
+	PROFILEFUNC(T_CameraScanner),
+	PROFILEFUNC(T_Scroll),
+	PROFILEFUNC(T_Friction),
+	PROFILEFUNC(T_Pusher),
+	PROFILEFUNC(T_BounceCheese),
+	PROFILEFUNC(T_StartCrumble),
+	PROFILEFUNC(T_MarioBlock),
+	PROFILEFUNC(T_MarioBlockChecker),
+	PROFILEFUNC(T_SpikeSector),
+	PROFILEFUNC(T_FloatSector),
+	PROFILEFUNC(T_BridgeThinker),
+	PROFILEFUNC(T_LaserFlash),
+	PROFILEFUNC(T_LightFade),
+	PROFILEFUNC(T_ExecutorDelay),
+	PROFILEFUNC(T_Disappear),
+	PROFILEFUNC(T_PolyObjRotate),
+	PROFILEFUNC(T_PolyObjMove),
+	PROFILEFUNC(T_PolyObjWaypoint),
+	PROFILEFUNC(T_PolyDoorSlide),
+	PROFILEFUNC(T_PolyDoorSwing),
+	PROFILEFUNC(T_PolyObjFlag),
+	PROFILEFUNC(T_PolyObjDisplace),
+	{NULL, "(other)", 0, 0} // must be last
+};
+
+#undef PROFILEFUNC
+
+#define NUMPROFILEFUNCS (sizeof thinkerprofile / sizeof *thinkerprofile)
+
+static boolean thinkerprofiling = false;
+
+static UINT32 mobjprofilecalls[NUMMOBJTYPES];
+static precise_t mobjprofiletime[NUMMOBJTYPES];
+#ifdef HAVE_BLUA
+static precise_t mobjprofileluatime[NUMMOBJTYPES]; // part of the above spent in Lua hooks
+#endif
+
+static precise_t profiletictime[PROFILETICS]; // ring buffer of whole tics
+static UINT32 profileticthinkers[PROFILETICS];
+static UINT32 profiletics; // total tics profiled
+
+static thinkerprofile_t *P_ProfileForThinker(actionf_p1 func)
+{
+	size_t i;
+	for (i = 0; i < NUMPROFILEFUNCS-1; i++)
+		if (thinkerprofile[i].func == func)
+			break;
+	return &thinkerprofile[i];
+}
+
+static void P_ResetThinkerProfile(void)
+{
+	size_t i;
+	for (i = 0; i < NUMPROFILEFUNCS; i++)
+	{
+		thinkerprofile[i].calls = 0;
+		thinkerprofile[i].time = 0;
+	}
+	memset(mobjprofilecalls, 0, sizeof mobjprofilecalls);
+	memset(mobjprofiletime, 0, sizeof mobjprofiletime);
+#ifdef HAVE_BLUA
+	memset(mobjprofileluatime, 0, sizeof mobjprofileluatime);
+#endif
+	profiletics = 0;
+}
+
+// Same as P_RunThinkers below, with every thinker timed.
+// The thinker may be freed by its own function, so everything
+// needed from it is read beforehand.
+static void P_RunThinkersProfiled(void)
+{
+	precise_t ticstart = I_GetPreciseTime(), t;
+	thinkerprofile_t *prof;
+	mobjtype_t type;
+	UINT32 count = 0;
+#ifdef HAVE_BLUA
+	precise_t luastart;
+#endif
+	INT32 i;
+
+	for (i = 0; i < NUM_THINKERLISTS; i++)
+	{
+		for (currentthinker = thlist[i].next; currentthinker != &thlist[i]; currentthinker = currentthinker->next)
+		{
+			if (!currentthinker->function.acp1)
+				continue;
+
+			prof = P_ProfileForThinker(currentthinker->function.acp1);
+			type = (prof == &thinkerprofile[0]) ? ((mobj_t *)currentthinker)->type : NUMMOBJTYPES;
+#ifdef HAVE_BLUA
+			luastart = luahooktime;
+#endif
+			t = I_GetPreciseTime();
+
+			currentthinker->function.acp1(currentthinker);
+
+			t = I_GetPreciseTime() - t;
+			prof->calls++;
+			prof->time += t;
+			if (type < NUMMOBJTYPES)
+			{
+				mobjprofilecalls[type]++;
+				mobjprofiletime[type] += t;
+#ifdef HAVE_BLUA
+				mobjprofileluatime[type] += luahooktime - luastart;
+#endif
+			}
+			count++;
+		}
+	}
+
+	profiletictime[profiletics % PROFILETICS] = I_GetPreciseTime() - ticstart;
+	profileticthinkers[profiletics % PROFILETICS] = count;
+	profiletics++;
+}
+
+static int P_CompareProfileFuncs(const void *a, const void *b)
+{
+	const thinkerprofile_t *pa = a, *pb = b;
+	if (pa->time != pb->time)
+		return (pa->time < pb->time) ? 1 : -1;
+	return 0;
+}
+
+static int P_CompareProfileMobjs(const void *a, const void *b)
+{
+	const mobjtype_t ta = *(const mobjtype_t *)a, tb = *(const mobjtype_t *)b;
+	if (mobjprofiletime[ta] != mobjprofiletime[tb])
+		return (mobjprofiletime[ta] < mobjprofiletime[tb]) ? 1 : -1;
+	return ta - tb;
+}
+
+static void P_DumpThinkerProfile(void)
+{
+	UINT64 precision = I_GetPrecisePrecision();
+	thinkerprofile_t funcs[NUMPROFILEFUNCS];
+	mobjtype_t types[NUMMOBJTYPES];
+	// per-tic histogram buckets, in microseconds
+	static const UINT32 bucketus[] = {250, 500, 1000, 2000, 4000, 8000, 16000, 28571, UINT32_MAX};
+	UINT32 buckets[sizeof bucketus / sizeof *bucketus];
+	UINT32 numtics = min(profiletics, PROFILETICS);
+	precise_t total = 0, worst = 0;
+	size_t i, j;
+
+	if (!profiletics)
+	{
+		CONS_Printf(M_GetText("No tics have been profiled yet.\n"));
+		return;
+	}
+
+	memcpy(funcs, thinkerprofile, sizeof funcs);
+	qsort(funcs, NUMPROFILEFUNCS, sizeof *funcs, P_CompareProfileFuncs);
+
+	CONS_Printf("\x82%s", M_GetText("Thinkers by function\n"));
+	for (i = 0; i < NUMPROFILEFUNCS && funcs[i].calls; i++)
+	{
+		CONS_Printf("%-24s: %9u calls, %8u us, %5u ns/call\n", funcs[i].name, funcs[i].calls,
+			(UINT32)(funcs[i].time * 1000000 / precision),
+			(UINT32)(funcs[i].time * 1000000000 / precision / funcs[i].calls));
+	}
+
+	for (i = 0; i < NUMMOBJTYPES; i++)
+		types[i] = i;
+	qsort(types, NUMMOBJTYPES, sizeof *types, P_CompareProfileMobjs);
+
+	CONS_Printf("\x82%s", M_GetText("Top mobj types\n"));
+	for (i = 0; i < 15 && mobjprofilecalls[types[i]]; i++)
+	{
+		mobjtype_t type = types[i];
+		CONS_Printf("%4d: %9u calls, %8u us, %5u ns/call", type, mobjprofilecalls[type],
+			(UINT32)(mobjprofiletime[type] * 1000000 / precision),
+			(UINT32)(mobjprofiletime[type] * 1000000000 / precision / mobjprofilecalls[type]));
+#ifdef HAVE_BLUA
+		if (mobjprofileluatime[type])
+			CONS_Printf(", %u us in Lua", (UINT32)(mobjprofileluatime[type] * 1000000 / precision));
+#endif
+		CONS_Printf("\n");
+	}
+
+	memset(buckets, 0, sizeof buckets);
+	for (i = 0; i < numtics; i++)
+	{
+		UINT32 us = (UINT32)(profiletictime[i] * 1000000 / precision);
+		for (j = 0; us >= bucketus[j]; j++)
+			;
+		buckets[j]++;
+		total += profiletictime[i];
+		if (profiletictime[i] > worst)
+			worst = profiletictime[i];
+	}
+
+	CONS_Printf("\x82%s", va(M_GetText("Last %u tics: %u us average, %u us worst\n"), numtics,
+		(UINT32)(total * 1000000 / precision / numtics), (UINT32)(worst * 1000000 / precision)));
+	for (j = 0; j < sizeof buckets / sizeof *buckets; j++)
+	{
+		if (!buckets[j])
+			continue;
+		if (bucketus[j] == UINT32_MAX)
+			CONS_Printf("  >= %5u us: %5u\n", bucketus[j-1], buckets[j]);
+		else
+			CONS_Printf("   < %5u us: %5u\n", bucketus[j], buckets[j]);
+	}
+}
+
+static void P_ExportThinkerProfile(const char *filename)
+{
+	UINT64 precision = I_GetPrecisePrecision();
+	UINT32 numtics = min(profiletics, PROFILETICS);
+	const char *path = va("%s"PATHSEP"%s", srb2home, filename);
+	FILE *f = fopen(path, "w");
+	size_t i;
+
+	if (!f)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't open %s for writing\n"), path);
+		return;
+	}
+
+	fprintf(f, "kind,name,calls,total_us,lua_us\n");
+	for (i = 0; i < NUMPROFILEFUNCS; i++)
+		if (thinkerprofile[i].calls)
+			fprintf(f, "function,%s,%u,%u,\n", thinkerprofile[i].name, thinkerprofile[i].calls,
+				(UINT32)(thinkerprofile[i].time * 1000000 / precision));
+	for (i = 0; i < NUMMOBJTYPES; i++)
+		if (mobjprofilecalls[i])
+#ifdef HAVE_BLUA
+			fprintf(f, "mobjtype,%u,%u,%u,%u\n", (UINT32)i, mobjprofilecalls[i],
+				(UINT32)(mobjprofiletime[i] * 1000000 / precision),
+				(UINT32)(mobjprofileluatime[i] * 1000000 / precision));
+#else
+			fprintf(f, "mobjtype,%u,%u,%u,\n", (UINT32)i, mobjprofilecalls[i],
+				(UINT32)(mobjprofiletime[i] * 1000000 / precision));
+#endif
+	// oldest tic first
+	for (i = profiletics - numtics; i < profiletics; i++)
+		fprintf(f, "tic,%u,%u,%u,\n", (UINT32)i, profileticthinkers[i % PROFILETICS],
+			(UINT32)(profiletictime[i % PROFILETICS] * 1000000 / precision));
+
+	fclose(f);
+	CONS_Printf(M_GetText("Thinker profile written to %s\n"), path);
+}
+
+void Command_ThinkerProfile_f(void)
+{
+	const char *arg = (COM_Argc() > 1) ? COM_Argv(1) : "";
+
+	if (!stricmp(arg, "on"))
+	{
+		if (!thinkerprofiling)
+			P_ResetThinkerProfile();
+		thinkerprofiling = true;
+	}
+	else if (!stricmp(arg, "off"))
+		thinkerprofiling = false;
+	else if (!stricmp(arg, "reset"))
+		P_ResetThinkerProfile();
+	else if (!stricmp(arg, "dump"))
+		P_DumpThinkerProfile();
+	else if (!stricmp(arg, "export"))
+		P_ExportThinkerProfile((COM_Argc() > 2) ? COM_Argv(2) : "thinkerprofile.csv");
+	else
+	{
+		CONS_Printf(M_GetText("thinkerprofile <on|off|reset|dump|export [file]>: Time thinkers by function and object type\n"));
+		CONS_Printf(M_GetText("Profiling is currently %s, %u tics recorded.\n"),
+			thinkerprofiling ? M_GetText("on") : M_GetText("off"), profiletics);
+	}
+}
+
 //
 // P_RunThinkers
 //
@@ -303,10 +612,21 @@ if ((*mop = targ) != NULL) // Set new target and if non-NULL, increase its count
 //
 static inline void P_RunThinkers(void)
 {
-	for (currentthinker = thinkercap.next; currentthinker != &thinkercap; currentthinker = currentthinker->next)
+	INT32 i;
+
+	if (thinkerprofiling)
 	{
-		if (currentthinker->function.acp1)
-			currentthinker->function.acp1(currentthinker);
+		P_RunThinkersProfiled();
+		return;
+	}
+
+	for (i = 0; i < NUM_THINKERLISTS; i++)
+	{
+		for (currentthinker = thlist[i].next; currentthinker != &thlist[i]; currentthinker = currentthinker->next)
+		{
+			if (currentthinker->function.acp1)
+				currentthinker->function.acp1(currentthinker);
+		}
 	}
 }
 
@@ -589,6 +909,7 @@ void P_Ticker(boolean run)
 			R_UpdateMobjInterpolators();
 			OP_ObjectplaceMovement(&players[0]);
 			P_MoveChaseCamera(&players[0], &camera[0], false);
+			R_CaptureMobjInterpolators();
 			R_UpdateViewInterpolation();
 			P_MapEnd();
 			return;
@@ -698,6 +1019,10 @@ void P_Ticker(boolean run)
 	P_UpdateSpecials();
 	P_RespawnSpecials();
 
+	// Rain and snow fall here, not in the renderers
+	if (run)
+		P_RunPrecipitation();
+
 	// Lightning, rain sounds, etc.
 	P_PrecipitationEffects();
 
@@ -814,6 +1139,7 @@ void P_Ticker(boolean run)
 	if (run)
 	{
 		R_UpdateLevelInterpolators();
+		R_CaptureMobjInterpolators();
 		R_UpdateViewInterpolation();
 
 		// Hack: ensure newview is assigned every tic.
@@ -904,6 +1230,7 @@ void P_PreTicker(INT32 frames)
 #endif
 
 		R_UpdateLevelInterpolators();
+		R_CaptureMobjInterpolators();
 		R_UpdateViewInterpolation();
 		R_ResetViewInterpolation(0);
 
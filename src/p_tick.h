@@ -23,6 +23,7 @@ extern tic_t leveltime;
 // Called by G_Ticker. Carries out all thinking of enemies and players.
 void Command_Numthinkers_f(void);
 void Command_CountMobjs_f(void);
+void Command_ThinkerProfile_f(void);
 
 void P_Ticker(boolean run);
 void P_PreTicker(INT32 frames);
@@ -21,21 +21,27 @@
 #include "p_slopes.h"
 #include "z_zone.h" // Check R_Prep3DFloors
 
-seg_t *curline;
-side_t *sidedef;
-line_t *linedef;
-sector_t *frontsector;
-sector_t *backsector;
-boolean portalline; // is curline a portal seg?
+THREADLOCAL seg_t *curline;
+THREADLOCAL side_t *sidedef;
+THREADLOCAL line_t *linedef;
+THREADLOCAL sector_t *frontsector;
+THREADLOCAL sector_t *backsector;
+THREADLOCAL boolean portalline; // is curline a portal seg?
 
 // very ugly realloc() of drawsegs at run-time, I upped it to 512
 // instead of 256.. and someone managed to send me a level with
 // 896 drawsegs! So too bad here's a limit removal a-la-Boom
-drawseg_t *drawsegs = NULL;
-drawseg_t *ds_p = NULL;
+THREADLOCAL drawseg_t *drawsegs = NULL;
+THREADLOCAL drawseg_t *ds_p = NULL;
 
 // indicates doors closed wrt automap bugfix:
-INT32 doorclosed;
+THREADLOCAL INT32 doorclosed;
+
+// Polyobjects are shared by every view being rendered, so what a view
+// works out about each of them is kept here, by polyobject number.
+static THREADLOCAL fixed_t *po_zdist;
+THREADLOCAL struct visplane_s **po_visplanes;
+static THREADLOCAL size_t num_po_views;
 
 boolean R_NoEncore(sector_t *sector, boolean ceiling)
 {
@@ -63,14 +69,26 @@ boolean R_NoEncore(sector_t *sector, boolean ceiling)
 void R_ClearDrawSegs(void)
 {
 	ds_p = drawsegs;
+
+	if (num_po_views < (size_t)numPolyObjects)
+	{
+		free(po_zdist);
+		free(po_visplanes);
+		num_po_views = numPolyObjects;
+		po_zdist = malloc(num_po_views * sizeof (*po_zdist));
+		po_visplanes = malloc(num_po_views * sizeof (*po_visplanes));
+	}
+
+	if (numPolyObjects)
+		memset(po_visplanes, 0, numPolyObjects * sizeof (*po_visplanes));
 }
 
 // Fix from boom.
 #define MAXSEGS (MAXVIDWIDTH/2+1)
 
 // newend is one past the last valid seg
-static cliprange_t *newend;
-static cliprange_t solidsegs[MAXSEGS];
+static THREADLOCAL cliprange_t *newend;
+static THREADLOCAL cliprange_t solidsegs[MAXSEGS];
 
 //
 // R_ClipSolidWallSegment
@@ -208,8 +226,8 @@ static inline void R_ClipPassWallSegment(INT32 first, INT32 last)
 void R_ClearClipSegs(void)
 {
 	solidsegs[0].first = -0x7fffffff;
-	solidsegs[0].last = -1;
-	solidsegs[1].first = viewwidth;
+	solidsegs[0].last = viewclipx1 - 1;
+	solidsegs[1].first = viewclipx2 + 1;
 	solidsegs[1].last = 0x7fffffff;
 	newend = solidsegs + 2;
 }
@@ -402,7 +420,7 @@ static void R_AddLine(seg_t *line)
 {
 	INT32 x1, x2;
 	angle_t angle1, angle2, span, tspan;
-	static sector_t tempsec;
+	static THREADLOCAL sector_t tempsec;
 
 	portalline = false;
 
@@ -649,9 +667,9 @@ static boolean R_CheckBBox(const fixed_t *bspcoord)
 }
 
 
-size_t numpolys;        // number of polyobjects in current subsector
-size_t num_po_ptrs;     // number of polyobject pointers allocated
-polyobj_t **po_ptrs; // temp ptr array to sort polyobject pointers
+THREADLOCAL size_t numpolys;        // number of polyobjects in current subsector
+THREADLOCAL size_t num_po_ptrs;     // number of polyobject pointers allocated
+THREADLOCAL polyobj_t **po_ptrs; // temp ptr array to sort polyobject pointers
 
 //
 // R_PolyobjCompare
@@ -665,7 +683,7 @@ static int R_PolyobjCompare(const void *p1, const void *p2)
 	const polyobj_t *po1 = *(const polyobj_t * const *)p1;
 	const polyobj_t *po2 = *(const polyobj_t * const *)p2;
 
-	return po1->zdist - po2->zdist;
+	return po_zdist[po1 - PolyObjects] - po_zdist[po2 - PolyObjects];
 }
 
 //
@@ -697,7 +715,7 @@ void R_SortPolyObjects(subsector_t *sub)
 
 		while (po)
 		{
-			po->zdist = R_PointToDist2(viewx, viewy,
+			po_zdist[po - PolyObjects] = R_PointToDist2(viewx, viewy,
 				po->centerPt.x, po->centerPt.y);
 			po_ptrs[i++] = po;
 			po = (polyobj_t *)(po->link.next);
@@ -820,14 +838,14 @@ static void R_AddPolyObjects(subsector_t *sub)
 // Draw one or more line segments.
 //
 
-drawseg_t *firstseg;
+THREADLOCAL drawseg_t *firstseg;
 
 static void R_Subsector(size_t num)
 {
 	INT32 count, floorlightlevel, ceilinglightlevel, light;
 	seg_t *line;
 	subsector_t *sub;
-	static sector_t tempsec; // Deep water hack
+	static THREADLOCAL sector_t tempsec; // Deep water hack
 	extracolormap_t *floorcolormap;
 	extracolormap_t *ceilingcolormap;
 	fixed_t floorcenterz, ceilingcenterz;
@@ -1062,7 +1080,7 @@ static void R_Subsector(size_t num)
 				ffloor[numffloors].polyobj = po;
 				ffloor[numffloors].slope = NULL;
 //				ffloor[numffloors].ffloor = rover;
-				po->visplane = ffloor[numffloors].plane;
+				po_visplanes[po - PolyObjects] = ffloor[numffloors].plane;
 				numffloors++;
 			}
 
@@ -1087,7 +1105,7 @@ static void R_Subsector(size_t num)
 				ffloor[numffloors].height = polysec->ceilingheight;
 				ffloor[numffloors].slope = NULL;
 //				ffloor[numffloors].ffloor = rover;
-				po->visplane = ffloor[numffloors].plane;
+				po_visplanes[po - PolyObjects] = ffloor[numffloors].plane;
 				numffloors++;
 			}
 
@@ -1258,6 +1276,39 @@ void R_Prep3DFloors(sector_t *sector)
 	}
 }
 
+//
+// R_PrepMovedSectors
+//
+// Rebuilds the lightlists of every sector whose 3D floors moved, so that
+// views drawn on other threads only ever read them.
+//
+void R_PrepMovedSectors(void)
+{
+	ffloor_t *rover;
+	size_t i;
+
+	for (i = 0; i < numsectors; i++)
+	{
+		sector_t *sec = &sectors[i];
+		boolean anyMoved = sec->moved;
+
+		if (!sec->ffloors)
+			continue;
+
+		for (rover = sec->ffloors; rover && !anyMoved; rover = rover->next)
+			anyMoved = sectors[rover->secnum].moved;
+
+		if (anyMoved)
+		{
+			sec->numlights = 0;
+			R_Prep3DFloors(sec);
+		}
+	}
+
+	for (i = 0; i < numsectors; i++)
+		sectors[i].moved = false;
+}
+
 INT32 R_GetPlaneLight(sector_t *sector, fixed_t planeheight, boolean underside)
 {
 	INT32 i;
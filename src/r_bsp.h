@@ -18,20 +18,20 @@
 #pragma interface
 #endif
 
-extern seg_t *curline;
-extern side_t *sidedef;
-extern line_t *linedef;
-extern sector_t *frontsector;
-extern sector_t *backsector;
-extern boolean portalline; // is curline a portal seg?
+extern THREADLOCAL seg_t *curline;
+extern THREADLOCAL side_t *sidedef;
+extern THREADLOCAL line_t *linedef;
+extern THREADLOCAL sector_t *frontsector;
+extern THREADLOCAL sector_t *backsector;
+extern THREADLOCAL boolean portalline; // is curline a portal seg?
 
 // drawsegs are allocated on the fly... see r_segs.c
 
 extern INT32 checkcoord[12][4];
 
-extern drawseg_t *drawsegs;
-extern drawseg_t *ds_p;
-extern INT32 doorclosed;
+extern THREADLOCAL drawseg_t *drawsegs;
+extern THREADLOCAL drawseg_t *ds_p;
+extern THREADLOCAL INT32 doorclosed;
 
 // BSP?
 void R_ClearClipSegs(void);
@@ -46,9 +46,10 @@ boolean R_NoEncore(sector_t *sector, boolean ceiling);
 
 void R_SortPolyObjects(subsector_t *sub);
 
-extern size_t numpolys;        // number of polyobjects in current subsector
-extern size_t num_po_ptrs;     // number of polyobject pointers allocated
-extern polyobj_t **po_ptrs; // temp ptr array to sort polyobject pointers
+extern THREADLOCAL size_t numpolys;        // number of polyobjects in current subsector
+extern THREADLOCAL size_t num_po_ptrs;     // number of polyobject pointers allocated
+extern THREADLOCAL polyobj_t **po_ptrs; // temp ptr array to sort polyobject pointers
+extern THREADLOCAL struct visplane_s **po_visplanes; // each polyobject's visplane this view, for R_DrawMasked
 
 sector_t *R_FakeFlat(sector_t *sec, sector_t *tempsec, INT32 *floorlightlevel,
 	INT32 *ceilinglightlevel, boolean back);
@@ -56,4 +57,5 @@ boolean R_IsEmptyLine(seg_t *line, sector_t *front, sector_t *back);
 
 INT32 R_GetPlaneLight(sector_t *sector, fixed_t planeheight, boolean underside);
 void R_Prep3DFloors(sector_t *sector);
+void R_PrepMovedSectors(void);
 #endif
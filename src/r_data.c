@@ -24,6 +24,10 @@
 #include "p_setup.h" // levelflats
 #include "v_video.h" // pLocalPalette
 #include "dehacked.h"
+#include "d_main.h" // srb2home
+#include "i_system.h"
+#include "m_argv.h"
+#include "md5.h"
 
 #if defined (_WIN32) || defined (_WIN32_WCE)
 #include <malloc.h> // alloca(sizeof)
@@ -40,6 +44,19 @@
 #include <errno.h>
 #endif
 
+#ifdef HAVE_THREADS
+#include "i_threads.h"
+#endif
+
+#ifdef THREADEDRENDER
+static I_mutex texture_mutex;
+#  define Lock_textures()   do { if (viewthreadsactive) I_lock_mutex(&texture_mutex); } while (0)
+#  define Unlock_textures() do { if (viewthreadsactive) I_unlock_mutex(texture_mutex); } while (0)
+#else
+#  define Lock_textures()
+#  define Unlock_textures()
+#endif
+
 //
 // Texture definition.
 // Each texture is composed of one or more patches,
@@ -120,6 +137,11 @@ UINT8 invertmap[256];
 // for debugging/info purposes
 static size_t flatmemory, spritememory, texturememory;
 
+// R_PrecacheLevel builds the level's textures into one block, which stays
+// until the next precache, or the textures get reloaded.
+static UINT8 *textureatlas;
+static size_t textureatlassize;
+
 // highcolor stuff
 INT16 color8to16[256]; // remap color index to highcolor rgb value
 INT16 *hicolormaps; // test a 32k colormap remaps high -> high
@@ -178,108 +200,101 @@ static inline void R_DrawColumnInCache(column_t *patch, UINT8 *cache, INT32 orig
 }
 
 //
-// R_GenerateTexture
-//
-// Allocate space for full size texture, either single patch or 'composite'
-// Build the full textures from patches.
-// The texture caching system is a little more hungry of memory, but has
-// been simplified for the sake of highcolor, dynamic ligthing, & speed.
+// R_TextureHasHoles
 //
-// This is not optimised, but it's supposed to be executed only once
-// per level, when enough memory is available.
+// Single-patch textures can have holes in them and may be used on
+// 2sided lines so they need to be kept in 'packed' format
+// BUT this is wrong for skies and walls with over 255 pixels,
+// so check if there's holes and if not strip the posts.
 //
-static UINT8 *R_GenerateTexture(size_t texnum)
+static boolean R_TextureHasHoles(texture_t *texture, patch_t **patches)
 {
-	UINT8 *block;
-	UINT8 *blocktex;
-	texture_t *texture;
-	texpatch_t *patch;
 	patch_t *realpatch;
-	int x, x1, x2, i;
-	size_t blocksize;
-	column_t *patchcol;
 	UINT8 *colofs;
+	int x;
 
-	I_Assert(texnum <= (size_t)numtextures);
-	texture = textures[texnum];
-	I_Assert(texture != NULL);
+	if (texture->patchcount != 1)
+		return false;
 
-	// allocate texture column offset lookup
+	realpatch = patches[0];
 
-	// single-patch textures can have holes in them and may be used on
-	// 2sided lines so they need to be kept in 'packed' format
-	// BUT this is wrong for skies and walls with over 255 pixels,
-	// so check if there's holes and if not strip the posts.
-	if (texture->patchcount == 1)
-	{
-		boolean holey = false;
-		patch = texture->patches;
-		realpatch = W_CacheLumpNumPwad(patch->wad, patch->lump, PU_CACHE);
+	if (texture->width > SHORT(realpatch->width) || texture->height > SHORT(realpatch->height))
+		return true;
 
-		// Check the patch for holes.
-		if (texture->width > SHORT(realpatch->width) || texture->height > SHORT(realpatch->height))
-			holey = true;
-		colofs = (UINT8 *)realpatch->columnofs;
-		for (x = 0; x < texture->width && !holey; x++)
+	colofs = (UINT8 *)realpatch->columnofs;
+	for (x = 0; x < texture->width; x++)
+	{
+		column_t *col = (column_t *)((UINT8 *)realpatch + LONG(*(UINT32 *)&colofs[x<<2]));
+		INT32 topdelta, prevdelta = -1, y = 0;
+		while (col->topdelta != 0xff)
 		{
-			column_t *col = (column_t *)((UINT8 *)realpatch + LONG(*(UINT32 *)&colofs[x<<2]));
-			INT32 topdelta, prevdelta = -1, y = 0;
-			while (col->topdelta != 0xff)
-			{
-				topdelta = col->topdelta;
-				if (topdelta <= prevdelta)
-					topdelta += prevdelta;
-				prevdelta = topdelta;
-				if (topdelta > y)
-					break;
-				y = topdelta + col->length + 1;
-				col = (column_t *)((UINT8 *)col + col->length + 4);
-			}
-			if (y < texture->height)
-				holey = true; // this texture is HOLEy! D:
+			topdelta = col->topdelta;
+			if (topdelta <= prevdelta)
+				topdelta += prevdelta;
+			prevdelta = topdelta;
+			if (topdelta > y)
+				break;
+			y = topdelta + col->length + 1;
+			col = (column_t *)((UINT8 *)col + col->length + 4);
 		}
+		if (y < texture->height)
+			return true; // this texture is HOLEy! D:
+	}
 
-		// If the patch uses transparency, we have to save it this way.
-		if (holey)
-		{
-			texture->holes = true;
-			blocksize = W_LumpLengthPwad(patch->wad, patch->lump);
-			block = Z_Calloc(blocksize, PU_STATIC, // will change tag at end of this function
-				&texturecache[texnum]);
-			M_Memcpy(block, realpatch, blocksize);
-			texturememory += blocksize;
-
-			// use the patch's column lookup
-			colofs = (block + 8);
-			texturecolumnofs[texnum] = (UINT32 *)colofs;
-			blocktex = block;
-			for (x = 0; x < texture->width; x++)
-				*(UINT32 *)&colofs[x<<2] = LONG(LONG(*(UINT32 *)&colofs[x<<2]) + 3);
-			goto done;
-		}
+	return false;
+}
 
-		// Otherwise, do multipatch format.
-	}
+//
+// R_TextureBlockSize
+//
+// How big the block R_CompositeTexture builds a texture in is.
+//
+static size_t R_TextureBlockSize(texture_t *texture, boolean holey)
+{
+	// If the patch uses transparency, we have to save it as is.
+	if (holey)
+		return W_LumpLengthPwad(texture->patches[0].wad, texture->patches[0].lump);
 
-	// multi-patch textures (or 'composite')
-	texture->holes = false;
-	blocksize = (texture->width * 4) + (texture->width * texture->height);
-	texturememory += blocksize;
-	block = Z_Malloc(blocksize+1, PU_STATIC, &texturecache[texnum]);
+	// Otherwise, the column lookup, the columns, and one byte for the transparency hack.
+	return (texture->width * 4) + (texture->width * texture->height) + 1;
+}
+
+//
+// R_CompositeTexture
+//
+// Builds a full size texture into block from its patches, which the caller
+// has cached. Both formats only hold offsets from the start of block, so a
+// built texture can be moved or saved as it is. This touches nothing but
+// its arguments, so the level precache runs it on worker threads.
+//
+static void R_CompositeTexture(texture_t *texture, patch_t **patches, UINT8 *block, size_t blocksize, boolean holey)
+{
+	texpatch_t *patch;
+	patch_t *realpatch;
+	int x, x1, x2, i;
+	column_t *patchcol;
+	UINT8 *colofs;
 
-	memset(block, 0xF7, blocksize+1); // Transparency hack
+	if (holey)
+	{
+		M_Memcpy(block, patches[0], blocksize);
+
+		// use the patch's column lookup
+		colofs = (block + 8);
+		for (x = 0; x < texture->width; x++)
+			*(UINT32 *)&colofs[x<<2] = LONG(LONG(*(UINT32 *)&colofs[x<<2]) + 3);
+		return;
+	}
+
+	memset(block, 0xF7, blocksize); // Transparency hack
 
 	// columns lookup table
 	colofs = block;
-	texturecolumnofs[texnum] = (UINT32 *)colofs;
-
-	// texture data after the lookup table
-	blocktex = block + (texture->width*4);
 
 	// Composite the columns together.
 	for (i = 0, patch = texture->patches; i < texture->patchcount; i++, patch++)
 	{
-		realpatch = W_CacheLumpNumPwad(patch->wad, patch->lump, PU_CACHE);
+		realpatch = patches[i];
 		x1 = patch->originx;
 		x2 = x1 + SHORT(realpatch->width);
 
@@ -300,11 +315,72 @@ static UINT8 *R_GenerateTexture(size_t texnum)
 			R_DrawColumnInCache(patchcol, block + LONG(*(UINT32 *)&colofs[x<<2]), patch->originy, texture->height);
 		}
 	}
+}
+
+//
+// R_GenerateTexture
+//
+// Allocate space for full size texture, either single patch or 'composite'
+// Build the full textures from patches.
+// The texture caching system is a little more hungry of memory, but has
+// been simplified for the sake of highcolor, dynamic ligthing, & speed.
+//
+// This is for textures R_PrecacheLevel didn't build, and only does one
+// at a time, on whichever thread draws with it first.
+//
+static UINT8 *R_GenerateTexture(size_t texnum)
+{
+	UINT8 *block;
+	texture_t *texture;
+	patch_t **patches;
+	size_t blocksize;
+	boolean holey;
+	INT32 i;
+
+	I_Assert(texnum <= (size_t)numtextures);
+	texture = textures[texnum];
+	I_Assert(texture != NULL);
+
+	patches = Z_Malloc(texture->patchcount * sizeof (*patches), PU_STATIC, NULL);
+	for (i = 0; i < texture->patchcount; i++)
+		patches[i] = W_CacheLumpNumPwad(texture->patches[i].wad, texture->patches[i].lump, PU_STATIC);
+
+	holey = R_TextureHasHoles(texture, patches);
+	texture->holes = holey;
+
+	blocksize = R_TextureBlockSize(texture, holey);
+	texturememory += blocksize;
+	block = Z_Malloc(blocksize, PU_STATIC, NULL); // will get its user and tag at end of this function
+
+	R_CompositeTexture(texture, patches, block, blocksize, holey);
+
+	for (i = 0; i < texture->patchcount; i++)
+		Z_ChangeTag(patches[i], PU_CACHE);
+	Z_Free(patches);
+
+	// Only hand the texture out once it's complete, as other views may be
+	// drawing from the cache in the meantime.
+	texturecolumnofs[texnum] = (UINT32 *)(holey ? block + 8 : block);
+	Z_SetUser(block, (void **)&texturecache[texnum]);
 
-done:
 	// Now that the texture has been built in column cache, it is purgable from zone memory.
 	Z_ChangeTag(block, PU_CACHE);
-	return blocktex;
+	return holey ? block : block + (texture->width*4);
+}
+
+// Generates a texture that isn't cached yet. Another view may have
+// generated it while we waited for the lock, in which case that's used.
+static UINT8 *R_CacheTexture(size_t texnum)
+{
+	UINT8 *data;
+
+	Lock_textures();
+	data = texturecache[texnum];
+	if (!data)
+		data = R_GenerateTexture(texnum);
+	Unlock_textures();
+
+	return data;
 }
 
 //
@@ -330,7 +406,7 @@ INT32 R_GetTextureNum(INT32 texnum)
 void R_CheckTextureCache(INT32 tex)
 {
 	if (!texturecache[tex])
-		R_GenerateTexture(tex);
+		R_CacheTexture(tex);
 }
 
 //
@@ -344,7 +420,7 @@ UINT8 *R_GetColumn(fixed_t tex, INT32 col)
 	data = texturecache[tex];
 
 	if (!data)
-		data = R_GenerateTexture(tex);
+		data = R_CacheTexture(tex);
 
 	return data + LONG(texturecolumnofs[tex][col]);
 }
@@ -356,6 +432,28 @@ UINT8 *R_GetFlat(lumpnum_t flatlumpnum)
 	return W_CacheLumpNum(flatlumpnum, PU_CACHE);
 }
 
+static inline boolean R_TextureInAtlas(INT32 texnum)
+{
+	return (texturecache[texnum] >= textureatlas && texturecache[texnum] < textureatlas + textureatlassize);
+}
+
+// Forgets every texture in the atlas, then frees it.
+static void R_FreeTextureAtlas(void)
+{
+	INT32 i;
+
+	if (!textureatlas)
+		return;
+
+	for (i = 0; i < numtextures; i++)
+		if (R_TextureInAtlas(i))
+			texturecache[i] = NULL;
+
+	Z_Free(textureatlas);
+	textureatlas = NULL;
+	textureatlassize = 0;
+}
+
 //
 // Empty the texture cache (used for load wad at runtime)
 //
@@ -363,6 +461,8 @@ void R_FlushTextureCache(void)
 {
 	INT32 i;
 
+	R_FreeTextureAtlas();
+
 	if (numtextures)
 		for (i = 0; i < numtextures; i++)
 			Z_Free(texturecache[i]);
@@ -388,6 +488,7 @@ void R_LoadTextures(void)
 	texture_t *texture;
 
 	// Free previous memory before numtextures change.
+	R_FreeTextureAtlas();
 	if (numtextures)
 	{
 		for (i = 0; i < numtextures; i++)
@@ -1590,6 +1691,465 @@ INT32 R_TextureNumForName(const char *name)
 	return i;
 }
 
+// ==========================================================================
+//                                                    LEVEL TEXTURE PRECACHE
+// ==========================================================================
+
+// Built textures are kept on disk, in one file per set of loaded wads,
+// so the next time those wads get played they are just read back.
+#define TEXCACHEDIR "texcache"
+#define TEXCACHEMAGIC "SRB2TXC1"
+
+typedef struct
+{
+	char magic[8];
+	UINT8 key[16]; // every wad's MD5, hashed together
+	INT32 numtextures;
+} ATTRPACK texcacheheader_t;
+
+// Followed by size bytes of the texture, as R_CompositeTexture builds it.
+typedef struct
+{
+	char name[8];
+	INT32 texnum;
+	INT16 width, height;
+	UINT32 size;
+	UINT8 holey;
+	UINT8 pad[3];
+} ATTRPACK texcacherecord_t;
+
+typedef struct
+{
+	INT32 texnum;
+	patch_t **patches; // set if it has to be composited
+	size_t ofs, size; // in the atlas
+	UINT8 *block;
+	boolean holey;
+	long fileofs; // where its data is in the disk cache, or 0
+} texturejob_t;
+
+static texturejob_t *texturejobs;
+static INT32 numtexturejobs;
+
+#ifdef HAVE_THREADS
+#define COMPOSITETHREADS 3
+
+static INT32 nexttexturejob, compositeworkers;
+static I_mutex composite_mutex;
+static I_cond composite_cond;
+
+// Composites queued textures until there are none left.
+static void R_CompositeTextureJobs(void)
+{
+	texturejob_t *job;
+	INT32 i;
+
+	for (;;)
+	{
+		I_lock_mutex(&composite_mutex);
+		i = nexttexturejob++;
+		I_unlock_mutex(composite_mutex);
+
+		if (i >= numtexturejobs)
+			break;
+
+		job = &texturejobs[i];
+		if (job->patches)
+			R_CompositeTexture(textures[job->texnum], job->patches, job->block, job->size, job->holey);
+	}
+}
+
+static void R_CompositeWorker(void *userdata)
+{
+	(void)userdata;
+
+	R_CompositeTextureJobs();
+
+	I_lock_mutex(&composite_mutex);
+	compositeworkers--;
+	I_wake_all_cond(&composite_cond);
+	I_unlock_mutex(composite_mutex);
+}
+#endif
+
+//
+// R_RunTextureJobs
+//
+// Composites the textures that weren't in the disk cache. The patches are
+// all cached already, so this never touches the zone, and can be shared
+// with a few threads. Returns how many threads were used.
+//
+static INT32 R_RunTextureJobs(INT32 numcomposite)
+{
+#ifdef HAVE_THREADS
+	INT32 i, threads = 1;
+
+	nexttexturejob = 0;
+
+	I_lock_mutex(&composite_mutex);
+	for (i = 0; i < COMPOSITETHREADS && i < numcomposite - 1; i++)
+	{
+		compositeworkers++;
+		threads++;
+		I_spawn_thread("texture-composite", R_CompositeWorker, NULL);
+	}
+	I_unlock_mutex(composite_mutex);
+
+	R_CompositeTextureJobs();
+
+	I_lock_mutex(&composite_mutex);
+	while (compositeworkers)
+		I_hold_cond(&composite_cond, composite_mutex);
+	I_unlock_mutex(composite_mutex);
+
+	return threads;
+#else
+	texturejob_t *job;
+	INT32 i;
+
+	(void)numcomposite;
+
+	for (i = 0, job = texturejobs; i < numtexturejobs; i++, job++)
+		if (job->patches)
+			R_CompositeTexture(textures[job->texnum], job->patches, job->block, job->size, job->holey);
+
+	return 1;
+#endif
+}
+
+// The disk cache is named after the MD5 of every loaded wad's MD5, in order.
+static const char *R_TextureCachePath(const UINT8 *key)
+{
+	char hex[33];
+	INT32 i;
+
+	for (i = 0; i < 16; i++)
+		snprintf(&hex[i*2], 3, "%02x", key[i]);
+
+	return va("%s"PATHSEP TEXCACHEDIR PATHSEP"%s.dat", srb2home, hex);
+}
+
+static void R_TextureCacheKey(UINT8 *key)
+{
+	UINT8 *sums = Z_Malloc(numwadfiles * 16, PU_STATIC, NULL);
+	UINT16 i;
+
+	for (i = 0; i < numwadfiles; i++)
+		M_Memcpy(&sums[i*16], wadfiles[i]->md5sum, 16);
+
+	md5_buffer((const char *)sums, numwadfiles * 16, key);
+	Z_Free(sums);
+}
+
+//
+// R_OpenTextureCache
+//
+// Opens the disk cache for these wads, and finds where in it each texture's
+// newest record is. intact is cleared if the file ends in a broken record,
+// in which case it gets rewritten rather than added to.
+//
+static FILE *R_OpenTextureCache(const UINT8 *key, long *recordofs, boolean *intact)
+{
+	texcacheheader_t header;
+	texcacherecord_t record;
+	long ofs, end;
+	FILE *f;
+
+	*intact = false;
+
+	f = fopen(R_TextureCachePath(key), "rb");
+	if (!f)
+		return NULL;
+
+	if (fread(&header, sizeof header, 1, f) != 1
+		|| memcmp(header.magic, TEXCACHEMAGIC, sizeof header.magic)
+		|| memcmp(header.key, key, sizeof header.key)
+		|| LONG(header.numtextures) != numtextures)
+	{
+		fclose(f);
+		return NULL;
+	}
+
+	fseek(f, 0, SEEK_END);
+	end = ftell(f);
+
+	ofs = sizeof header;
+	while (ofs + (long)sizeof record <= end)
+	{
+		if (fseek(f, ofs, SEEK_SET) || fread(&record, sizeof record, 1, f) != 1)
+			break;
+
+		record.texnum = LONG(record.texnum);
+		record.size = LONG(record.size);
+		if (record.texnum < 0 || record.texnum >= numtextures || (long)record.size > end - ofs - (long)sizeof record)
+			break;
+
+		recordofs[record.texnum] = ofs;
+		ofs += sizeof record + record.size;
+	}
+
+	*intact = (ofs == end);
+	return f;
+}
+
+// Checks a texture's disk cache record still matches its definition.
+static boolean R_ReadTextureRecord(FILE *f, long ofs, INT32 texnum, size_t *size, boolean *holey)
+{
+	texture_t *texture = textures[texnum];
+	texcacherecord_t record;
+
+	if (fseek(f, ofs, SEEK_SET) || fread(&record, sizeof record, 1, f) != 1)
+		return false;
+
+	if (LONG(record.texnum) != texnum || strncmp(record.name, texture->name, 8)
+		|| SHORT(record.width) != texture->width || SHORT(record.height) != texture->height
+		|| (record.holey && texture->patchcount != 1))
+		return false;
+
+	*holey = (record.holey != 0);
+
+	// Only single patch textures can be holey, and it's cheap to check
+	// their one patch rather than take the file's word for it.
+	if (texture->patchcount == 1)
+	{
+		patch_t *patch = W_CacheLumpNumPwad(texture->patches[0].wad, texture->patches[0].lump, PU_CACHE);
+		if (R_TextureHasHoles(texture, &patch) != *holey)
+			return false;
+	}
+
+	*size = R_TextureBlockSize(texture, *holey);
+	return ((size_t)LONG(record.size) == *size);
+}
+
+//
+// R_CheckTextureBlock
+//
+// Makes sure a texture read from the disk cache can't send R_GetColumn or
+// the column drawers outside of its block: every column offset has to land
+// inside it, and for holey textures every post has to end inside it too.
+//
+static boolean R_CheckTextureBlock(texture_t *texture, const UINT8 *block, size_t size, boolean holey)
+{
+	const UINT8 *colofs = holey ? block + 8 : block;
+	size_t ofs, colstart = (holey ? 8 : 0) + (size_t)texture->width * 4;
+	INT32 x;
+
+	if (colstart > size)
+		return false;
+
+	for (x = 0; x < texture->width; x++)
+	{
+		ofs = LONG(*(const UINT32 *)&colofs[x<<2]);
+
+		if (!holey)
+		{
+			if (ofs < colstart || ofs + texture->height > size)
+				return false;
+			continue;
+		}
+
+		// Holey columns point just past a post's header.
+		if (ofs < colstart + 3)
+			return false;
+		for (ofs -= 3; ofs < size && block[ofs] != 0xff; ofs += block[ofs + 1] + 4)
+		{
+			if (ofs + 1 >= size || ofs + block[ofs + 1] + 4 > size)
+				return false;
+		}
+		if (ofs >= size)
+			return false;
+	}
+
+	return true;
+}
+
+//
+// R_WriteTextureCache
+//
+// Adds the textures that were just composited to the disk cache, or if
+// it wasn't usable, starts a new one with everything in the atlas.
+//
+static void R_WriteTextureCache(const UINT8 *key, boolean append)
+{
+	texcacheheader_t header;
+	texcacherecord_t record;
+	texturejob_t *job;
+	const char *path;
+	INT32 i;
+	FILE *f;
+
+	I_mkdir(va("%s"PATHSEP TEXCACHEDIR, srb2home), 0755);
+
+	path = R_TextureCachePath(key);
+	f = fopen(path, append ? "ab" : "wb");
+	if (!f)
+	{
+		CONS_Debug(DBG_SETUP, "Couldn't write texture cache %s\n", path);
+		return;
+	}
+
+	if (!append)
+	{
+		memset(&header, 0, sizeof header);
+		memcpy(header.magic, TEXCACHEMAGIC, sizeof header.magic);
+		memcpy(header.key, key, sizeof header.key);
+		header.numtextures = LONG(numtextures);
+		fwrite(&header, sizeof header, 1, f);
+	}
+
+	for (i = 0, job = texturejobs; i < numtexturejobs; i++, job++)
+	{
+		texture_t *texture = textures[job->texnum];
+
+		if (append && !job->patches)
+			continue;
+
+		memset(&record, 0, sizeof record);
+		memcpy(record.name, texture->name, sizeof record.name);
+		record.texnum = LONG(job->texnum);
+		record.width = SHORT(texture->width);
+		record.height = SHORT(texture->height);
+		record.size = LONG((UINT32)job->size);
+		record.holey = (UINT8)job->holey;
+
+		if (fwrite(&record, sizeof record, 1, f) != 1 || fwrite(job->block, 1, job->size, f) != job->size)
+			break;
+	}
+
+	fclose(f);
+}
+
+//
+// R_PrecacheTextures
+//
+// Builds every texture the level shows, that isn't cached already, into
+// the texture atlas. Textures found in the disk cache are read from it,
+// and the rest are composited on worker threads, then saved there.
+//
+static void R_PrecacheTextures(const char *texturepresent)
+{
+	precise_t precachestart = I_GetPreciseTime();
+	texturejob_t *job;
+	INT32 i, j, numcomposite = 0, threads = 0;
+	size_t atlassize = 0;
+	UINT8 key[16];
+	long *recordofs = NULL;
+	boolean intact = false;
+	FILE *cachefile = NULL;
+
+	// The wads can't be told apart without their sums.
+#ifdef NOMD5
+	const boolean usecache = false;
+#else
+	const boolean usecache = !M_CheckParm("-notexcache");
+#endif
+
+	R_FreeTextureAtlas();
+
+	texturejobs = Z_Calloc(numtextures * sizeof (*texturejobs), PU_STATIC, NULL);
+	numtexturejobs = 0;
+
+	if (usecache)
+	{
+		recordofs = Z_Calloc(numtextures * sizeof (*recordofs), PU_STATIC, NULL);
+		R_TextureCacheKey(key);
+		cachefile = R_OpenTextureCache(key, recordofs, &intact);
+	}
+
+	// Work out where everything goes.
+	for (j = 0; j < numtextures; j++)
+	{
+		texture_t *texture = textures[j];
+
+		if (!texturepresent[j] || texturecache[j])
+			continue;
+
+		job = &texturejobs[numtexturejobs++];
+		job->texnum = j;
+
+		if (cachefile && recordofs[j] && R_ReadTextureRecord(cachefile, recordofs[j], j, &job->size, &job->holey))
+			job->fileofs = recordofs[j] + sizeof (texcacherecord_t);
+		else
+		{
+			job->patches = Z_Malloc(texture->patchcount * sizeof (*job->patches), PU_STATIC, NULL);
+			for (i = 0; i < texture->patchcount; i++)
+				job->patches[i] = W_CacheLumpNumPwad(texture->patches[i].wad, texture->patches[i].lump, PU_STATIC);
+
+			job->holey = R_TextureHasHoles(texture, job->patches);
+			job->size = R_TextureBlockSize(texture, job->holey);
+			numcomposite++;
+		}
+
+		job->ofs = atlassize;
+		atlassize += (job->size + 7) & ~(size_t)7;
+	}
+
+	if (numtexturejobs)
+	{
+		textureatlas = Z_Malloc(atlassize, PU_STATIC, NULL);
+		textureatlassize = atlassize;
+
+		for (i = 0, job = texturejobs; i < numtexturejobs; i++, job++)
+		{
+			texture_t *texture = textures[job->texnum];
+
+			job->block = textureatlas + job->ofs;
+			if (!job->fileofs)
+				continue;
+
+			if (!fseek(cachefile, job->fileofs, SEEK_SET) && fread(job->block, 1, job->size, cachefile) == job->size
+				&& R_CheckTextureBlock(texture, job->block, job->size, job->holey))
+				continue;
+
+			// Couldn't read it after all, or it's broken, so build it like the rest.
+			job->fileofs = 0;
+			job->patches = Z_Malloc(texture->patchcount * sizeof (*job->patches), PU_STATIC, NULL);
+			for (j = 0; j < texture->patchcount; j++)
+				job->patches[j] = W_CacheLumpNumPwad(texture->patches[j].wad, texture->patches[j].lump, PU_STATIC);
+			numcomposite++;
+			intact = false;
+		}
+
+		if (numcomposite)
+			threads = R_RunTextureJobs(numcomposite);
+
+		for (i = 0, job = texturejobs; i < numtexturejobs; i++, job++)
+		{
+			texture_t *texture = textures[job->texnum];
+
+			texture->holes = job->holey;
+			texturecolumnofs[job->texnum] = (UINT32 *)(job->holey ? job->block + 8 : job->block);
+			texturecache[job->texnum] = job->block;
+			texturememory += job->size;
+		}
+	}
+
+	if (cachefile)
+		fclose(cachefile);
+
+	if (usecache && numcomposite)
+		R_WriteTextureCache(key, (cachefile && intact));
+
+	for (i = 0, job = texturejobs; i < numtexturejobs; i++, job++)
+	{
+		if (!job->patches)
+			continue;
+
+		for (j = 0; j < textures[job->texnum]->patchcount; j++)
+			Z_ChangeTag(job->patches[j], PU_CACHE);
+		Z_Free(job->patches);
+	}
+
+	CONS_Debug(DBG_SETUP, "Precached %d textures (%d composited on %d threads, %d from the disk cache) in %.2f ms\n",
+		numtexturejobs, numcomposite, threads, numtexturejobs - numcomposite,
+		(I_GetPreciseTime() - precachestart) * 1000.0 / I_GetPrecisePrecision());
+
+	Z_Free(recordofs);
+	Z_Free(texturejobs);
+	texturejobs = NULL;
+	numtexturejobs = 0;
+}
+
 //
 // R_PrecacheLevel
 //
@@ -1638,17 +2198,11 @@ void R_PrecacheLevel(void)
 	// while the sky texture is stored like a wall texture, with a skynum dependent name.
 	texturepresent[skytexture] = 1;
 
-	texturememory = 0;
-	for (j = 0; j < (unsigned)numtextures; j++)
-	{
-		if (!texturepresent[j])
-			continue;
+	// So are the rest of the frames of anything animated.
+	P_MarkAnimatedTextures(texturepresent);
 
-		if (!texturecache[j])
-			R_GenerateTexture(j);
-		// pre-caching individual patches that compose textures became obsolete,
-		// since we cache entire composite textures
-	}
+	texturememory = 0;
+	R_PrecacheTextures(texturepresent);
 	free(texturepresent);
 
 	//
@@ -1657,7 +2211,7 @@ void R_PrecacheLevel(void)
 	spritepresent = calloc(numsprites, sizeof (*spritepresent));
 	if (spritepresent == NULL) I_Error("%s: Out of memory looking up sprites", "R_PrecacheLevel");
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
 			spritepresent[((mobj_t *)th)->sprite] = 1;
 
@@ -1688,3 +2242,81 @@ void R_PrecacheLevel(void)
 			"texturememory: %s k\n"
 			"spritememory:  %s k\n", sizeu1(flatmemory>>10), sizeu2(texturememory>>10), sizeu3(spritememory>>10));
 }
+
+//
+// R_PrefetchLevelTextures
+//
+// Queues the flats and wall texture patches the level uses to be inflated
+// in the background, while the rest of the level gets set up.
+//
+void R_PrefetchLevelTextures(void)
+{
+	size_t i;
+	INT32 j, k, tex[3];
+	char *texturepresent;
+
+	for (i = 0; i < numlevelflats; i++)
+		W_PrefetchLumpNum(levelflats[i].lumpnum);
+
+	texturepresent = calloc(numtextures, sizeof (*texturepresent));
+	if (texturepresent == NULL)
+		return; // no big deal, they'll just be read when needed
+
+	for (i = 0; i < numsides; i++)
+	{
+		tex[0] = sides[i].toptexture;
+		tex[1] = sides[i].midtexture;
+		tex[2] = sides[i].bottomtexture;
+		for (k = 0; k < 3; k++)
+			if (tex[k] >= 0 && tex[k] < numtextures)
+				texturepresent[tex[k]] = 1;
+	}
+	if (skytexture >= 0 && skytexture < numtextures)
+		texturepresent[skytexture] = 1;
+	P_MarkAnimatedTextures(texturepresent);
+
+	for (j = 0; j < numtextures; j++)
+	{
+		if (!texturepresent[j] || texturecache[j])
+			continue;
+
+		for (k = 0; k < textures[j]->patchcount; k++)
+			W_PrefetchLumpPwad(textures[j]->patches[k].wad, textures[j]->patches[k].lump);
+	}
+	free(texturepresent);
+}
+
+//
+// R_PrefetchLevelSprites
+//
+// Same as above, for every frame of the sprites the spawned things use.
+//
+void R_PrefetchLevelSprites(void)
+{
+	char *spritepresent;
+	size_t i, j, k;
+	thinker_t *th;
+	spriteframe_t *sf;
+
+	spritepresent = calloc(numsprites, sizeof (*spritepresent));
+	if (spritepresent == NULL)
+		return;
+
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
+			spritepresent[((mobj_t *)th)->sprite] = 1;
+
+	for (i = 0; i < numsprites; i++)
+	{
+		if (!spritepresent[i])
+			continue;
+
+		for (j = 0; j < sprites[i].numframes; j++)
+		{
+			sf = &sprites[i].spriteframes[j];
+			for (k = 0; k < 8; k++)
+				W_PrefetchLumpNum(sf->lumppat[k]);
+		}
+	}
+	free(spritepresent);
+}
@@ -76,6 +76,8 @@ UINT8 *R_GetFlat(lumpnum_t flatnum);
 // I/O, setting up the stuff.
 void R_InitData(void);
 void R_PrecacheLevel(void);
+void R_PrefetchLevelTextures(void);
+void R_PrefetchLevelSprites(void);
 
 // Retrieval.
 // Floor/ceiling opaque texture tiles,
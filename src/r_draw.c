@@ -26,6 +26,38 @@
 #include "z_zone.h"
 #include "console.h" // Until buffering gets finished
 #include "k_kart.h" // SRB2kart
+#include "g_game.h" // playeringame
+#include "i_system.h" // I_GetPreciseTime
+#include "i_time.h"
+
+#ifdef SIMDDRAW_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef SIMDDRAW_AVX2
+#include <immintrin.h>
+#endif
+#ifdef SIMDDRAW_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef HAVE_THREADS
+#include "i_threads.h"
+#endif
+
+#ifdef THREADEDRENDER
+static I_mutex translation_mutex;
+#  define Lock_translations()   do { if (viewthreadsactive) I_lock_mutex(&translation_mutex); } while (0)
+#  define Unlock_translations() do { if (viewthreadsactive) I_unlock_mutex(translation_mutex); } while (0)
+
+static I_mutex tiltcheck_mutex;
+#  define Lock_tiltcheck()   do { if (viewthreadsactive) I_lock_mutex(&tiltcheck_mutex); } while (0)
+#  define Unlock_tiltcheck() do { if (viewthreadsactive) I_unlock_mutex(tiltcheck_mutex); } while (0)
+#else
+#  define Lock_translations()
+#  define Unlock_translations()
+#  define Lock_tiltcheck()
+#  define Unlock_tiltcheck()
+#endif
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -37,11 +69,12 @@
 
 /**	\brief view info
 */
-INT32 viewwidth, scaledviewwidth, viewheight, viewwindowx, viewwindowy;
+INT32 viewwidth, scaledviewwidth, viewheight;
+THREADLOCAL INT32 viewwindowx, viewwindowy;
 
 /**	\brief pointer to the start of each line of the screen,
 */
-UINT8 *ylookup[MAXVIDHEIGHT*4];
+THREADLOCAL UINT8 *ylookup[MAXVIDHEIGHT*4];
 
 /**	\brief pointer to the start of each line of the screen, for view1 (splitscreen)
 */
@@ -64,19 +97,19 @@ UINT8 *ylookup4[MAXVIDHEIGHT*4];
 */
 INT32 columnofs[MAXVIDWIDTH*4];
 
-UINT8 *topleft;
+THREADLOCAL UINT8 *topleft;
 
 // =========================================================================
 //                      COLUMN DRAWING CODE STUFF
 // =========================================================================
 
-lighttable_t *dc_colormap;
-INT32 dc_x = 0, dc_yl = 0, dc_yh = 0;
+THREADLOCAL lighttable_t *dc_colormap;
+THREADLOCAL INT32 dc_x = 0, dc_yl = 0, dc_yh = 0;
 
-fixed_t dc_iscale, dc_texturemid;
-UINT8 dc_hires; // under MSVC boolean is a byte, while on other systems, it a bit,
+THREADLOCAL fixed_t dc_iscale, dc_texturemid;
+THREADLOCAL UINT8 dc_hires; // under MSVC boolean is a byte, while on other systems, it a bit,
                // soo lets make it a byte on all system for the ASM code
-UINT8 *dc_source;
+THREADLOCAL UINT8 *dc_source;
 
 // -----------------------
 // translucency stuff here
@@ -87,7 +120,7 @@ UINT8 *transtables; // translucency tables
 
 /**	\brief R_DrawTransColumn uses this
 */
-UINT8 *dc_transmap; // one of the translucency tables
+THREADLOCAL UINT8 *dc_transmap; // one of the translucency tables
 
 // ----------------------
 // translation stuff here
@@ -96,30 +129,30 @@ UINT8 *dc_transmap; // one of the translucency tables
 
 /**	\brief R_DrawTranslatedColumn uses this
 */
-UINT8 *dc_translation;
+THREADLOCAL UINT8 *dc_translation;
 
-struct r_lightlist_s *dc_lightlist = NULL;
-INT32 dc_numlights = 0, dc_maxlights, dc_texheight;
+THREADLOCAL struct r_lightlist_s *dc_lightlist = NULL;
+THREADLOCAL INT32 dc_numlights = 0, dc_maxlights, dc_texheight;
 
 // =========================================================================
 //                      SPAN DRAWING CODE STUFF
 // =========================================================================
 
-INT32 ds_y, ds_x1, ds_x2;
-lighttable_t *ds_colormap;
-fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
+THREADLOCAL INT32 ds_y, ds_x1, ds_x2;
+THREADLOCAL lighttable_t *ds_colormap;
+THREADLOCAL fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
 
-UINT8 *ds_source; // start of a 64*64 tile image
-UINT8 *ds_transmap; // one of the translucency tables
+THREADLOCAL UINT8 *ds_source; // start of a 64*64 tile image
+THREADLOCAL UINT8 *ds_transmap; // one of the translucency tables
 
-pslope_t *ds_slope; // Current slope being used
-floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
-float focallengthf, zeroheight;
+THREADLOCAL pslope_t *ds_slope; // Current slope being used
+THREADLOCAL floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
+THREADLOCAL float focallengthf, zeroheight;
 
 /**	\brief Variable flat sizes
 */
 
-UINT32 nflatxshift, nflatyshift, nflatshiftup, nflatmask;
+THREADLOCAL UINT32 nflatxshift, nflatyshift, nflatshiftup, nflatmask;
 
 // ==========================================================================
 //                        OLD DOOM FUZZY EFFECT
@@ -142,6 +175,48 @@ UINT32 nflatxshift, nflatyshift, nflatshiftup, nflatmask;
 
 static UINT8** translationtablecache[TT_CACHE_SIZE] = {NULL};
 
+// Cached colormaps are kept in one slab of fixed size slots. Once every
+// slot is taken, the one that's gone unused longest gets reused, provided
+// it's been a second since it was drawn with and nobody kept its address.
+// Otherwise, and always in OpenGL, which keys its patch caches by colormap,
+// extra ones get their own PU_LEVEL blocks, like before. Slots dropped from
+// the cache mid-level stay taken until R_ResetTranslationColormapCache.
+#define TRANSLATIONSLOTS 512
+#define TRANSLATIONIDLETICS TICRATE
+
+typedef struct
+{
+	INT16 skintableindex;
+	UINT8 color;
+	tic_t lastused;
+	boolean kept; // its address may still be held, so it can't be reused
+} translationslot_t;
+
+static UINT8 *translationslab;
+static translationslot_t translationslots[TRANSLATIONSLOTS];
+static INT32 numtranslationslots;
+
+static UINT32 translationhits, translationmisses, translationevictions, translationoverflows;
+
+// Colormaps the players are going to need are built in the background
+// while the level loads. Nothing is read from the cache until it's done.
+typedef struct
+{
+	INT32 skinnum;
+	UINT8 color;
+	UINT8 *colormap;
+} translationjob_t;
+
+static translationjob_t translationjobs[TRANSLATIONSLOTS];
+static INT32 numtranslationjobs;
+static boolean translationprebuild;
+
+#ifdef HAVE_THREADS
+static I_mutex prebuild_mutex;
+static I_cond prebuild_cond;
+static boolean prebuildrunning;
+#endif
+
 
 // See also the enum skincolors_t
 // TODO Callum: Can this be translated?
@@ -511,11 +586,86 @@ static void R_GenerateTranslationColormap(UINT8 *dest_colormap, INT32 skinnum, U
 }
 */
 
+static INT32 R_TranslationCacheIndex(INT32 skinnum)
+{
+	if (skinnum == TC_DEFAULT) return DEFAULT_TT_CACHE_INDEX;
+	else if (skinnum == TC_BOSS) return BOSS_TT_CACHE_INDEX;
+	else if (skinnum == TC_METALSONIC) return METALSONIC_TT_CACHE_INDEX;
+	else if (skinnum == TC_ALLWHITE) return ALLWHITE_TT_CACHE_INDEX;
+	else if (skinnum == TC_RAINBOW) return RAINBOW_TT_CACHE_INDEX;
+	else if (skinnum == TC_BLINK) return BLINK_TT_CACHE_INDEX;
+	return skinnum;
+}
+
+/**	\brief	Waits for R_PrebuildTranslationColormaps to finish, if it's running.
+	The palette mustn't change before then, as the colormaps are read from it.
+*/
+void R_FinishTranslationPrebuild(void)
+{
+	if (!translationprebuild)
+		return;
+
+#ifdef HAVE_THREADS
+	I_lock_mutex(&prebuild_mutex);
+	while (prebuildrunning)
+		I_hold_cond(&prebuild_cond, prebuild_mutex);
+	I_unlock_mutex(prebuild_mutex);
+#endif
+
+	translationprebuild = false;
+}
+
+/**	\brief	Finds a slot for a colormap to be cached in.
+
+	\param	skintableindex	translationtablecache index it's for
+	\param	color	translation color
+
+	\return	Slot, or NULL if the slab is full and nothing can be evicted.
+*/
+static UINT8 *R_AllocTranslationSlot(INT32 skintableindex, UINT8 color)
+{
+	translationslot_t *slot;
+	const tic_t now = I_GetTime();
+	INT32 i, oldest;
+
+	if (!translationslab)
+		translationslab = Z_MallocAlign(TRANSLATIONSLOTS * NUM_PALETTE_ENTRIES, PU_STATIC, NULL, 8);
+
+	if (numtranslationslots < TRANSLATIONSLOTS)
+		i = numtranslationslots++;
+	else
+	{
+		if (rendermode != render_soft)
+			return NULL;
+
+		for (i = 0, oldest = -1; i < TRANSLATIONSLOTS; i++)
+			if (!translationslots[i].kept
+			&& (oldest == -1 || translationslots[i].lastused < translationslots[oldest].lastused))
+				oldest = i;
+
+		if (oldest == -1 || now - translationslots[oldest].lastused < TRANSLATIONIDLETICS)
+			return NULL;
+
+		i = oldest;
+		slot = &translationslots[i];
+		translationtablecache[slot->skintableindex][slot->color] = NULL;
+		translationevictions++;
+	}
+
+	slot = &translationslots[i];
+	slot->skintableindex = (INT16)skintableindex;
+	slot->color = color;
+	slot->lastused = now;
+	slot->kept = false;
+	return translationslab + i * NUM_PALETTE_ENTRIES;
+}
+
 /**	\brief	Retrieves a translation colormap from the cache.
 
 	\param	skinnum	number of skin, TC_DEFAULT or TC_BOSS
 	\param	color	translation color
-	\param	flags	set GTC_CACHE to use the cache
+	\param	flags	set GTC_CACHE to use the cache, and GTC_KEEP as well
+			if the colormap is held onto past this frame
 
 	\return	Colormap. If not cached, caller should Z_Free.
 */
@@ -524,46 +674,63 @@ UINT8* R_GetTranslationColormap(INT32 skinnum, skincolors_t color, UINT8 flags)
 	UINT8* ret;
 	INT32 skintableindex;
 
-	// Adjust if we want the default colormap
-	if (skinnum == TC_DEFAULT) skintableindex = DEFAULT_TT_CACHE_INDEX;
-	else if (skinnum == TC_BOSS) skintableindex = BOSS_TT_CACHE_INDEX;
-	else if (skinnum == TC_METALSONIC) skintableindex = METALSONIC_TT_CACHE_INDEX;
-	else if (skinnum == TC_ALLWHITE) skintableindex = ALLWHITE_TT_CACHE_INDEX;
-	else if (skinnum == TC_RAINBOW) skintableindex = RAINBOW_TT_CACHE_INDEX;
-	else if (skinnum == TC_BLINK) skintableindex = BLINK_TT_CACHE_INDEX;
-	else skintableindex = skinnum;
-
-	if (flags & GTC_CACHE)
+	if (!(flags & GTC_CACHE))
 	{
+		ret = Z_MallocAlign(NUM_PALETTE_ENTRIES, PU_STATIC, NULL, 8);
+		K_GenerateKartColormap(ret, skinnum, color);
+		return ret;
+	}
 
-		// Allocate table for skin if necessary
-		if (!translationtablecache[skintableindex])
-			translationtablecache[skintableindex] = Z_Calloc(MAXTRANSLATIONS * sizeof(UINT8**), PU_STATIC, NULL);
+	// Adjust if we want the default colormap
+	skintableindex = R_TranslationCacheIndex(skinnum);
 
-		// Get colormap
-		ret = translationtablecache[skintableindex][color];
-	}
-	else ret = NULL;
+	Lock_translations();
+
+	R_FinishTranslationPrebuild();
 
-	// Generate the colormap if necessary
-	if (!ret)
+	// Allocate table for skin if necessary
+	if (!translationtablecache[skintableindex])
+		translationtablecache[skintableindex] = Z_Calloc(MAXTRANSLATIONS * sizeof(UINT8**), PU_STATIC, NULL);
+
+	// Get colormap
+	ret = translationtablecache[skintableindex][color];
+
+	if (ret)
+		translationhits++;
+	else
 	{
-		ret = Z_MallocAlign(NUM_PALETTE_ENTRIES, (flags & GTC_CACHE) ? PU_LEVEL : PU_STATIC, NULL, 8);
+		// Generate the colormap
+		translationmisses++;
+		ret = R_AllocTranslationSlot(skintableindex, (UINT8)color);
+		if (!ret)
+		{
+			translationoverflows++;
+			ret = Z_MallocAlign(NUM_PALETTE_ENTRIES, PU_LEVEL, NULL, 8);
+		}
 		K_GenerateKartColormap(ret, skinnum, color); //R_GenerateTranslationColormap(ret, skinnum, color);		// SRB2kart
 
-		// Cache the colormap if desired
-		if (flags & GTC_CACHE)
-			translationtablecache[skintableindex][color] = ret;
+		translationtablecache[skintableindex][color] = ret;
+	}
+
+	if (ret >= translationslab && ret < translationslab + TRANSLATIONSLOTS * NUM_PALETTE_ENTRIES)
+	{
+		translationslot_t *slot = &translationslots[(ret - translationslab) / NUM_PALETTE_ENTRIES];
+		slot->lastused = I_GetTime();
+		if (flags & GTC_KEEP)
+			slot->kept = true;
 	}
 
+	Unlock_translations();
+
 	return ret;
 }
 
 /**	\brief	Flushes cache of translation colormaps.
 
 	Flushes cache of translation colormaps, but doesn't actually free the
-	colormaps themselves. These are freed when PU_LEVEL blocks are purged,
-	at or before which point, this function should be called.
+	colormaps themselves. Their slots aren't reused before
+	R_ResetTranslationColormapCache, so anything still holding one, like
+	OpenGL's patch cache, doesn't end up with another colormap.
 
 	\return	void
 */
@@ -571,9 +738,128 @@ void R_FlushTranslationColormapCache(void)
 {
 	INT32 i;
 
+	R_FinishTranslationPrebuild();
+
 	for (i = 0; i < (INT32)(sizeof(translationtablecache) / sizeof(translationtablecache[0])); i++)
 		if (translationtablecache[i])
 			memset(translationtablecache[i], 0, MAXTRANSLATIONS * sizeof(UINT8**));
+
+	for (i = 0; i < numtranslationslots; i++)
+		translationslots[i].kept = true;
+}
+
+/**	\brief	Flushes cache of translation colormaps and frees all of its
+	slots. Overflowed colormaps are freed when PU_LEVEL blocks are purged,
+	at or before which point, this function should be called.
+
+	\return	void
+*/
+void R_ResetTranslationColormapCache(void)
+{
+	R_FlushTranslationColormapCache();
+	numtranslationslots = 0;
+}
+
+static void R_BuildTranslationJobs(void)
+{
+	INT32 i;
+
+	for (i = 0; i < numtranslationjobs; i++)
+		K_GenerateKartColormap(translationjobs[i].colormap, translationjobs[i].skinnum, translationjobs[i].color);
+}
+
+#ifdef HAVE_THREADS
+static void R_PrebuildWorker(void *userdata)
+{
+	(void)userdata;
+
+	R_BuildTranslationJobs();
+
+	I_lock_mutex(&prebuild_mutex);
+	prebuildrunning = false;
+	I_wake_all_cond(&prebuild_cond);
+	I_unlock_mutex(prebuild_mutex);
+}
+#endif
+
+static void R_QueueTranslation(INT32 skinnum, UINT8 color)
+{
+	const INT32 skintableindex = R_TranslationCacheIndex(skinnum);
+	translationjob_t *job;
+	UINT8 *colormap;
+
+	if (color == SKINCOLOR_NONE || color >= MAXTRANSLATIONS)
+		return;
+
+	if (!translationtablecache[skintableindex])
+		translationtablecache[skintableindex] = Z_Calloc(MAXTRANSLATIONS * sizeof(UINT8**), PU_STATIC, NULL);
+	else if (translationtablecache[skintableindex][color])
+		return;
+
+	colormap = R_AllocTranslationSlot(skintableindex, color);
+	if (!colormap)
+		return;
+
+	job = &translationjobs[numtranslationjobs++];
+	job->skinnum = skinnum;
+	job->color = color;
+	job->colormap = colormap;
+
+	// Not read until the build is finished.
+	translationtablecache[skintableindex][color] = colormap;
+}
+
+/**	\brief	Builds the colormaps for every player's skin and color, and
+	every invincibility color, on a worker thread while the level loads.
+	Call after R_ResetTranslationColormapCache.
+*/
+void R_PrebuildTranslationColormaps(void)
+{
+	INT32 i;
+	UINT8 color;
+
+	R_FinishTranslationPrebuild();
+
+	numtranslationjobs = 0;
+
+	for (i = 0; i < MAXPLAYERS; i++)
+	{
+		if (!playeringame[i])
+			continue;
+
+		if (players[i].skin >= 0 && players[i].skin < numskins)
+			R_QueueTranslation(players[i].skin, players[i].skincolor);
+		R_QueueTranslation(TC_DEFAULT, players[i].skincolor);
+	}
+
+	for (color = 1; color < MAXSKINCOLORS; color++)
+		R_QueueTranslation(TC_RAINBOW, color);
+
+	if (!numtranslationjobs)
+		return;
+
+	translationprebuild = true;
+
+#ifdef HAVE_THREADS
+	prebuildrunning = true;
+	I_spawn_thread("translation-prebuild", R_PrebuildWorker, NULL);
+#else
+	R_BuildTranslationJobs();
+#endif
+}
+
+/**	\brief	Prints how well the translation colormap cache is doing.
+*/
+void R_PrintTranslationStats(void)
+{
+	const UINT32 lookups = translationhits + translationmisses;
+
+	CONS_Printf(M_GetText("Translation colormaps: %d of %d slots used (%s KB)\n"),
+		numtranslationslots, TRANSLATIONSLOTS, sizeu1((TRANSLATIONSLOTS * NUM_PALETTE_ENTRIES) >> 10));
+	CONS_Printf(M_GetText("%u hits, %u misses (%u%% hit), %u evicted, %u overflowed\n"),
+		translationhits, translationmisses,
+		lookups ? (UINT32)((UINT64)translationhits * 100 / lookups) : 0,
+		translationevictions, translationoverflows);
 }
 
 /*
@@ -812,6 +1098,7 @@ void R_DrawViewBorder(void)
 // ==========================================================================
 
 #include "r_draw8.c"
+#include "r_draw8_simd.c"
 
 // ==========================================================================
 //                   INCLUDE 16bpp DRAWING CODE HERE
@@ -19,62 +19,62 @@
 // -------------------------------
 // COMMON STUFF FOR 8bpp AND 16bpp
 // -------------------------------
-extern UINT8 *ylookup[MAXVIDHEIGHT*4];
+extern THREADLOCAL UINT8 *ylookup[MAXVIDHEIGHT*4];
 extern UINT8 *ylookup1[MAXVIDHEIGHT*4];
 extern UINT8 *ylookup2[MAXVIDHEIGHT*4];
 extern UINT8 *ylookup3[MAXVIDHEIGHT*4];
 extern UINT8 *ylookup4[MAXVIDHEIGHT*4];
 extern INT32 columnofs[MAXVIDWIDTH*4];
-extern UINT8 *topleft;
+extern THREADLOCAL UINT8 *topleft;
 
 // -------------------------
 // COLUMN DRAWING CODE STUFF
 // -------------------------
 
-extern lighttable_t *dc_colormap;
-extern INT32 dc_x, dc_yl, dc_yh;
-extern fixed_t dc_iscale, dc_texturemid;
-extern UINT8 dc_hires;
+extern THREADLOCAL lighttable_t *dc_colormap;
+extern THREADLOCAL INT32 dc_x, dc_yl, dc_yh;
+extern THREADLOCAL fixed_t dc_iscale, dc_texturemid;
+extern THREADLOCAL UINT8 dc_hires;
 
-extern UINT8 *dc_source; // first pixel in a column
+extern THREADLOCAL UINT8 *dc_source; // first pixel in a column
 
 // translucency stuff here
 extern UINT8 *transtables; // translucency tables, should be (*transtables)[5][256][256]
-extern UINT8 *dc_transmap;
+extern THREADLOCAL UINT8 *dc_transmap;
 
 // translation stuff here
 
-extern UINT8 *dc_translation;
+extern THREADLOCAL UINT8 *dc_translation;
 
-extern struct r_lightlist_s *dc_lightlist;
-extern INT32 dc_numlights, dc_maxlights;
+extern THREADLOCAL struct r_lightlist_s *dc_lightlist;
+extern THREADLOCAL INT32 dc_numlights, dc_maxlights;
 
 //Fix TUTIFRUTI
-extern INT32 dc_texheight;
+extern THREADLOCAL INT32 dc_texheight;
 
 // -----------------------
 // SPAN DRAWING CODE STUFF
 // -----------------------
 
-extern INT32 ds_y, ds_x1, ds_x2;
-extern lighttable_t *ds_colormap;
-extern fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
-extern UINT8 *ds_source; // start of a 64*64 tile image
-extern UINT8 *ds_transmap;
+extern THREADLOCAL INT32 ds_y, ds_x1, ds_x2;
+extern THREADLOCAL lighttable_t *ds_colormap;
+extern THREADLOCAL fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
+extern THREADLOCAL UINT8 *ds_source; // start of a 64*64 tile image
+extern THREADLOCAL UINT8 *ds_transmap;
 
 typedef struct {
 	float x, y, z;
 } floatv3_t;
 
-extern pslope_t *ds_slope; // Current slope being used
-extern floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
-extern float focallengthf, zeroheight;
+extern THREADLOCAL pslope_t *ds_slope; // Current slope being used
+extern THREADLOCAL floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
+extern THREADLOCAL float focallengthf, zeroheight;
 
 // Variable flat sizes
-extern UINT32 nflatxshift;
-extern UINT32 nflatyshift;
-extern UINT32 nflatshiftup;
-extern UINT32 nflatmask;
+extern THREADLOCAL UINT32 nflatxshift;
+extern THREADLOCAL UINT32 nflatyshift;
+extern THREADLOCAL UINT32 nflatshiftup;
+extern THREADLOCAL UINT32 nflatmask;
 
 /// \brief Top border
 #define BRDR_T 0
@@ -100,6 +100,7 @@ extern lumpnum_t viewborderlump[8];
 // ------------------------------------------------
 
 #define GTC_CACHE 1
+#define GTC_KEEP 2 // with GTC_CACHE, for colormaps held past this frame; never reused before the level ends
 #define GTC_MENUCACHE GTC_CACHE
 //@TODO Add a separate caching mechanism for menu colormaps distinct from in-level GTC_CACHE. For now this is still preferable to memory leaks...
 
@@ -114,6 +115,10 @@ extern lumpnum_t viewborderlump[8];
 void R_InitTranslationTables(void);
 UINT8* R_GetTranslationColormap(INT32 skinnum, skincolors_t color, UINT8 flags);
 void R_FlushTranslationColormapCache(void);
+void R_ResetTranslationColormapCache(void);
+void R_PrebuildTranslationColormaps(void);
+void R_FinishTranslationPrebuild(void);
+void R_PrintTranslationStats(void);
 UINT8 R_GetColorByName(const char *name);
 
 // Custom player skin translation
@@ -156,6 +161,8 @@ void R_DrawTranslatedColumn_8(void);
 void R_DrawTranslatedTranslucentColumn_8(void);
 void R_DrawSpan_8(void);
 void R_CalcTiltedLighting(fixed_t start, fixed_t end);
+#define MINTILTEDSPAN 4 // smallest cv_tiltedspansize
+void R_ToggleTiltCheck(void);
 void R_DrawTiltedSpan_8(void);
 void R_DrawTiltedTranslucentSpan_8(void);
 void R_DrawTiltedSplat_8(void);
@@ -168,6 +175,44 @@ void R_DrawFogSpan_8(void);
 void R_DrawFogColumn_8(void);
 void R_DrawColumnShadowed_8(void);
 
+// SIMD versions of the busiest drawers above. Only the texel addressing is
+// vectorised, so they draw exactly the same pixels as the C ones.
+#ifndef NOSIMDDRAW
+#if defined (__x86_64__) || defined (_M_X64)
+#define SIMDDRAW_SSE2
+#define SIMDDRAW_AVX2
+#elif defined (__aarch64__) || defined (_M_ARM64)
+#define SIMDDRAW_NEON
+#endif
+#endif
+
+#if defined (SIMDDRAW_SSE2) || defined (SIMDDRAW_NEON)
+#define SIMDDRAW
+#endif
+
+#ifdef SIMDDRAW_SSE2
+void R_DrawColumn_8_SSE2(void);
+void R_DrawTranslucentColumn_8_SSE2(void);
+void R_DrawSpan_8_SSE2(void);
+void R_DrawTranslucentSpan_8_SSE2(void);
+#endif
+
+#ifdef SIMDDRAW_AVX2
+void R_DrawColumn_8_AVX2(void);
+void R_DrawTranslucentColumn_8_AVX2(void);
+void R_DrawSpan_8_AVX2(void);
+void R_DrawTranslucentSpan_8_AVX2(void);
+#endif
+
+#ifdef SIMDDRAW_NEON
+void R_DrawColumn_8_NEON(void);
+void R_DrawTranslucentColumn_8_NEON(void);
+void R_DrawSpan_8_NEON(void);
+void R_DrawTranslucentSpan_8_NEON(void);
+#endif
+
+void R_BenchmarkDrawers(INT32 runs);
+
 // ------------------
 // 16bpp DRAWING CODE
 // ------------------
@@ -622,7 +622,7 @@ void R_DrawSpan_8 (void)
 
 // R_CalcTiltedLighting
 // Exactly what it says on the tin. I wish I wasn't too lazy to explain things properly.
-static INT32 tiltlighting[MAXVIDWIDTH];
+static THREADLOCAL INT32 tiltlighting[MAXVIDWIDTH];
 void R_CalcTiltedLighting(fixed_t start, fixed_t end)
 {
 	// ZDoom uses a different lighting setup to us, and I couldn't figure out how to adapt their version
@@ -643,162 +643,99 @@ void R_CalcTiltedLighting(fixed_t start, fixed_t end)
 	}
 }
 
+// Texel offsets for each pixel of the tilted span being drawn, and the
+// texture coordinates at the ends of each block of cv_tiltedspansize pixels.
+static THREADLOCAL INT32 tiltspots[MAXVIDWIDTH];
+static THREADLOCAL float tiltu[MAXVIDWIDTH/MINTILTEDSPAN + 8], tiltv[MAXVIDWIDTH/MINTILTEDSPAN + 8];
 
-/**	\brief The R_DrawTiltedSpan_8 function
-	Draw slopes! Holy sheit!
+// tiltcheck stats
+static boolean tiltcheck = false;
+static UINT32 tiltcheckpixels, tiltcheckwrong, tiltcheckmaxerror;
+
+/**	\brief The R_CheckTiltedSpots function
+	The "perfect" version of the tilted span, dividing at every pixel.
+	Far too slow to draw with, but tiltcheck compares the texels the
+	drawers picked with it.
 */
-void R_DrawTiltedSpan_8(void)
+static void R_CheckTiltedSpots(double iz, double uz, double vz, INT32 count)
 {
-	// x1, x2 = ds_x1, ds_x2
-	int width = ds_x2 - ds_x1;
-	double iz, uz, vz;
-	UINT32 u, v;
-	int i;
-
-	UINT8 *source;
-	UINT8 *colormap;
-	UINT8 *dest;
-
-	double startz, startu, startv;
-	double izstep, uzstep, vzstep;
-	double endz, endu, endv;
-	UINT32 stepu, stepv;
-
-	iz = ds_sz.z + ds_sz.y*(centery-ds_y) + ds_sz.x*(ds_x1-centerx);
-
-	// Lighting is simple. It's just linear interpolation from start to end
-	{
-		float planelightfloat = BASEVIDWIDTH*BASEVIDWIDTH/vid.width / (zeroheight - FIXED_TO_FLOAT(viewz)) / 21.0f;
-		float lightstart, lightend;
-
-		lightend = (iz + ds_sz.x*width) * planelightfloat;
-		lightstart = iz * planelightfloat;
-
-		R_CalcTiltedLighting(FLOAT_TO_FIXED(lightstart), FLOAT_TO_FIXED(lightend));
-		//CONS_Printf("tilted lighting %f to %f (foc %f)\n", lightstart, lightend, focallengthf);
-	}
-
-	uz = ds_su.z + ds_su.y*(centery-ds_y) + ds_su.x*(ds_x1-centerx);
-	vz = ds_sv.z + ds_sv.y*(centery-ds_y) + ds_sv.x*(ds_x1-centerx);
-
-	dest = ylookup[ds_y] + columnofs[ds_x1];
-	source = ds_source;
-	//colormap = ds_colormap;
+	const INT32 flatwidth = 1 << (32 - nflatxshift);
+	UINT32 wrong = 0, maxerror = 0;
+	INT32 i;
 
-#if 0	// The "perfect" reference version of this routine. Pretty slow.
-		// Use it only to see how things are supposed to look.
-	i = 0;
-	do
+	for (i = 0; i < count; i++)
 	{
 		double z = 1.f/iz;
-		u = (INT64)(uz*z) + viewx;
-		v = (INT64)(vz*z) + viewy;
+		UINT32 u = (INT64)(uz*z) + viewx;
+		UINT32 v = (INT64)(vz*z) + viewy;
+		INT32 spot = ((v >> nflatyshift) & nflatmask) | (u >> nflatxshift);
 
-		colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
+		if (spot != tiltspots[i])
+		{
+			// How many texels away, allowing for the flat wrapping around
+			INT32 dx = abs((spot & (flatwidth-1)) - (tiltspots[i] & (flatwidth-1)));
+			INT32 dy = abs((spot / flatwidth) - (tiltspots[i] / flatwidth));
+
+			dx = min(dx, flatwidth - dx);
+			dy = min(dy, flatwidth - dy);
+			maxerror = max(maxerror, (UINT32)max(dx, dy));
+			wrong++;
+		}
 
-		*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
-		dest++;
 		iz += ds_sz.x;
 		uz += ds_su.x;
 		vz += ds_sv.x;
-	} while (--width >= 0);
-#else
-#define SPANSIZE 16
-#define INVSPAN	0.0625f
-
-	startz = 1.f/iz;
-	startu = uz*startz;
-	startv = vz*startz;
+	}
 
-	izstep = ds_sz.x * SPANSIZE;
-	uzstep = ds_su.x * SPANSIZE;
-	vzstep = ds_sv.x * SPANSIZE;
-	//x1 = 0;
-	width++;
+	Lock_tiltcheck();
+	tiltcheckpixels += count;
+	tiltcheckwrong += wrong;
+	tiltcheckmaxerror = max(tiltcheckmaxerror, maxerror);
+	Unlock_tiltcheck();
+}
 
-	while (width >= SPANSIZE)
+/**	\brief The R_ToggleTiltCheck function
+	Starts checking the texels of every sloped plane drawn against
+	R_CheckTiltedSpots, or stops and prints how far off they were.
+*/
+void R_ToggleTiltCheck(void)
+{
+	if (!tiltcheck)
 	{
-		iz += izstep;
-		uz += uzstep;
-		vz += vzstep;
-
-		endz = 1.f/iz;
-		endu = uz*endz;
-		endv = vz*endz;
-		stepu = (INT64)((endu - startu) * INVSPAN);
-		stepv = (INT64)((endv - startv) * INVSPAN);
-		u = (INT64)(startu) + viewx;
-		v = (INT64)(startv) + viewy;
-
-		for (i = SPANSIZE-1; i >= 0; i--)
-		{
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
-			dest++;
-			u += stepu;
-			v += stepv;
-		}
-		startu = endu;
-		startv = endv;
-		width -= SPANSIZE;
+		tiltcheckpixels = tiltcheckwrong = tiltcheckmaxerror = 0;
+		tiltcheck = true;
+		CONS_Printf(M_GetText("Checking sloped planes against the reference drawer. Use tiltcheck again to stop.\n"));
+		return;
 	}
-	if (width > 0)
+
+	tiltcheck = false;
+	if (!tiltcheckpixels)
 	{
-		if (width == 1)
-		{
-			u = (INT64)(startu);
-			v = (INT64)(startv);
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
-		}
-		else
-		{
-			double left = width;
-			iz += ds_sz.x * left;
-			uz += ds_su.x * left;
-			vz += ds_sv.x * left;
-
-			endz = 1.f/iz;
-			endu = uz*endz;
-			endv = vz*endz;
-			left = 1.f/left;
-			stepu = (INT64)((endu - startu) * left);
-			stepv = (INT64)((endv - startv) * left);
-			u = (INT64)(startu) + viewx;
-			v = (INT64)(startv) + viewy;
-
-			for (; width != 0; width--)
-			{
-				colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-				*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
-				dest++;
-				u += stepu;
-				v += stepv;
-			}
-		}
+		CONS_Printf(M_GetText("No sloped planes were drawn.\n"));
+		return;
 	}
-#endif
+	CONS_Printf(M_GetText("%u of %u sloped plane pixels (%u.%02u%%) used a different texel, at most %u texels away\n"),
+		tiltcheckwrong, tiltcheckpixels,
+		(UINT32)((UINT64)tiltcheckwrong*100/tiltcheckpixels), (UINT32)((UINT64)tiltcheckwrong*10000/tiltcheckpixels % 100),
+		tiltcheckmaxerror);
 }
 
-/**	\brief The R_DrawTiltedTranslucentSpan_8 function
-	Like DrawTiltedSpan, but translucent
+/**	\brief The R_CalcTiltedSpan function
+	Works out the lighting and texel of every pixel in a tilted span.
+
+	The texture coordinates are only divided out at the ends of each
+	block of cv_tiltedspansize pixels and interpolated in between. The
+	divides for four block ends are done at once, using a reciprocal
+	estimate refined with Newton-Raphson where the CPU has one.
 */
-void R_DrawTiltedTranslucentSpan_8(void)
+static void R_CalcTiltedSpan(void)
 {
-	// x1, x2 = ds_x1, ds_x2
-	int width = ds_x2 - ds_x1;
+	const INT32 count = ds_x2 - ds_x1 + 1;
+	const INT32 spansize = cv_tiltedspansize.value;
+	const INT32 numblocks = (count + spansize - 1) / spansize;
+	const float invspan = 1.f/spansize;
 	double iz, uz, vz;
-	UINT32 u, v;
-	int i;
-
-	UINT8 *source;
-	UINT8 *colormap;
-	UINT8 *dest;
-
-	double startz, startu, startv;
-	double izstep, uzstep, vzstep;
-	double endz, endu, endv;
-	UINT32 stepu, stepv;
+	INT32 b, i, x;
 
 	iz = ds_sz.z + ds_sz.y*(centery-ds_y) + ds_sz.x*(ds_x1-centerx);
 
@@ -807,7 +744,7 @@ void R_DrawTiltedTranslucentSpan_8(void)
 		float planelightfloat = BASEVIDWIDTH*BASEVIDWIDTH/vid.width / (zeroheight - FIXED_TO_FLOAT(viewz)) / 21.0f;
 		float lightstart, lightend;
 
-		lightend = (iz + ds_sz.x*width) * planelightfloat;
+		lightend = (iz + ds_sz.x*(count-1)) * planelightfloat;
 		lightstart = iz * planelightfloat;
 
 		R_CalcTiltedLighting(FLOAT_TO_FIXED(lightstart), FLOAT_TO_FIXED(lightend));
@@ -817,245 +754,133 @@ void R_DrawTiltedTranslucentSpan_8(void)
 	uz = ds_su.z + ds_su.y*(centery-ds_y) + ds_su.x*(ds_x1-centerx);
 	vz = ds_sv.z + ds_sv.y*(centery-ds_y) + ds_sv.x*(ds_x1-centerx);
 
-	dest = ylookup[ds_y] + columnofs[ds_x1];
-	source = ds_source;
-	//colormap = ds_colormap;
+	// Texture coordinates at pixel 0, spansize, 2*spansize... and the last pixel
+#if defined (SIMDDRAW_SSE2)
+	{
+		const __m128 two = _mm_set1_ps(2.f);
+		const __m128 lanes = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+		const __m128 size = _mm_set1_ps((float)spansize);
+		const __m128 end = _mm_set1_ps((float)count);
+		const __m128 iz0 = _mm_set1_ps((float)iz), uz0 = _mm_set1_ps((float)uz), vz0 = _mm_set1_ps((float)vz);
+		const __m128 izstep = _mm_set1_ps(ds_sz.x), uzstep = _mm_set1_ps(ds_su.x), vzstep = _mm_set1_ps(ds_sv.x);
+
+		for (b = 0; b <= numblocks; b += 4)
+		{
+			__m128 p = _mm_min_ps(_mm_mul_ps(_mm_add_ps(_mm_set1_ps((float)b), lanes), size), end);
+			__m128 z = _mm_add_ps(iz0, _mm_mul_ps(p, izstep));
+			__m128 r = _mm_rcp_ps(z);
 
-#if 0	// The "perfect" reference version of this routine. Pretty slow.
-		// Use it only to see how things are supposed to look.
-	i = 0;
-	do
+			r = _mm_mul_ps(r, _mm_sub_ps(two, _mm_mul_ps(z, r))); // 12 bits -> 23
+			_mm_storeu_ps(&tiltu[b], _mm_mul_ps(_mm_add_ps(uz0, _mm_mul_ps(p, uzstep)), r));
+			_mm_storeu_ps(&tiltv[b], _mm_mul_ps(_mm_add_ps(vz0, _mm_mul_ps(p, vzstep)), r));
+		}
+	}
+#elif defined (SIMDDRAW_NEON)
 	{
-		double z = 1.f/iz;
-		u = (INT64)(uz*z) + viewx;
-		v = (INT64)(vz*z) + viewy;
+		static const float lanes[4] = {0.f, 1.f, 2.f, 3.f};
+		const float32x4_t size = vdupq_n_f32((float)spansize);
+		const float32x4_t end = vdupq_n_f32((float)count);
+		const float32x4_t iz0 = vdupq_n_f32((float)iz), uz0 = vdupq_n_f32((float)uz), vz0 = vdupq_n_f32((float)vz);
 
-		colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-		*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
-		dest++;
-		iz += ds_sz.x;
-		uz += ds_su.x;
-		vz += ds_sv.x;
-	} while (--width >= 0);
+		for (b = 0; b <= numblocks; b += 4)
+		{
+			float32x4_t p = vminq_f32(vmulq_f32(vaddq_f32(vdupq_n_f32((float)b), vld1q_f32(lanes)), size), end);
+			float32x4_t z = vmlaq_n_f32(iz0, p, ds_sz.x);
+			float32x4_t r = vrecpeq_f32(z);
+
+			r = vmulq_f32(vrecpsq_f32(z, r), r); // 8 bits -> 16
+			r = vmulq_f32(vrecpsq_f32(z, r), r); // 16 bits -> 23
+			vst1q_f32(&tiltu[b], vmulq_f32(vmlaq_n_f32(uz0, p, ds_su.x), r));
+			vst1q_f32(&tiltv[b], vmulq_f32(vmlaq_n_f32(vz0, p, ds_sv.x), r));
+		}
+	}
 #else
-#define SPANSIZE 16
-#define INVSPAN	0.0625f
-
-	startz = 1.f/iz;
-	startu = uz*startz;
-	startv = vz*startz;
+	for (b = 0; b <= numblocks; b++)
+	{
+		float p = (float)min(b*spansize, count);
+		float z = 1.f/(float)(iz + ds_sz.x*p);
 
-	izstep = ds_sz.x * SPANSIZE;
-	uzstep = ds_su.x * SPANSIZE;
-	vzstep = ds_sv.x * SPANSIZE;
-	//x1 = 0;
-	width++;
+		tiltu[b] = (float)(uz + ds_su.x*p) * z;
+		tiltv[b] = (float)(vz + ds_sv.x*p) * z;
+	}
+#endif
 
-	while (width >= SPANSIZE)
+	// Step linearly across each block
+	for (b = 0, x = 0; b < numblocks; b++)
 	{
-		iz += izstep;
-		uz += uzstep;
-		vz += vzstep;
-
-		endz = 1.f/iz;
-		endu = uz*endz;
-		endv = vz*endz;
-		stepu = (INT64)((endu - startu) * INVSPAN);
-		stepv = (INT64)((endv - startv) * INVSPAN);
-		u = (INT64)(startu) + viewx;
-		v = (INT64)(startv) + viewy;
-
-		for (i = SPANSIZE-1; i >= 0; i--)
+		const INT32 width = min(spansize, count - x);
+		const float invwidth = (width == spansize) ? invspan : 1.f/width;
+		UINT32 u = (INT64)(tiltu[b]) + viewx;
+		UINT32 v = (INT64)(tiltv[b]) + viewy;
+		UINT32 stepu = (INT64)((tiltu[b+1] - tiltu[b]) * invwidth);
+		UINT32 stepv = (INT64)((tiltv[b+1] - tiltv[b]) * invwidth);
+
+		for (i = 0; i < width; i++, x++)
 		{
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
-			dest++;
+			tiltspots[x] = ((v >> nflatyshift) & nflatmask) | (u >> nflatxshift);
 			u += stepu;
 			v += stepv;
 		}
-		startu = endu;
-		startv = endv;
-		width -= SPANSIZE;
-	}
-	if (width > 0)
-	{
-		if (width == 1)
-		{
-			u = (INT64)(startu);
-			v = (INT64)(startv);
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
-		}
-		else
-		{
-			double left = width;
-			iz += ds_sz.x * left;
-			uz += ds_su.x * left;
-			vz += ds_sv.x * left;
-
-			endz = 1.f/iz;
-			endu = uz*endz;
-			endv = vz*endz;
-			left = 1.f/left;
-			stepu = (INT64)((endu - startu) * left);
-			stepv = (INT64)((endv - startv) * left);
-			u = (INT64)(startu) + viewx;
-			v = (INT64)(startv) + viewy;
-
-			for (; width != 0; width--)
-			{
-				colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-				*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
-				dest++;
-				u += stepu;
-				v += stepv;
-			}
-		}
 	}
-#endif
+
+	if (tiltcheck)
+		R_CheckTiltedSpots(iz, uz, vz, count);
 }
 
-void R_DrawTiltedSplat_8(void)
+/**	\brief The R_DrawTiltedSpan_8 function
+	Draw slopes! Holy sheit!
+*/
+void R_DrawTiltedSpan_8(void)
 {
-	// x1, x2 = ds_x1, ds_x2
-	int width = ds_x2 - ds_x1;
-	double iz, uz, vz;
-	UINT32 u, v;
-	int i;
-
-	UINT8 *source;
-	UINT8 *colormap;
-	UINT8 *dest;
-
-	UINT8 val;
+	const INT32 count = ds_x2 - ds_x1 + 1;
+	const INT32 *lighting = &tiltlighting[ds_x1];
+	const size_t colormapofs = ds_colormap - colormaps;
+	const UINT8 *source = ds_source;
+	UINT8 *dest = ylookup[ds_y] + columnofs[ds_x1];
+	INT32 i;
 
-	double startz, startu, startv;
-	double izstep, uzstep, vzstep;
-	double endz, endu, endv;
-	UINT32 stepu, stepv;
+	R_CalcTiltedSpan();
 
-	iz = ds_sz.z + ds_sz.y*(centery-ds_y) + ds_sz.x*(ds_x1-centerx);
+	for (i = 0; i < count; i++)
+		dest[i] = planezlight[lighting[i]][colormapofs + source[tiltspots[i]]];
+}
 
-	// Lighting is simple. It's just linear interpolation from start to end
-	{
-		float planelightfloat = BASEVIDWIDTH*BASEVIDWIDTH/vid.width / (zeroheight - FIXED_TO_FLOAT(viewz)) / 21.0f;
-		float lightstart, lightend;
+/**	\brief The R_DrawTiltedTranslucentSpan_8 function
+	Like DrawTiltedSpan, but translucent
+*/
+void R_DrawTiltedTranslucentSpan_8(void)
+{
+	const INT32 count = ds_x2 - ds_x1 + 1;
+	const INT32 *lighting = &tiltlighting[ds_x1];
+	const size_t colormapofs = ds_colormap - colormaps;
+	const UINT8 *source = ds_source;
+	UINT8 *dest = ylookup[ds_y] + columnofs[ds_x1];
+	INT32 i;
 
-		lightend = (iz + ds_sz.x*width) * planelightfloat;
-		lightstart = iz * planelightfloat;
+	R_CalcTiltedSpan();
 
-		R_CalcTiltedLighting(FLOAT_TO_FIXED(lightstart), FLOAT_TO_FIXED(lightend));
-		//CONS_Printf("tilted lighting %f to %f (foc %f)\n", lightstart, lightend, focallengthf);
-	}
+	for (i = 0; i < count; i++)
+		dest[i] = *(ds_transmap + (planezlight[lighting[i]][colormapofs + source[tiltspots[i]]] << 8) + dest[i]);
+}
 
-	uz = ds_su.z + ds_su.y*(centery-ds_y) + ds_su.x*(ds_x1-centerx);
-	vz = ds_sv.z + ds_sv.y*(centery-ds_y) + ds_sv.x*(ds_x1-centerx);
+void R_DrawTiltedSplat_8(void)
+{
+	const INT32 count = ds_x2 - ds_x1 + 1;
+	const INT32 *lighting = &tiltlighting[ds_x1];
+	const size_t colormapofs = ds_colormap - colormaps;
+	const UINT8 *source = ds_source;
+	UINT8 *dest = ylookup[ds_y] + columnofs[ds_x1];
+	UINT8 val;
+	INT32 i;
 
-	dest = ylookup[ds_y] + columnofs[ds_x1];
-	source = ds_source;
-	//colormap = ds_colormap;
+	R_CalcTiltedSpan();
 
-#if 0	// The "perfect" reference version of this routine. Pretty slow.
-		// Use it only to see how things are supposed to look.
-	i = 0;
-	do
+	for (i = 0; i < count; i++)
 	{
-		double z = 1.f/iz;
-		u = (INT64)(uz*z) + viewx;
-		v = (INT64)(vz*z) + viewy;
-
-		colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-
-		val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
+		val = source[tiltspots[i]];
 		if (val != TRANSPARENTPIXEL)
-			*dest = colormap[val];
-		dest++;
-		iz += ds_sz.x;
-		uz += ds_su.x;
-		vz += ds_sv.x;
-	} while (--width >= 0);
-#else
-#define SPANSIZE 16
-#define INVSPAN	0.0625f
-
-	startz = 1.f/iz;
-	startu = uz*startz;
-	startv = vz*startz;
-
-	izstep = ds_sz.x * SPANSIZE;
-	uzstep = ds_su.x * SPANSIZE;
-	vzstep = ds_sv.x * SPANSIZE;
-	//x1 = 0;
-	width++;
-
-	while (width >= SPANSIZE)
-	{
-		iz += izstep;
-		uz += uzstep;
-		vz += vzstep;
-
-		endz = 1.f/iz;
-		endu = uz*endz;
-		endv = vz*endz;
-		stepu = (INT64)((endu - startu) * INVSPAN);
-		stepv = (INT64)((endv - startv) * INVSPAN);
-		u = (INT64)(startu) + viewx;
-		v = (INT64)(startv) + viewy;
-
-		for (i = SPANSIZE-1; i >= 0; i--)
-		{
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
-			if (val != TRANSPARENTPIXEL)
-				*dest = colormap[val];
-			dest++;
-			u += stepu;
-			v += stepv;
-		}
-		startu = endu;
-		startv = endv;
-		width -= SPANSIZE;
-	}
-	if (width > 0)
-	{
-		if (width == 1)
-		{
-			u = (INT64)(startu);
-			v = (INT64)(startv);
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
-			if (val != TRANSPARENTPIXEL)
-				*dest = colormap[val];
-		}
-		else
-		{
-			double left = width;
-			iz += ds_sz.x * left;
-			uz += ds_su.x * left;
-			vz += ds_sv.x * left;
-
-			endz = 1.f/iz;
-			endu = uz*endz;
-			endv = vz*endz;
-			left = 1.f/left;
-			stepu = (INT64)((endu - startu) * left);
-			stepv = (INT64)((endv - startv) * left);
-			u = (INT64)(startu) + viewx;
-			v = (INT64)(startv) + viewy;
-
-			for (; width != 0; width--)
-			{
-				colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-				val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
-				if (val != TRANSPARENTPIXEL)
-					*dest = colormap[val];
-				dest++;
-				u += stepu;
-				v += stepv;
-			}
-		}
+			dest[i] = planezlight[lighting[i]][colormapofs + val];
 	}
-#endif
 }
 
 /**	\brief The R_DrawSplat_8 function
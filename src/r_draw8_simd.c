@@ -0,0 +1,515 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2020 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  r_draw8_simd.c
+/// \brief SSE2/AVX2/NEON versions of the most used 8bpp drawers
+/// \note  no includes because this is included as part of r_draw.c
+///
+///        Each drawer works out the texel offsets for a whole span or
+///        column with vector adds and shifts, 8 or 16 pixels at a time,
+///        then does the texture, colormap and translucency table lookups
+///        as plain byte loads. Vector gathers would read 4 bytes per lane,
+///        which can run off the end of a flat that is still mapped from
+///        the wad, and doing the lookups the same way as r_draw8.c keeps
+///        the output identical to the C drawers. R_BenchmarkDrawers
+///        checks that.
+
+#ifdef SIMDDRAW
+
+#define SIMDSPOTS ((MAXVIDWIDTH > MAXVIDHEIGHT ? MAXVIDWIDTH : MAXVIDHEIGHT) + 16) // + room for the last vector
+
+// Texel offsets for the span or column being drawn
+static THREADLOCAL INT32 simdspots[SIMDSPOTS];
+
+typedef void (*spanspots_t)(INT32 *spots, size_t count, UINT32 xposition, UINT32 yposition, UINT32 xstep, UINT32 ystep);
+typedef void (*columnspots_t)(INT32 *spots, INT32 count, UINT32 frac, UINT32 fracstep, INT32 heightmask);
+
+// ==========================================================================
+// TEXEL OFFSETS
+// ==========================================================================
+
+// These work out the same offsets as the inner loops of R_DrawSpan_8 and
+// R_DrawColumn_8 (power of 2 textures only), and may write up to 15 past count.
+
+#ifdef SIMDDRAW_SSE2
+static FUNCTARGET("sse2") void R_SpanSpots_SSE2(INT32 *spots, size_t count, UINT32 xposition, UINT32 yposition, UINT32 xstep, UINT32 ystep)
+{
+	const __m128i xshift = _mm_cvtsi32_si128(nflatxshift);
+	const __m128i yshift = _mm_cvtsi32_si128(nflatyshift);
+	const __m128i mask = _mm_set1_epi32((INT32)nflatmask);
+	const __m128i xstep4 = _mm_set1_epi32((INT32)(xstep*4));
+	const __m128i ystep4 = _mm_set1_epi32((INT32)(ystep*4));
+	__m128i x = _mm_setr_epi32((INT32)xposition, (INT32)(xposition + xstep), (INT32)(xposition + xstep*2), (INT32)(xposition + xstep*3));
+	__m128i y = _mm_setr_epi32((INT32)yposition, (INT32)(yposition + ystep), (INT32)(yposition + ystep*2), (INT32)(yposition + ystep*3));
+	size_t i;
+
+	for (i = 0; i < count; i += 8)
+	{
+		_mm_storeu_si128((__m128i *)&spots[i], _mm_or_si128(_mm_and_si128(_mm_srl_epi32(y, yshift), mask), _mm_srl_epi32(x, xshift)));
+		x = _mm_add_epi32(x, xstep4);
+		y = _mm_add_epi32(y, ystep4);
+
+		_mm_storeu_si128((__m128i *)&spots[i+4], _mm_or_si128(_mm_and_si128(_mm_srl_epi32(y, yshift), mask), _mm_srl_epi32(x, xshift)));
+		x = _mm_add_epi32(x, xstep4);
+		y = _mm_add_epi32(y, ystep4);
+	}
+}
+
+static FUNCTARGET("sse2") void R_ColumnSpots_SSE2(INT32 *spots, INT32 count, UINT32 frac, UINT32 fracstep, INT32 heightmask)
+{
+	const __m128i mask = _mm_set1_epi32(heightmask);
+	const __m128i step4 = _mm_set1_epi32((INT32)(fracstep*4));
+	__m128i f = _mm_setr_epi32((INT32)frac, (INT32)(frac + fracstep), (INT32)(frac + fracstep*2), (INT32)(frac + fracstep*3));
+	INT32 i;
+
+	for (i = 0; i < count; i += 8)
+	{
+		_mm_storeu_si128((__m128i *)&spots[i], _mm_and_si128(_mm_srai_epi32(f, FRACBITS), mask));
+		f = _mm_add_epi32(f, step4);
+
+		_mm_storeu_si128((__m128i *)&spots[i+4], _mm_and_si128(_mm_srai_epi32(f, FRACBITS), mask));
+		f = _mm_add_epi32(f, step4);
+	}
+}
+#endif
+
+#ifdef SIMDDRAW_AVX2
+static FUNCTARGET("avx2") void R_SpanSpots_AVX2(INT32 *spots, size_t count, UINT32 xposition, UINT32 yposition, UINT32 xstep, UINT32 ystep)
+{
+	const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m128i xshift = _mm_cvtsi32_si128(nflatxshift);
+	const __m128i yshift = _mm_cvtsi32_si128(nflatyshift);
+	const __m256i mask = _mm256_set1_epi32((INT32)nflatmask);
+	const __m256i xstep8 = _mm256_set1_epi32((INT32)(xstep*8));
+	const __m256i ystep8 = _mm256_set1_epi32((INT32)(ystep*8));
+	__m256i x = _mm256_add_epi32(_mm256_set1_epi32((INT32)xposition), _mm256_mullo_epi32(lanes, _mm256_set1_epi32((INT32)xstep)));
+	__m256i y = _mm256_add_epi32(_mm256_set1_epi32((INT32)yposition), _mm256_mullo_epi32(lanes, _mm256_set1_epi32((INT32)ystep)));
+	size_t i;
+
+	for (i = 0; i < count; i += 16)
+	{
+		_mm256_storeu_si256((__m256i *)&spots[i], _mm256_or_si256(_mm256_and_si256(_mm256_srl_epi32(y, yshift), mask), _mm256_srl_epi32(x, xshift)));
+		x = _mm256_add_epi32(x, xstep8);
+		y = _mm256_add_epi32(y, ystep8);
+
+		_mm256_storeu_si256((__m256i *)&spots[i+8], _mm256_or_si256(_mm256_and_si256(_mm256_srl_epi32(y, yshift), mask), _mm256_srl_epi32(x, xshift)));
+		x = _mm256_add_epi32(x, xstep8);
+		y = _mm256_add_epi32(y, ystep8);
+	}
+}
+
+static FUNCTARGET("avx2") void R_ColumnSpots_AVX2(INT32 *spots, INT32 count, UINT32 frac, UINT32 fracstep, INT32 heightmask)
+{
+	const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i mask = _mm256_set1_epi32(heightmask);
+	const __m256i step8 = _mm256_set1_epi32((INT32)(fracstep*8));
+	__m256i f = _mm256_add_epi32(_mm256_set1_epi32((INT32)frac), _mm256_mullo_epi32(lanes, _mm256_set1_epi32((INT32)fracstep)));
+	INT32 i;
+
+	for (i = 0; i < count; i += 16)
+	{
+		_mm256_storeu_si256((__m256i *)&spots[i], _mm256_and_si256(_mm256_srai_epi32(f, FRACBITS), mask));
+		f = _mm256_add_epi32(f, step8);
+
+		_mm256_storeu_si256((__m256i *)&spots[i+8], _mm256_and_si256(_mm256_srai_epi32(f, FRACBITS), mask));
+		f = _mm256_add_epi32(f, step8);
+	}
+}
+#endif
+
+#ifdef SIMDDRAW_NEON
+static void R_SpanSpots_NEON(INT32 *spots, size_t count, UINT32 xposition, UINT32 yposition, UINT32 xstep, UINT32 ystep)
+{
+	static const UINT32 lanes[4] = {0, 1, 2, 3};
+	const int32x4_t xshift = vdupq_n_s32(-(INT32)nflatxshift); // negative shifts go right
+	const int32x4_t yshift = vdupq_n_s32(-(INT32)nflatyshift);
+	const uint32x4_t mask = vdupq_n_u32(nflatmask);
+	const uint32x4_t xstep4 = vdupq_n_u32(xstep*4);
+	const uint32x4_t ystep4 = vdupq_n_u32(ystep*4);
+	uint32x4_t x = vmlaq_n_u32(vdupq_n_u32(xposition), vld1q_u32(lanes), xstep);
+	uint32x4_t y = vmlaq_n_u32(vdupq_n_u32(yposition), vld1q_u32(lanes), ystep);
+	size_t i;
+
+	for (i = 0; i < count; i += 8)
+	{
+		vst1q_s32(&spots[i], vreinterpretq_s32_u32(vorrq_u32(vandq_u32(vshlq_u32(y, yshift), mask), vshlq_u32(x, xshift))));
+		x = vaddq_u32(x, xstep4);
+		y = vaddq_u32(y, ystep4);
+
+		vst1q_s32(&spots[i+4], vreinterpretq_s32_u32(vorrq_u32(vandq_u32(vshlq_u32(y, yshift), mask), vshlq_u32(x, xshift))));
+		x = vaddq_u32(x, xstep4);
+		y = vaddq_u32(y, ystep4);
+	}
+}
+
+static void R_ColumnSpots_NEON(INT32 *spots, INT32 count, UINT32 frac, UINT32 fracstep, INT32 heightmask)
+{
+	static const UINT32 lanes[4] = {0, 1, 2, 3};
+	const int32x4_t mask = vdupq_n_s32(heightmask);
+	const uint32x4_t step4 = vdupq_n_u32(fracstep*4);
+	uint32x4_t f = vmlaq_n_u32(vdupq_n_u32(frac), vld1q_u32(lanes), fracstep);
+	INT32 i;
+
+	for (i = 0; i < count; i += 8)
+	{
+		vst1q_s32(&spots[i], vandq_s32(vshrq_n_s32(vreinterpretq_s32_u32(f), FRACBITS), mask));
+		f = vaddq_u32(f, step4);
+
+		vst1q_s32(&spots[i+4], vandq_s32(vshrq_n_s32(vreinterpretq_s32_u32(f), FRACBITS), mask));
+		f = vaddq_u32(f, step4);
+	}
+}
+#endif
+
+// ==========================================================================
+// DRAWERS
+// ==========================================================================
+
+static inline void R_DrawColumnSIMD(columnspots_t spotfunc)
+{
+	INT32 count, i;
+	UINT8 *dest;
+	fixed_t frac, fracstep;
+	const UINT8 *source = dc_source;
+	const lighttable_t *colormap = dc_colormap;
+	INT32 heightmask = dc_texheight-1;
+
+	if (dc_texheight & heightmask) // not a power of 2, leave the wrapping to the C drawer
+	{
+		R_DrawColumn_8();
+		return;
+	}
+
+	count = dc_yh - dc_yl + 1;
+
+	if (count <= 0) // Zero length, column does not exceed a pixel.
+		return;
+
+#ifdef RANGECHECK
+	if ((unsigned)dc_x >= (unsigned)vid.width || dc_yl < 0 || dc_yh >= vid.height)
+		return;
+#endif
+
+	dest = &topleft[dc_yl*vid.width + dc_x];
+
+	fracstep = dc_iscale;
+	frac = (dc_texturemid + FixedMul((dc_yl << FRACBITS) - centeryfrac, fracstep))*(!dc_hires);
+
+	spotfunc(simdspots, count, (UINT32)frac, (UINT32)fracstep, heightmask);
+
+	for (i = 0; i < count; i++)
+	{
+		*dest = colormap[source[simdspots[i]]];
+		dest += vid.width;
+	}
+}
+
+static inline void R_DrawTranslucentColumnSIMD(columnspots_t spotfunc)
+{
+	INT32 count, i;
+	UINT8 *dest;
+	fixed_t frac, fracstep;
+	const UINT8 *source = dc_source;
+	const UINT8 *transmap = dc_transmap;
+	const lighttable_t *colormap = dc_colormap;
+	INT32 heightmask = dc_texheight-1;
+
+	if (dc_texheight & heightmask)
+	{
+		R_DrawTranslucentColumn_8();
+		return;
+	}
+
+	count = dc_yh - dc_yl + 1;
+
+	if (count <= 0) // Zero length, column does not exceed a pixel.
+		return;
+
+#ifdef RANGECHECK
+	if ((unsigned)dc_x >= (unsigned)vid.width || dc_yl < 0 || dc_yh >= vid.height)
+		I_Error("R_DrawTranslucentColumnSIMD: %d to %d at %d", dc_yl, dc_yh, dc_x);
+#endif
+
+	dest = &topleft[dc_yl*vid.width + dc_x];
+
+	fracstep = dc_iscale;
+	frac = (dc_texturemid + FixedMul((dc_yl << FRACBITS) - centeryfrac, fracstep))*(!dc_hires);
+
+	spotfunc(simdspots, count, (UINT32)frac, (UINT32)fracstep, heightmask);
+
+	for (i = 0; i < count; i++)
+	{
+		*dest = *(transmap + (colormap[source[simdspots[i]]]<<8) + (*dest));
+		dest += vid.width;
+	}
+}
+
+static inline void R_DrawSpanSIMD(spanspots_t spotfunc)
+{
+	UINT32 xposition, yposition, xstep, ystep;
+	const UINT8 *source = ds_source;
+	const UINT8 *colormap = ds_colormap;
+	UINT8 *dest = ylookup[ds_y] + columnofs[ds_x1];
+	const UINT8 *deststop = screens[0] + vid.rowbytes * vid.height;
+	size_t count = ds_x2 - ds_x1 + 1;
+	size_t i, blocks;
+
+	if (dest+8 > deststop)
+		return;
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	spotfunc(simdspots, count, xposition, yposition, xstep, ystep);
+
+	// Like R_DrawSpan_8, only check deststop after the last whole block of 8
+	blocks = count & ~(size_t)7;
+	for (i = 0; i < blocks; i++)
+		dest[i] = colormap[source[simdspots[i]]];
+	for (; i < count && dest + i <= deststop; i++)
+		dest[i] = colormap[source[simdspots[i]]];
+}
+
+static inline void R_DrawTranslucentSpanSIMD(spanspots_t spotfunc)
+{
+	UINT32 xposition, yposition, xstep, ystep;
+	const UINT8 *source = ds_source;
+	const UINT8 *colormap = ds_colormap;
+	const UINT8 *transmap = ds_transmap;
+	UINT8 *dest = ylookup[ds_y] + columnofs[ds_x1];
+	size_t count = ds_x2 - ds_x1 + 1;
+	size_t i;
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	spotfunc(simdspots, count, xposition, yposition, xstep, ystep);
+
+	for (i = 0; i < count; i++)
+		dest[i] = *(transmap + (colormap[source[simdspots[i]]] << 8) + dest[i]);
+}
+
+#ifdef SIMDDRAW_SSE2
+void R_DrawColumn_8_SSE2(void) {R_DrawColumnSIMD(R_ColumnSpots_SSE2);}
+void R_DrawTranslucentColumn_8_SSE2(void) {R_DrawTranslucentColumnSIMD(R_ColumnSpots_SSE2);}
+void R_DrawSpan_8_SSE2(void) {R_DrawSpanSIMD(R_SpanSpots_SSE2);}
+void R_DrawTranslucentSpan_8_SSE2(void) {R_DrawTranslucentSpanSIMD(R_SpanSpots_SSE2);}
+#endif
+
+#ifdef SIMDDRAW_AVX2
+void R_DrawColumn_8_AVX2(void) {R_DrawColumnSIMD(R_ColumnSpots_AVX2);}
+void R_DrawTranslucentColumn_8_AVX2(void) {R_DrawTranslucentColumnSIMD(R_ColumnSpots_AVX2);}
+void R_DrawSpan_8_AVX2(void) {R_DrawSpanSIMD(R_SpanSpots_AVX2);}
+void R_DrawTranslucentSpan_8_AVX2(void) {R_DrawTranslucentSpanSIMD(R_SpanSpots_AVX2);}
+#endif
+
+#ifdef SIMDDRAW_NEON
+void R_DrawColumn_8_NEON(void) {R_DrawColumnSIMD(R_ColumnSpots_NEON);}
+void R_DrawTranslucentColumn_8_NEON(void) {R_DrawTranslucentColumnSIMD(R_ColumnSpots_NEON);}
+void R_DrawSpan_8_NEON(void) {R_DrawSpanSIMD(R_SpanSpots_NEON);}
+void R_DrawTranslucentSpan_8_NEON(void) {R_DrawTranslucentSpanSIMD(R_SpanSpots_NEON);}
+#endif
+
+// ==========================================================================
+// BENCHMARK
+// ==========================================================================
+
+static UINT32 drawbenchseed;
+
+static UINT32 R_DrawBenchRandom(void)
+{
+	drawbenchseed = drawbenchseed*1103515245 + 12345;
+	return drawbenchseed >> 8;
+}
+
+// Sets up a random span or column somewhere in the view, the same sequence
+// every time drawbenchseed is reset.
+static void R_DrawBenchSetup(boolean span, UINT8 *source)
+{
+	static const UINT32 flats[3][4] =
+	{
+		// mask, xshift, yshift, shiftup
+		{0xFC0, 26, 20, 10}, // 64x64
+		{0x3F80, 25, 18, 9}, // 128x128
+		{0xFF00, 24, 16, 8}, // 256x256
+	};
+	lighttable_t *colormap = colormaps + (R_DrawBenchRandom() % NUMCOLORMAPS)*256;
+	UINT8 *transmap = transtables + (R_DrawBenchRandom() % NUMTRANSTABLES)*0x10000;
+
+	if (span)
+	{
+		const UINT32 *flat = flats[R_DrawBenchRandom() % 3];
+
+		nflatmask = flat[0];
+		nflatxshift = flat[1];
+		nflatyshift = flat[2];
+		nflatshiftup = flat[3];
+
+		ds_y = R_DrawBenchRandom() % viewheight;
+		ds_x1 = R_DrawBenchRandom() % viewwidth;
+		ds_x2 = ds_x1 + R_DrawBenchRandom() % (viewwidth - ds_x1);
+		ds_xfrac = (fixed_t)(R_DrawBenchRandom() << 8);
+		ds_yfrac = (fixed_t)(R_DrawBenchRandom() << 8);
+		ds_xstep = (fixed_t)(R_DrawBenchRandom() % (4*FRACUNIT)) - 2*FRACUNIT;
+		ds_ystep = (fixed_t)(R_DrawBenchRandom() % (4*FRACUNIT)) - 2*FRACUNIT;
+		ds_source = source;
+		ds_colormap = colormap;
+		ds_transmap = transmap;
+	}
+	else
+	{
+		dc_x = R_DrawBenchRandom() % viewwidth;
+		dc_yl = R_DrawBenchRandom() % viewheight;
+		dc_yh = dc_yl + R_DrawBenchRandom() % (viewheight - dc_yl);
+		dc_texheight = 16 << (R_DrawBenchRandom() % 5);
+		dc_texturemid = (fixed_t)(R_DrawBenchRandom() << 8);
+		dc_iscale = (fixed_t)(R_DrawBenchRandom() % (4*FRACUNIT)) + 1;
+		dc_hires = 0;
+		dc_source = source + R_DrawBenchRandom() % (0x10000 - 256);
+		dc_colormap = colormap;
+		dc_transmap = transmap;
+	}
+}
+
+static void R_DrawBenchCopy(UINT8 *to, INT32 topitch, const UINT8 *from, INT32 frompitch, INT32 count)
+{
+	while (count--)
+	{
+		*to = *from;
+		to += topitch;
+		from += frompitch;
+	}
+}
+
+static void R_BenchmarkDrawer(const char *name, void (*cdrawer)(void), void (*simddrawer)(void),
+	boolean span, UINT8 *source, INT32 runs)
+{
+	UINT64 precision = I_GetPrecisePrecision();
+	UINT8 before[SIMDSPOTS], drawn[SIMDSPOTS];
+	precise_t ctime, simdtime;
+	INT32 i, j, mismatches = 0;
+
+	// Check the SIMD drawer draws the same pixels as the C one...
+	drawbenchseed = 1;
+	for (i = 0; i < runs; i++)
+	{
+		UINT8 *dest;
+		INT32 count, pitch;
+
+		R_DrawBenchSetup(span, source);
+		if (span)
+		{
+			dest = ylookup[ds_y] + columnofs[ds_x1];
+			count = ds_x2 - ds_x1 + 1;
+			pitch = 1;
+		}
+		else
+		{
+			dest = &topleft[dc_yl*vid.width + dc_x];
+			count = dc_yh - dc_yl + 1;
+			pitch = vid.width;
+		}
+
+		R_DrawBenchCopy(before, 1, dest, pitch, count);
+		cdrawer();
+		R_DrawBenchCopy(drawn, 1, dest, pitch, count);
+		R_DrawBenchCopy(dest, pitch, before, 1, count);
+		simddrawer();
+
+		for (j = 0; j < count; j++)
+			if (dest[j*pitch] != drawn[j])
+				break;
+		if (j < count)
+			mismatches++;
+	}
+
+	// ...then time both over the same runs.
+	drawbenchseed = 1;
+	ctime = I_GetPreciseTime();
+	for (i = 0; i < runs; i++)
+	{
+		R_DrawBenchSetup(span, source);
+		cdrawer();
+	}
+	ctime = I_GetPreciseTime() - ctime;
+
+	drawbenchseed = 1;
+	simdtime = I_GetPreciseTime();
+	for (i = 0; i < runs; i++)
+	{
+		R_DrawBenchSetup(span, source);
+		simddrawer();
+	}
+	simdtime = I_GetPreciseTime() - simdtime;
+
+	CONS_Printf(M_GetText("%s: C %u us, SIMD %u us (%u%%), %d of %d runs differ\n"), name,
+		(UINT32)(ctime * 1000000 / precision), (UINT32)(simdtime * 1000000 / precision),
+		ctime ? (UINT32)(simdtime * 100 / ctime) : 0, mismatches, runs);
+	if (mismatches)
+		CONS_Alert(CONS_ERROR, M_GetText("%s does not match the C drawer!\n"), name);
+}
+#endif
+
+/**	\brief Draws random spans and columns in the view with the C drawers and
+	each SIMD drawer the CPU supports, and reports how long each took and
+	whether any pixels came out different.
+
+	\param	runs	how many spans or columns to draw with each drawer
+*/
+void R_BenchmarkDrawers(INT32 runs)
+{
+#ifdef SIMDDRAW
+	UINT8 *source;
+	INT32 i;
+
+	if (rendermode != render_soft || !screens[0] || !transtables || !colormaps)
+	{
+		CONS_Printf(M_GetText("The drawer benchmark needs the software renderer.\n"));
+		return;
+	}
+
+	// Noise makes a texture where every texel is different from its neighbours
+	source = Z_Malloc(0x10000, PU_STATIC, NULL);
+	drawbenchseed = 0xC0FFEE;
+	for (i = 0; i < 0x10000; i++)
+		source[i] = (UINT8)R_DrawBenchRandom();
+
+#ifdef SIMDDRAW_SSE2
+	if (R_SSE2)
+	{
+		R_BenchmarkDrawer("R_DrawColumn_8_SSE2", R_DrawColumn_8, R_DrawColumn_8_SSE2, false, source, runs);
+		R_BenchmarkDrawer("R_DrawTranslucentColumn_8_SSE2", R_DrawTranslucentColumn_8, R_DrawTranslucentColumn_8_SSE2, false, source, runs);
+		R_BenchmarkDrawer("R_DrawSpan_8_SSE2", R_DrawSpan_8, R_DrawSpan_8_SSE2, true, source, runs);
+		R_BenchmarkDrawer("R_DrawTranslucentSpan_8_SSE2", R_DrawTranslucentSpan_8, R_DrawTranslucentSpan_8_SSE2, true, source, runs);
+	}
+#endif
+#ifdef SIMDDRAW_AVX2
+	if (R_AVX2)
+	{
+		R_BenchmarkDrawer("R_DrawColumn_8_AVX2", R_DrawColumn_8, R_DrawColumn_8_AVX2, false, source, runs);
+		R_BenchmarkDrawer("R_DrawTranslucentColumn_8_AVX2", R_DrawTranslucentColumn_8, R_DrawTranslucentColumn_8_AVX2, false, source, runs);
+		R_BenchmarkDrawer("R_DrawSpan_8_AVX2", R_DrawSpan_8, R_DrawSpan_8_AVX2, true, source, runs);
+		R_BenchmarkDrawer("R_DrawTranslucentSpan_8_AVX2", R_DrawTranslucentSpan_8, R_DrawTranslucentSpan_8_AVX2, true, source, runs);
+	}
+#endif
+#ifdef SIMDDRAW_NEON
+	if (R_NEON)
+	{
+		R_BenchmarkDrawer("R_DrawColumn_8_NEON", R_DrawColumn_8, R_DrawColumn_8_NEON, false, source, runs);
+		R_BenchmarkDrawer("R_DrawTranslucentColumn_8_NEON", R_DrawTranslucentColumn_8, R_DrawTranslucentColumn_8_NEON, false, source, runs);
+		R_BenchmarkDrawer("R_DrawSpan_8_NEON", R_DrawSpan_8, R_DrawSpan_8_NEON, true, source, runs);
+		R_BenchmarkDrawer("R_DrawTranslucentSpan_8_NEON", R_DrawTranslucentSpan_8, R_DrawTranslucentSpan_8_NEON, true, source, runs);
+	}
+#endif
+
+	Z_Free(source);
+#else
+	(void)runs;
+	CONS_Printf(M_GetText("This build has no SIMD drawers.\n"));
+#endif
+}
@@ -71,17 +71,37 @@ static viewvars_t pview_new[MAXSPLITSCREENPLAYERS];
 static viewvars_t skyview_old[MAXSPLITSCREENPLAYERS];
 static viewvars_t skyview_new[MAXSPLITSCREENPLAYERS];
 
-static viewvars_t *oldview = &pview_old[0];
+static THREADLOCAL viewvars_t *oldview = &pview_old[0];
 static int oldview_invalid[MAXSPLITSCREENPLAYERS] = {0, 0, 0, 0};
-viewvars_t *newview = &pview_new[0];
+THREADLOCAL viewvars_t *newview = &pview_new[0];
 
 
-enum viewcontext_e viewcontext = VIEWCONTEXT_PLAYER1;
+THREADLOCAL enum viewcontext_e viewcontext = VIEWCONTEXT_PLAYER1;
 
 static levelinterpolator_t **levelinterpolators;
 static size_t levelinterpolators_len;
 static size_t levelinterpolators_size;
 
+// Every interpolated mobj, with what the renderer needs to interpolate it
+// packed into arrays. This is captured at the end of each tic, so drawing
+// the frames in between reads these, not the mobjs spread around memory.
+typedef struct
+{
+	mobj_t **mobj;
+	subsector_t **subsector; // if it didn't move, else NULL
+	fixed_t *old_x, *old_y, *old_z, *old_scale;
+	fixed_t *x, *y, *z, *scale;
+	angle_t *old_angle, *angle;
+	UINT8 *reset;
+} interpbuffer_t;
+
+#define INTERPBUFFERSIZE (2*sizeof (void *) + 10*sizeof (fixed_t) + sizeof (UINT8))
+
+static interpbuffer_t interpbuffer;
+static UINT8 *interpbufferblock = NULL;
+static size_t interpolated_mobjs_len = 0;
+static size_t interpolated_mobjs_capacity = 0;
+
 
 static fixed_t R_LerpFixed(fixed_t from, fixed_t to, fixed_t frac)
 {
@@ -270,6 +290,22 @@ angle_t R_InterpolateAngle(angle_t from, angle_t to)
 	return (R_LerpAngle(from, to, rendertimefrac));
 }
 
+static void R_InterpolateBufferedMobj(size_t i, fixed_t frac, interpmobjstate_t *out)
+{
+	const boolean reset = interpbuffer.reset[i];
+
+	out->x = R_LerpFixed(interpbuffer.old_x[i], interpbuffer.x[i], frac);
+	out->y = R_LerpFixed(interpbuffer.old_y[i], interpbuffer.y[i], frac);
+	out->z = R_LerpFixed(interpbuffer.old_z[i], interpbuffer.z[i], frac);
+	out->scale = reset ? interpbuffer.scale[i] : R_LerpFixed(interpbuffer.old_scale[i], interpbuffer.scale[i], frac);
+	out->angle = reset ? interpbuffer.angle[i] : R_LerpAngle(interpbuffer.old_angle[i], interpbuffer.angle[i], frac);
+
+	// No need to look for it if it didn't move.
+	out->subsector = interpbuffer.subsector[i];
+	if (!out->subsector)
+		out->subsector = R_PointInSubsector(out->x, out->y);
+}
+
 void R_InterpolateMobjState(mobj_t *mobj, fixed_t frac, interpmobjstate_t *out)
 {
 	if (frac == FRACUNIT)
@@ -283,6 +319,12 @@ void R_InterpolateMobjState(mobj_t *mobj, fixed_t frac, interpmobjstate_t *out)
 		return;
 	}
 
+	if (mobj->interpindex < interpolated_mobjs_len && interpbuffer.mobj[mobj->interpindex] == mobj)
+	{
+		R_InterpolateBufferedMobj(mobj->interpindex, frac, out);
+		return;
+	}
+
 	out->x = R_LerpFixed(mobj->old_x, mobj->x, frac);
 	out->y = R_LerpFixed(mobj->old_y, mobj->y, frac);
 	out->z = R_LerpFixed(mobj->old_z, mobj->z, frac);
@@ -300,29 +342,6 @@ void R_InterpolateMobjState(mobj_t *mobj, fixed_t frac, interpmobjstate_t *out)
 	}
 }
 
-void R_InterpolatePrecipMobjState(precipmobj_t *mobj, fixed_t frac, interpmobjstate_t *out)
-{
-	if (frac == FRACUNIT)
-	{
-		out->x = mobj->x;
-		out->y = mobj->y;
-		out->z = mobj->z;
-		out->scale = FRACUNIT;
-		out->subsector = mobj->subsector;
-		out->angle = mobj->angle;
-		return;
-	}
-
-	out->x = R_LerpFixed(mobj->old_x, mobj->x, frac);
-	out->y = R_LerpFixed(mobj->old_y, mobj->y, frac);
-	out->z = R_LerpFixed(mobj->old_z, mobj->z, frac);
-	out->scale = FRACUNIT;
-
-	out->subsector = R_PointInSubsector(out->x, out->y);
-
-	out->angle = R_LerpAngle(mobj->old_angle, mobj->angle, frac);
-}
-
 static void AddInterpolator(levelinterpolator_t* interpolator)
 {
 	if (levelinterpolators_len >= levelinterpolators_size)
@@ -651,65 +670,114 @@ void R_DestroyLevelInterpolators(thinker_t *thinker)
 	}
 }
 
-static mobj_t **interpolated_mobjs = NULL;
-static size_t interpolated_mobjs_len = 0;
-static size_t interpolated_mobjs_capacity = 0;
+// Moves the arrays into a block twice the size.
+static void R_GrowMobjInterpolators(void)
+{
+	const size_t oldcapacity = interpolated_mobjs_capacity;
+	const size_t capacity = oldcapacity ? oldcapacity * 2 : 256;
+	UINT8 *block = Z_MallocAlign(capacity * INTERPBUFFERSIZE, PU_LEVEL, NULL, 64);
+	UINT8 *p = block;
+	interpbuffer_t buffer;
+
+	// Widest first, so every array stays aligned.
+#define MOVEARRAY(field) \
+	buffer.field = (void *)p; \
+	if (oldcapacity) \
+		M_Memcpy(buffer.field, interpbuffer.field, interpolated_mobjs_len * sizeof (*buffer.field)); \
+	p += capacity * sizeof (*buffer.field);
+
+	MOVEARRAY(mobj)
+	MOVEARRAY(subsector)
+	MOVEARRAY(old_x) MOVEARRAY(old_y) MOVEARRAY(old_z) MOVEARRAY(old_scale)
+	MOVEARRAY(x) MOVEARRAY(y) MOVEARRAY(z) MOVEARRAY(scale)
+	MOVEARRAY(old_angle) MOVEARRAY(angle)
+	MOVEARRAY(reset)
+#undef MOVEARRAY
+
+	Z_Free(interpbufferblock);
+	interpbufferblock = block;
+	interpbuffer = buffer;
+	interpolated_mobjs_capacity = capacity;
+}
+
+static void R_CaptureMobjInterpolator(size_t i)
+{
+	const mobj_t *mobj = interpbuffer.mobj[i];
+
+	interpbuffer.old_x[i] = mobj->old_x;
+	interpbuffer.old_y[i] = mobj->old_y;
+	interpbuffer.old_z[i] = mobj->old_z;
+	interpbuffer.old_scale[i] = mobj->old_scale;
+	interpbuffer.x[i] = mobj->x;
+	interpbuffer.y[i] = mobj->y;
+	interpbuffer.z[i] = mobj->z;
+	interpbuffer.scale[i] = mobj->scale;
+
+	if (mobj->player)
+	{
+		interpbuffer.old_angle[i] = mobj->player->old_frameangle;
+		interpbuffer.angle[i] = mobj->player->frameangle;
+	}
+	else
+	{
+		interpbuffer.old_angle[i] = mobj->old_angle;
+		interpbuffer.angle[i] = mobj->angle;
+	}
+
+	interpbuffer.reset[i] = (UINT8)mobj->resetinterp;
+	interpbuffer.subsector[i] = (mobj->old_x == mobj->x && mobj->old_y == mobj->y) ? mobj->subsector : NULL;
+}
 
 // NOTE: This will NOT check that the mobj has already been added, for perf
 // reasons.
 void R_AddMobjInterpolator(mobj_t *mobj)
 {
 	if (interpolated_mobjs_len >= interpolated_mobjs_capacity)
-	{
-		if (interpolated_mobjs_capacity == 0)
-		{
-			interpolated_mobjs_capacity = 256;
-		}
-		else
-		{
-			interpolated_mobjs_capacity *= 2;
-		}
-
-		interpolated_mobjs = Z_ReallocAlign(
-			interpolated_mobjs,
-			sizeof(mobj_t *) * interpolated_mobjs_capacity,
-			PU_LEVEL,
-			NULL,
-			64
-		);
-	}
-
-	interpolated_mobjs[interpolated_mobjs_len] = mobj;
-	interpolated_mobjs_len += 1;
+		R_GrowMobjInterpolators();
 
 	R_ResetMobjInterpolationState(mobj);
 	mobj->resetinterp = true;
+
+	mobj->interpindex = interpolated_mobjs_len;
+	interpbuffer.mobj[interpolated_mobjs_len] = mobj;
+	R_CaptureMobjInterpolator(interpolated_mobjs_len);
+	interpolated_mobjs_len += 1;
 }
 
 void R_RemoveMobjInterpolator(mobj_t *mobj)
 {
-	size_t i;
+	const size_t i = mobj->interpindex;
+	const size_t last = interpolated_mobjs_len - 1;
 
-	if (interpolated_mobjs_len == 0) return;
+	if (i >= interpolated_mobjs_len || interpbuffer.mobj[i] != mobj)
+		return;
 
-	for (i = 0; i < interpolated_mobjs_len; i++)
-	{
-		if (interpolated_mobjs[i] == mobj)
-		{
-			interpolated_mobjs[i] = interpolated_mobjs[
-				interpolated_mobjs_len - 1
-			];
-			interpolated_mobjs_len -= 1;
-			return;
-		}
-	}
+	// Move the last one into its place.
+	interpbuffer.mobj[i] = interpbuffer.mobj[last];
+	interpbuffer.subsector[i] = interpbuffer.subsector[last];
+	interpbuffer.old_x[i] = interpbuffer.old_x[last];
+	interpbuffer.old_y[i] = interpbuffer.old_y[last];
+	interpbuffer.old_z[i] = interpbuffer.old_z[last];
+	interpbuffer.old_scale[i] = interpbuffer.old_scale[last];
+	interpbuffer.x[i] = interpbuffer.x[last];
+	interpbuffer.y[i] = interpbuffer.y[last];
+	interpbuffer.z[i] = interpbuffer.z[last];
+	interpbuffer.scale[i] = interpbuffer.scale[last];
+	interpbuffer.old_angle[i] = interpbuffer.old_angle[last];
+	interpbuffer.angle[i] = interpbuffer.angle[last];
+	interpbuffer.reset[i] = interpbuffer.reset[last];
+	interpbuffer.mobj[i]->interpindex = i;
+
+	interpolated_mobjs_len -= 1;
+	mobj->interpindex = SIZE_MAX;
 }
 
 void R_InitMobjInterpolators(void)
 {
 	// apparently it's not acceptable to free something already unallocated
 	// Z_Free(interpolated_mobjs);
-	interpolated_mobjs = NULL;
+	interpbufferblock = NULL;
+	memset(&interpbuffer, 0, sizeof interpbuffer);
 	interpolated_mobjs_len = 0;
 	interpolated_mobjs_capacity = 0;
 }
@@ -719,12 +787,22 @@ void R_UpdateMobjInterpolators(void)
 	size_t i;
 	for (i = 0; i < interpolated_mobjs_len; i++)
 	{
-		mobj_t *mobj = interpolated_mobjs[i];
+		mobj_t *mobj = interpbuffer.mobj[i];
 		if (!P_MobjWasRemoved(mobj))
 			R_ResetMobjInterpolationState(mobj);
 	}
 }
 
+void R_CaptureMobjInterpolators(void)
+{
+	size_t i;
+	for (i = 0; i < interpolated_mobjs_len; i++)
+	{
+		if (!P_MobjWasRemoved(interpbuffer.mobj[i]))
+			R_CaptureMobjInterpolator(i);
+	}
+}
+
 //
 // P_ResetMobjInterpolationState
 //
@@ -751,20 +829,3 @@ void R_ResetMobjInterpolationState(mobj_t *mobj)
 
 	mobj->resetinterp = false;
 }
-
-//
-// P_ResetPrecipitationMobjInterpolationState
-//
-// Reset the rendering interpolation state of the precipmobj.
-//
-void R_ResetPrecipitationMobjInterpolationState(precipmobj_t *mobj)
-{
-	mobj->old_x2 = mobj->old_x;
-	mobj->old_y2 = mobj->old_y;
-	mobj->old_z2 = mobj->old_z;
-	mobj->old_angle2 = mobj->old_angle;
-	mobj->old_x = mobj->x;
-	mobj->old_y = mobj->y;
-	mobj->old_z = mobj->z;
-	mobj->old_angle = mobj->angle;
-}
@@ -51,7 +51,7 @@ typedef struct {
 	mobj_t *mobj;
 } viewvars_t;
 
-extern viewvars_t *newview;
+extern THREADLOCAL viewvars_t *newview;
 
 typedef struct {
 	fixed_t x;
@@ -125,8 +125,6 @@ angle_t R_InterpolateAngle(angle_t from, angle_t to);
 
 // Evaluate the interpolated mobj state for the given mobj
 void R_InterpolateMobjState(mobj_t *mobj, fixed_t frac, interpmobjstate_t *out);
-// Evaluate the interpolated mobj state for the given precipmobj
-void R_InterpolatePrecipMobjState(precipmobj_t *mobj, fixed_t frac, interpmobjstate_t *out);
 
 void R_CreateInterpolator_SectorPlane(thinker_t *thinker, sector_t *sector, boolean ceiling);
 void R_CreateInterpolator_SectorScroll(thinker_t *thinker, sector_t *sector, boolean ceiling);
@@ -154,7 +152,8 @@ void R_AddMobjInterpolator(mobj_t *mobj);
 // Remove the interpolation state for the given mobj
 void R_RemoveMobjInterpolator(mobj_t *mobj);
 void R_UpdateMobjInterpolators(void);
+// Capture the state of every interpolated mobj for rendering. Call once after each real tic.
+void R_CaptureMobjInterpolators(void);
 void R_ResetMobjInterpolationState(mobj_t *mobj);
-void R_ResetPrecipitationMobjInterpolationState(precipmobj_t *mobj);
 
 #endif
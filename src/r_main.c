@@ -32,6 +32,12 @@
 #include "m_random.h" // quake camera shake
 #include "doomstat.h" // MAXSPLITSCREENPLAYERS
 #include "r_fps.h" // Frame interpolation/uncapped
+#include "m_perfstats.h"
+
+#ifdef THREADEDRENDER
+#include "i_system.h" // I_AddExitFunc
+#include "i_threads.h"
+#endif
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -53,31 +59,34 @@ INT64 mytotal = 0;
 // increment every time a check is made
 size_t validcount = 1;
 
-INT32 centerx, centery;
+INT32 centerx;
+THREADLOCAL INT32 centery;
 
-fixed_t centerxfrac, centeryfrac;
+fixed_t centerxfrac;
+THREADLOCAL fixed_t centeryfrac;
 fixed_t projection;
 fixed_t projectiony; // aspect ratio
 fixed_t fovtan; // field of view
 
 // just for profiling purposes
-size_t framecount;
+THREADLOCAL size_t framecount;
 
 size_t loopcount;
 
-fixed_t viewx, viewy, viewz;
-angle_t viewangle, aimingangle;
-UINT8 viewssnum;
-fixed_t viewcos, viewsin;
-boolean skyVisible;
+THREADLOCAL fixed_t viewx, viewy, viewz;
+THREADLOCAL angle_t viewangle, aimingangle;
+THREADLOCAL UINT8 viewssnum;
+THREADLOCAL INT32 viewclipx1, viewclipx2;
+THREADLOCAL fixed_t viewcos, viewsin;
+THREADLOCAL boolean skyVisible;
 boolean skyVisiblePerPlayer[MAXSPLITSCREENPLAYERS]; // saved values of skyVisible for each splitscreen player
-sector_t *viewsector;
-player_t *viewplayer;
+THREADLOCAL sector_t *viewsector;
+THREADLOCAL player_t *viewplayer;
 
 // PORTALS!
 // You can thank and/or curse JTE for these.
-UINT8 portalrender;
-sector_t *portalcullsector;
+THREADLOCAL UINT8 portalrender;
+THREADLOCAL sector_t *portalcullsector;
 typedef struct portal_pair
 {
 	INT32 line1;
@@ -96,9 +105,36 @@ typedef struct portal_pair
 	INT16 *floorclip;
 	fixed_t *frontscale;
 } portal_pair;
-portal_pair *portal_base, *portal_cap;
-line_t *portalclipline;
-INT32 portalclipstart, portalclipend;
+THREADLOCAL portal_pair *portal_base, *portal_cap;
+THREADLOCAL line_t *portalclipline;
+THREADLOCAL INT32 portalclipstart, portalclipend;
+
+// Scratch memory for one view, see R_FrameAlloc
+typedef struct frameblock_s
+{
+	struct frameblock_s *next;
+	size_t size, used;
+} frameblock_t;
+
+#define FRAMEBLOCKSIZE (256<<10)
+#define FRAMEALIGN 16
+#define FRAMEBLOCKHEADER ((sizeof (frameblock_t) + FRAMEALIGN - 1) & ~(size_t)(FRAMEALIGN - 1))
+
+static THREADLOCAL frameblock_t *frameblocks; // the one being bumped out of comes first
+static THREADLOCAL size_t frameused;
+THREADLOCAL UINT32 frameepoch;
+
+// Arena stats, see Command_Framearena_f
+static size_t framestatmaxused, framestatsize;
+static UINT32 framestatviews, framestatgrowths;
+#ifdef THREADEDRENDER
+static I_mutex framestat_mutex;
+#  define Lock_framestats()   do { if (viewthreadsactive) I_lock_mutex(&framestat_mutex); } while (0)
+#  define Unlock_framestats() do { if (viewthreadsactive) I_unlock_mutex(framestat_mutex); } while (0)
+#else
+#  define Lock_framestats()
+#  define Unlock_framestats()
+#endif
 
 fixed_t rendertimefrac;
 fixed_t renderdeltatics;
@@ -148,6 +184,7 @@ static CV_PossibleValue_t fov_cons_t[] = {{5*FRACUNIT, "MIN"}, {178*FRACUNIT, "M
 static CV_PossibleValue_t translucenthud_cons_t[] = {{0, "MIN"}, {10, "MAX"}, {0, NULL}};
 static CV_PossibleValue_t maxportals_cons_t[] = {{0, "MIN"}, {12, "MAX"}, {0, NULL}}; // lmao rendering 32 portals, you're a card
 static CV_PossibleValue_t homremoval_cons_t[] = {{0, "No"}, {1, "Yes"}, {2, "Flash"}, {0, NULL}};
+static CV_PossibleValue_t tiltedspansize_cons_t[] = {{MINTILTEDSPAN, "MIN"}, {64, "MAX"}, {0, NULL}};
 
 static void Fov_OnChange(void);
 static void ChaseCam_OnChange(void);
@@ -195,6 +232,13 @@ consvar_t cv_homremoval = {"homremoval", "Yes", CV_SAVE, homremoval_cons_t, NULL
 
 consvar_t cv_maxportals = {"maxportals", "2", CV_SAVE, maxportals_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 
+// How many pixels of a sloped plane are drawn between perspective divides
+consvar_t cv_tiltedspansize = {"tiltedspansize", "16", CV_SAVE, tiltedspansize_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+
+#ifdef THREADEDRENDER
+consvar_t cv_renderthreads = {"renderthreads", "On", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+#endif
+
 void SplitScreen_OnChange(void)
 {
 	UINT8 i;
@@ -796,7 +840,7 @@ subsector_t *R_IsPointInSubsector(fixed_t x, fixed_t y)
 // R_SetupFrame
 //
 
-static mobj_t *viewmobj;
+static THREADLOCAL mobj_t *viewmobj;
 
 void R_SkyboxFrame(player_t *player)
 {
@@ -1184,6 +1228,85 @@ void R_SetupFrame(player_t *player, boolean skybox)
 	R_InterpolateView(R_UsingFrameInterpolation() ? rendertimefrac : FRACUNIT);
 }
 
+//
+// R_FrameAlloc
+// Hands out memory that stays valid until the next view starts drawing.
+// Nothing is freed piece by piece; R_ResetFrameArena drops all of it at
+// once, so the renderer can ask for as much as a view needs without
+// keeping free lists or fixed size tables around.
+//
+static frameblock_t *R_NewFrameBlock(size_t size)
+{
+	frameblock_t *block = malloc(FRAMEBLOCKHEADER + size);
+
+	if (!block)
+		I_Error("%s: Out of memory", "R_FrameAlloc");
+
+	block->next = frameblocks;
+	block->size = size;
+	block->used = 0;
+	return (frameblocks = block);
+}
+
+void *R_FrameAlloc(size_t size)
+{
+	frameblock_t *block = frameblocks;
+	void *ptr;
+
+	size = (size + FRAMEALIGN - 1) & ~(size_t)(FRAMEALIGN - 1);
+
+	if (!block || block->size - block->used < size)
+		block = R_NewFrameBlock(max(size, FRAMEBLOCKSIZE));
+
+	ptr = (UINT8 *)block + FRAMEBLOCKHEADER + block->used;
+	block->used += size;
+	frameused += size;
+	return ptr;
+}
+
+//
+// R_ResetFrameArena
+// Called at the start of each view. If the last view had to chain more
+// blocks on, they are replaced by one block big enough for all of them,
+// so a steady scene stops allocating after its first frame.
+//
+void R_ResetFrameArena(void)
+{
+	frameblock_t *block = frameblocks, *next;
+	size_t size = 0;
+	boolean grew = (block && block->next);
+
+	if (grew)
+	{
+		for (; block; block = next)
+		{
+			next = block->next;
+			size += block->size;
+			free(block);
+		}
+		frameblocks = NULL;
+		R_NewFrameBlock(size);
+	}
+	else if (block)
+	{
+		size = block->size;
+		block->used = 0;
+	}
+
+	Lock_framestats();
+	framestatviews++;
+	if (grew)
+		framestatgrowths++;
+	if (frameused > framestatmaxused)
+		framestatmaxused = frameused;
+	if (size > framestatsize)
+		framestatsize = size;
+	Unlock_framestats();
+
+	frameused = 0;
+	frameepoch++;
+}
+
 #define ANGLED_PORTALS
 
 static void R_PortalFrame(line_t *start, line_t *dest, portal_pair *portal)
@@ -1255,10 +1378,10 @@ static void R_PortalFrame(line_t *start, line_t *dest, portal_pair *portal)
 
 void R_AddPortal(INT32 line1, INT32 line2, INT32 x1, INT32 x2)
 {
-	portal_pair *portal = Z_Malloc(sizeof(portal_pair), PU_LEVEL, NULL);
-	INT16 *ceilingclipsave = Z_Malloc(sizeof(INT16)*(x2-x1), PU_LEVEL, NULL);
-	INT16 *floorclipsave = Z_Malloc(sizeof(INT16)*(x2-x1), PU_LEVEL, NULL);
-	fixed_t *frontscalesave = Z_Malloc(sizeof(fixed_t)*(x2-x1), PU_LEVEL, NULL);
+	portal_pair *portal = R_FrameAlloc(sizeof(portal_pair));
+	INT16 *ceilingclipsave = R_FrameAlloc(sizeof(INT16)*(x2-x1));
+	INT16 *floorclipsave = R_FrameAlloc(sizeof(INT16)*(x2-x1));
+	fixed_t *frontscalesave = R_FrameAlloc(sizeof(fixed_t)*(x2-x1));
 
 	portal->line1 = line1;
 	portal->line2 = line2;
@@ -1303,12 +1426,9 @@ void R_AddPortal(INT32 line1, INT32 line2, INT32 x1, INT32 x2)
 // I mean, there is a win16lock() or something that lasts all the rendering,
 // so maybe we should release screen lock before each netupdate below..?
 
-void R_RenderPlayerView(player_t *player)
+// Fills in whatever the views might not draw over.
+static void R_DrawViewBackground(player_t *player)
 {
-	portal_pair *portal;
-	const boolean skybox = (skyboxmo[0] && cv_skybox.value);
-	UINT8 i;
-
 	// if this is display player 1
 	if (cv_homremoval.value && player == &players[displayplayers[0]])
 	{
@@ -1335,6 +1455,36 @@ void R_RenderPlayerView(player_t *player)
 #else
 	V_DrawFill(viewwidth, viewheight, viewwidth, viewheight, 31|V_NOSCALESTART);
 #endif
+}
+
+#ifdef THREADEDRENDER
+// R_SetupFrame and R_SkyboxFrame move the cameras and reset the shared
+// interpolation state, so R_RenderPlayerViews runs them for every view before
+// any thread starts. The threads only interpolate what they left behind.
+static void R_LoadViewFrame(enum viewcontext_e context)
+{
+	R_SetViewContext(context);
+	R_InterpolateView(R_UsingFrameInterpolation() ? rendertimefrac : FRACUNIT);
+}
+#endif
+
+void R_RenderPlayerView(player_t *player)
+{
+	portal_pair *portal;
+	const boolean skybox = (skyboxmo[0] && cv_skybox.value);
+	precise_t pstime;
+	UINT8 i;
+
+	// Threaded views have this done for them beforehand, as the background
+	// spans all of them and they may only be drawing some of the columns.
+#ifdef THREADEDRENDER
+	if (!viewthreadsactive)
+#endif
+	{
+		R_DrawViewBackground(player);
+		viewclipx1 = 0;
+		viewclipx2 = viewwidth-1;
+	}
 
 	// load previous saved value of skyVisible for the player
 	for (i = 0; i <= splitscreen; i++)
@@ -1346,12 +1496,19 @@ void R_RenderPlayerView(player_t *player)
 		}
 	}
 
+	R_ResetFrameArena();
+
 	portalrender = 0;
 	portal_base = portal_cap = NULL;
 
 	if (skybox && skyVisible)
 	{
-		R_SkyboxFrame(player);
+#ifdef THREADEDRENDER
+		if (viewthreadsactive)
+			R_LoadViewFrame(VIEWCONTEXT_SKY1 + viewssnum);
+		else
+#endif
+			R_SkyboxFrame(player);
 
 		R_ClearClipSegs();
 		R_ClearDrawSegs();
@@ -1361,19 +1518,29 @@ void R_RenderPlayerView(player_t *player)
 		R_ClearVisibleFloorSplats();
 #endif
 
+		pstime = M_PerfStart();
 		R_RenderBSPNode((INT32)numnodes - 1);
 		R_ClipSprites();
+		M_PerfStopView(PS_BSP, &pstime);
 		R_DrawPlanes();
 #ifdef FLOORSPLATS
 		R_DrawVisibleFloorSplats();
 #endif
+		M_PerfStopView(PS_PLANES, &pstime);
+		M_PerfCountView((UINT32)(ds_p - drawsegs), numvisplanes, visspritecount, numspans);
 		R_DrawMasked();
+		M_PerfStopView(PS_MASKED, &pstime);
 	}
 
-	R_SetupFrame(player, skybox);
+#ifdef THREADEDRENDER
+	if (viewthreadsactive)
+		R_LoadViewFrame(VIEWCONTEXT_PLAYER1 + viewssnum);
+	else
+#endif
+		R_SetupFrame(player, skybox);
 	skyVisible = false;
 	framecount++;
-	validcount++;
+	spritevalidcount++;
 
 	// Clear buffers.
 	R_ClearClipSegs();
@@ -1385,7 +1552,10 @@ void R_RenderPlayerView(player_t *player)
 #endif
 
 	// check for new console commands.
-	NetUpdate();
+#ifdef THREADEDRENDER
+	if (!viewthreadsactive)
+#endif
+		NetUpdate();
 
 	// The head node is the last node output.
 
@@ -1394,7 +1564,9 @@ void R_RenderPlayerView(player_t *player)
 	mytotal = 0;
 	ProfZeroTimer();
 #endif
+	pstime = M_PerfStart();
 	R_RenderBSPNode((INT32)numnodes - 1);
+	R_AddPrecipitationSprites();
 	R_ClipSprites();
 #ifdef TIMING
 	RDMSR(0x10, &mycount);
@@ -1417,36 +1589,44 @@ void R_RenderPlayerView(player_t *player)
 
 		R_PortalRestoreClipValues(portal->start, portal->end, portal->ceilingclip, portal->floorclip, portal->frontscale);
 
-		validcount++;
+		spritevalidcount++;
 
 		R_RenderBSPNode((INT32)numnodes - 1);
+		R_AddPrecipitationSprites();
 		R_ClipSprites();
 		//R_DrawPlanes();
 		//R_DrawMasked();
 
-		// okay done. free it.
+		// okay done. it goes with the rest of the frame arena.
 		portalcullsector = NULL; // Just in case...
 		portal_base = portal->next;
-		Z_Free(portal->ceilingclip);
-		Z_Free(portal->floorclip);
-		Z_Free(portal->frontscale);
-		Z_Free(portal);
 	}
 	// END PORTAL RENDERING
+	M_PerfStopView(PS_BSP, &pstime);
 
 	R_DrawPlanes();
 #ifdef FLOORSPLATS
 	R_DrawVisibleFloorSplats();
 #endif
+	M_PerfStopView(PS_PLANES, &pstime);
+	M_PerfCountView((UINT32)(ds_p - drawsegs), numvisplanes, visspritecount, numspans);
+
 	// draw mid texture and sprite
 	// And now 3D floors/sides!
 	R_DrawMasked();
+	M_PerfStopView(PS_MASKED, &pstime);
 
 	// Check for new console commands.
-	NetUpdate();
+#ifdef THREADEDRENDER
+	if (!viewthreadsactive)
+#endif
+		NetUpdate();
 
 	// save value to skyVisiblePerPlayer
 	// this is so that P1 can't affect whether P2 can see a skybox or not, or vice versa
+#ifdef THREADEDRENDER
+	if (!viewthreadsactive) // R_RunViewJobs gathers it from all strips of the view
+#endif
 	for (i = 0; i <= splitscreen; i++)
 	{
 		if (player == &players[displayplayers[i]])
@@ -1457,17 +1637,416 @@ void R_RenderPlayerView(player_t *player)
 	}
 }
 
+#ifdef THREADEDRENDER
+// ================
+// R_RenderPlayerViews
+// ================
+//
+// Every splitscreen view but the first is drawn by a worker thread of its
+// own, or with one view, the view is cut into column strips that are each
+// drawn by a thread. All the state a view is drawn with is thread-local, so
+// the threads only meet in the zone and the lump, texture and translation
+// caches, which lock while viewthreadsactive is set.
+
+boolean viewthreadsactive = false;
+
+#define MAXVIEWJOBS 8
+
+typedef struct
+{
+	UINT8 view;
+	INT32 x1, x2; // columns of the view to draw
+	boolean queued; // set to hand the job over, cleared once it's drawn
+	UINT16 objectsdrawn;
+	boolean skyvisible;
+	precise_t time;
+} viewjob_t;
+
+static viewjob_t viewjobs[MAXVIEWJOBS];
+static boolean viewworkers[MAXVIEWJOBS];
+static INT32 numviewworkers;
+static boolean viewworkersquit;
+
+static I_mutex viewjob_mutex;
+static I_cond viewjob_cond; // wakes the workers
+static I_cond viewdone_cond; // wakes the main thread
+
+static UINT8 **const viewylookups[MAXSPLITSCREENPLAYERS] = {ylookup1, ylookup2, ylookup3, ylookup4};
+
+// Strip stats, see Command_Stripstats_f
+static INT32 stripstatstrips;
+static UINT32 stripstatframes;
+static INT32 stripstatwidths[MAXVIEWJOBS];
+static precise_t stripstatlast[MAXVIEWJOBS];
+static precise_t stripstattime[MAXVIEWJOBS];
+static precise_t stripstatmaxtime[MAXVIEWJOBS];
+
+static CV_PossibleValue_t renderstrips_cons_t[] = {{1, "MIN"}, {MAXVIEWJOBS, "MAX"}, {0, NULL}};
+consvar_t cv_renderstrips = {"renderstrips", "1", CV_SAVE, renderstrips_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+
+// Same placement as the view loop in D_Display.
+static void R_SetViewWindow(UINT8 view)
+{
+	switch (view)
+	{
+		case 1:
+			if (splitscreen > 1)
+			{
+				viewwindowx = viewwidth;
+				viewwindowy = 0;
+			}
+			else
+			{
+				viewwindowx = 0;
+				viewwindowy = viewheight;
+			}
+			break;
+		case 2:
+			viewwindowx = 0;
+			viewwindowy = viewheight;
+			break;
+		case 3:
+			viewwindowx = viewwidth;
+			viewwindowy = viewheight;
+			break;
+		default:
+			viewwindowx = 0;
+			viewwindowy = 0;
+			break;
+	}
+
+	topleft = screens[0] + viewwindowy*vid.width + viewwindowx;
+}
+
+static void R_RunViewJob(viewjob_t *job)
+{
+	precise_t t = I_GetPreciseTime();
+
+	viewssnum = job->view;
+	R_SetViewWindow(job->view);
+	M_Memcpy(ylookup, viewylookups[job->view], viewheight*sizeof (ylookup[0]));
+
+	viewclipx1 = job->x1;
+	viewclipx2 = job->x2;
+
+	objectsdrawn = 0;
+	R_RenderPlayerView(&players[displayplayers[job->view]]);
+	job->objectsdrawn = objectsdrawn;
+	job->skyvisible = skyVisible;
+
+	job->time = I_GetPreciseTime() - t;
+}
+
+static void R_ViewWorker(void *userdata)
+{
+	viewjob_t *job = userdata;
+
+	R_InitDrawNodes();
+
+	I_lock_mutex(&viewjob_mutex);
+	for (;;)
+	{
+		while (!job->queued && !viewworkersquit && !I_thread_is_stopped())
+			I_hold_cond(&viewjob_cond, viewjob_mutex);
+
+		if (viewworkersquit || I_thread_is_stopped())
+			break;
+
+		I_unlock_mutex(viewjob_mutex);
+
+		colfunc = basecolfunc;
+		spanfunc = basespanfunc;
+		wallcolfunc = walldrawerfunc;
+
+		R_RunViewJob(job);
+
+		I_lock_mutex(&viewjob_mutex);
+		job->queued = false;
+		I_wake_all_cond(&viewdone_cond);
+	}
+	I_unlock_mutex(viewjob_mutex);
+}
+
+// Runs before the thread system stops, which would otherwise wait on
+// workers that are asleep.
+static void R_StopViewWorkers(void)
+{
+	I_lock_mutex(&viewjob_mutex);
+	viewworkersquit = true;
+	I_wake_all_cond(&viewjob_cond);
+	I_unlock_mutex(viewjob_mutex);
+}
+
+// Hands all jobs but the first to the workers and draws that one here.
+static void R_RunViewJobs(INT32 numjobs)
+{
+	INT32 i;
+
+	viewthreadsactive = true;
+
+	I_lock_mutex(&viewjob_mutex);
+	for (i = 1; i < numjobs; i++)
+	{
+		if (!viewworkers[i])
+		{
+			if (!numviewworkers++)
+				I_AddExitFunc(R_StopViewWorkers);
+			I_spawn_thread("render-view", R_ViewWorker, &viewjobs[i]);
+			viewworkers[i] = true;
+		}
+
+		viewjobs[i].queued = true;
+	}
+	I_wake_all_cond(&viewjob_cond);
+	I_unlock_mutex(viewjob_mutex);
+
+	R_RunViewJob(&viewjobs[0]);
+	if (viewjobs[0].view)
+		M_Memcpy(ylookup, ylookup1, viewheight*sizeof (ylookup[0]));
+
+	I_lock_mutex(&viewjob_mutex);
+	for (i = 1; i < numjobs; i++)
+	{
+		while (viewjobs[i].queued)
+			I_hold_cond(&viewdone_cond, viewjob_mutex);
+	}
+	I_unlock_mutex(viewjob_mutex);
+
+	viewthreadsactive = false;
+
+	objectsdrawn = 0;
+	for (i = 0; i < numjobs; i++)
+	{
+		objectsdrawn = (UINT16)(objectsdrawn + viewjobs[i].objectsdrawn);
+		skyVisiblePerPlayer[viewjobs[i].view] = false;
+	}
+	for (i = 0; i < numjobs; i++)
+	{
+		if (viewjobs[i].skyvisible)
+			skyVisiblePerPlayer[viewjobs[i].view] = true;
+	}
+}
+
+static void R_UpdateStripStats(INT32 numstrips)
+{
+	INT32 i;
+
+	if (numstrips != stripstatstrips)
+	{
+		stripstatstrips = numstrips;
+		stripstatframes = 0;
+		memset(stripstattime, 0, sizeof stripstattime);
+		memset(stripstatmaxtime, 0, sizeof stripstatmaxtime);
+	}
+
+	stripstatframes++;
+	for (i = 0; i < numstrips; i++)
+	{
+		stripstatwidths[i] = viewjobs[i].x2 - viewjobs[i].x1 + 1;
+		stripstatlast[i] = viewjobs[i].time;
+		stripstattime[i] += viewjobs[i].time;
+		if (viewjobs[i].time > stripstatmaxtime[i])
+			stripstatmaxtime[i] = viewjobs[i].time;
+	}
+}
+
+boolean R_UseViewThreads(void)
+{
+	if (rendermode != render_soft || I_thread_is_stopped())
+		return false;
+
+	if (splitscreen)
+		return (cv_renderthreads.value != 0);
+
+	return (cv_renderthreads.value && cv_renderstrips.value > 1);
+}
+
+void R_RenderPlayerViews(void)
+{
+	const boolean skybox = (skyboxmo[0] && cv_skybox.value);
+	INT32 numjobs = 0;
+	UINT8 i, lastview = 0;
+
+	// Done here rather than as the BSP finds them, so the views only read them.
+	R_PrepMovedSectors();
+
+	for (i = 0; i <= splitscreen; i++)
+	{
+		player_t *player = &players[displayplayers[i]];
+
+		if (!(player->mo || player->playerstate == PST_DEAD))
+			continue;
+
+		R_DrawViewBackground(player);
+		lastview = i;
+
+		// Once per view, however many strips it's cut into; see R_LoadViewFrame.
+		if (skybox && skyVisiblePerPlayer[i])
+			R_SkyboxFrame(player);
+		R_SetupFrame(player, skybox);
+
+		if (splitscreen)
+		{
+			viewjobs[numjobs].view = i;
+			viewjobs[numjobs].x1 = 0;
+			viewjobs[numjobs].x2 = viewwidth-1;
+			numjobs++;
+		}
+		else
+		{
+			// Cut the view into strips of about the same width.
+			INT32 numstrips = min(cv_renderstrips.value, viewwidth);
+
+			for (numjobs = 0; numjobs < numstrips; numjobs++)
+			{
+				viewjobs[numjobs].view = 0;
+				viewjobs[numjobs].x1 = viewwidth*numjobs/numstrips;
+				viewjobs[numjobs].x2 = viewwidth*(numjobs+1)/numstrips - 1;
+			}
+		}
+	}
+
+	if (numjobs)
+		R_RunViewJobs(numjobs);
+	else
+		objectsdrawn = 0;
+
+	if (!splitscreen && numjobs)
+		R_UpdateStripStats(numjobs);
+
+	// Leave the view window where the last view put it, as D_Display would.
+	viewssnum = lastview;
+	R_SetViewWindow(lastview);
+}
+
+//
+// Command_Stripstats_f
+// Prints how long each strip of the view took to draw, for balancing them.
+//
+static void Command_Stripstats_f(void)
+{
+	UINT64 precision = I_GetPrecisePrecision();
+	precise_t total = 0;
+	INT32 i;
+
+	if (COM_Argc() > 1 && !stricmp(COM_Argv(1), "reset"))
+	{
+		stripstatstrips = 0;
+		stripstatframes = 0;
+		return;
+	}
+
+	if (!stripstatframes)
+	{
+		CONS_Printf(M_GetText("No views have been drawn in strips yet. Set renderstrips above 1.\n"));
+		return;
+	}
+
+	for (i = 0; i < stripstatstrips; i++)
+		total += stripstattime[i];
+
+	CONS_Printf(M_GetText("Drew %u views in %d strips\n"), stripstatframes, stripstatstrips);
+	for (i = 0; i < stripstatstrips; i++)
+	{
+		CONS_Printf(M_GetText("Strip %d (%d columns): %u us last, %u us average, %u us most, %u%% of the time\n"),
+			i + 1, stripstatwidths[i],
+			(UINT32)(stripstatlast[i] * 1000000 / precision),
+			(UINT32)(stripstattime[i] * 1000000 / precision / stripstatframes),
+			(UINT32)(stripstatmaxtime[i] * 1000000 / precision),
+			total ? (UINT32)(stripstattime[i] * 100 / total) : 0);
+	}
+}
+#endif
+
+//
+// Command_Framearena_f
+// Shows how much scratch memory the views have needed.
+//
+static void Command_Framearena_f(void)
+{
+	if (COM_Argc() > 1 && !stricmp(COM_Argv(1), "reset"))
+	{
+		Lock_framestats();
+		framestatmaxused = 0;
+		framestatviews = framestatgrowths = 0;
+		Unlock_framestats();
+		return;
+	}
+
+	if (!framestatviews)
+	{
+		CONS_Printf(M_GetText("No views have been drawn yet.\n"));
+		return;
+	}
+
+	CONS_Printf(M_GetText("Frame arena: %s KB at most used by a view, %s KB block\n"),
+		sizeu1(framestatmaxused >> 10), sizeu2(framestatsize >> 10));
+	CONS_Printf(M_GetText("%u views drawn, %u needed the block to grow\n"), framestatviews, framestatgrowths);
+}
+
+//
+// Command_Tiltcheck_f
+// Compares the texels sloped planes are drawn with against the per-pixel reference.
+//
+static void Command_Tiltcheck_f(void)
+{
+	R_ToggleTiltCheck();
+}
+
+//
+// Command_Translationstats_f
+// Shows how often sprite colormaps are found in the cache.
+//
+static void Command_Translationstats_f(void)
+{
+	R_PrintTranslationStats();
+}
+
+//
+// Command_Drawbench_f
+// Checks the SIMD drawers against the C ones and times them.
+//
+static void Command_Drawbench_f(void)
+{
+	INT32 runs = 10000;
+
+	if (COM_Argc() > 1)
+		runs = atoi(COM_Argv(1));
+	if (runs < 1)
+	{
+		CONS_Printf(M_GetText("drawbench [runs]: check the SIMD drawers draw the same as the C ones, and time them\n"));
+		return;
+	}
+
+	R_BenchmarkDrawers(runs);
+}
+
 // =========================================================================
 //                    ENGINE COMMANDS & VARS
 // =========================================================================
 
 void R_RegisterEngineStuff(void)
 {
+	COM_AddCommand("spritestats", Command_Spritestats_f);
+	COM_AddCommand("drawbench", Command_Drawbench_f);
+	COM_AddCommand("tiltcheck", Command_Tiltcheck_f);
+	COM_AddCommand("translationstats", Command_Translationstats_f);
+	COM_AddCommand("framearena", Command_Framearena_f);
+	M_InitPerfStats();
+#ifdef THREADEDRENDER
+	COM_AddCommand("stripstats", Command_Stripstats_f);
+#endif
+
 	CV_RegisterVar(&cv_gravity);
 	CV_RegisterVar(&cv_tailspickup);
 	CV_RegisterVar(&cv_soniccd);
 	CV_RegisterVar(&cv_allowmlook);
 	CV_RegisterVar(&cv_homremoval);
+	CV_RegisterVar(&cv_tiltedspansize);
+#ifdef THREADEDRENDER
+	CV_RegisterVar(&cv_renderthreads);
+	CV_RegisterVar(&cv_renderstrips);
+#endif
 	CV_RegisterVar(&cv_flipcam);
 	CV_RegisterVar(&cv_flipcam2);
 	CV_RegisterVar(&cv_flipcam3);
@@ -20,14 +20,22 @@
 //
 // POV related.
 //
-extern fixed_t viewcos, viewsin;
+extern THREADLOCAL fixed_t viewcos, viewsin;
 extern INT32 viewheight;
-extern INT32 centerx, centery;
+extern INT32 centerx;
+extern THREADLOCAL INT32 centery;
 
-extern fixed_t centerxfrac, centeryfrac;
+extern fixed_t centerxfrac;
+extern THREADLOCAL fixed_t centeryfrac;
 extern fixed_t projection, projectiony;
 
-extern size_t validcount, linecount, loopcount, framecount;
+extern size_t validcount, linecount, loopcount;
+extern THREADLOCAL size_t framecount;
+
+// Per-view scratch memory, dropped when the next view starts
+extern THREADLOCAL UINT32 frameepoch;
+void *R_FrameAlloc(size_t size);
+void R_ResetFrameArena(void);
 
 // The fraction of a tic being drawn (for interpolation between two tics)
 extern fixed_t rendertimefrac;
@@ -89,6 +97,10 @@ extern consvar_t /*cv_precipdensity,*/ cv_drawdist, /*cv_drawdist_nights,*/ cv_d
 extern consvar_t cv_fov;
 extern consvar_t cv_skybox;
 extern consvar_t cv_tailspickup;
+extern consvar_t cv_tiltedspansize;
+#ifdef THREADEDRENDER
+extern consvar_t cv_renderthreads, cv_renderstrips;
+#endif
 
 // Called by startup code.
 void R_Init(void);
@@ -105,6 +117,11 @@ void R_SkyboxFrame(player_t *player);
 void R_SetupFrame(player_t *player, boolean skybox);
 // Called by G_Drawer.
 void R_RenderPlayerView(player_t *player);
+#ifdef THREADEDRENDER
+// Draws all splitscreen views at once, or one view in strips, on worker threads.
+boolean R_UseViewThreads(void);
+void R_RenderPlayerViews(void);
+#endif
 
 // add commands related to engine, at game startup
 void R_RegisterEngineStuff(void);
@@ -52,44 +52,47 @@
 // the last visplane list is outside of the hash table and is used for fof planes
 #define MAXVISPLANES ((1<<VISPLANEHASHBITS)+1)
 
-static visplane_t *visplanes[MAXVISPLANES];
-static visplane_t *freetail;
-static visplane_t **freehead = &freetail;
+static THREADLOCAL visplane_t *visplanes[MAXVISPLANES];
+static THREADLOCAL visplane_t *freetail;
+static THREADLOCAL visplane_t **freehead; // &freetail, set by R_ClearPlanes
 
-visplane_t *floorplane;
-visplane_t *ceilingplane;
-static visplane_t *currentplane;
+THREADLOCAL visplane_t *floorplane;
+THREADLOCAL visplane_t *ceilingplane;
+static THREADLOCAL visplane_t *currentplane;
 
-visffloor_t ffloor[MAXFFLOORS];
-INT32 numffloors;
+// For perfstats
+THREADLOCAL UINT32 numvisplanes, numspans;
+
+THREADLOCAL visffloor_t ffloor[MAXFFLOORS];
+THREADLOCAL INT32 numffloors;
 
 //SoM: 3/23/2000: Boom visplane hashing routine.
 #define visplane_hash(picnum,lightlevel,height) \
   ((unsigned)((picnum)*3+(lightlevel)+(height)*7) & VISPLANEHASHMASK)
 
 //SoM: 3/23/2000: Use boom opening limit removal
-size_t maxopenings;
-INT16 *openings, *lastopening; /// \todo free leak
+THREADLOCAL size_t maxopenings;
+THREADLOCAL INT16 *openings, *lastopening; /// \todo free leak
 
 //
 // Clip values are the solid pixel bounding the range.
 //  floorclip starts out SCREENHEIGHT
 //  ceilingclip starts out -1
 //
-INT16 floorclip[MAXVIDWIDTH], ceilingclip[MAXVIDWIDTH];
-fixed_t frontscale[MAXVIDWIDTH];
+THREADLOCAL INT16 floorclip[MAXVIDWIDTH], ceilingclip[MAXVIDWIDTH];
+THREADLOCAL fixed_t frontscale[MAXVIDWIDTH];
 
 //
 // spanstart holds the start of a plane span
 // initialized to 0 at start
 //
-static INT32 spanstart[MAXVIDHEIGHT];
+static THREADLOCAL INT32 spanstart[MAXVIDHEIGHT];
 
 //
 // texture mapping
 //
-lighttable_t **planezlight;
-static fixed_t planeheight;
+THREADLOCAL lighttable_t **planezlight;
+static THREADLOCAL fixed_t planeheight;
 
 //added : 10-02-98: yslopetab is what yslope used to be,
 //                yslope points somewhere into yslopetab,
@@ -99,16 +102,16 @@ static fixed_t planeheight;
 //                (when mouselookin', yslope is moving into yslopetab)
 //                Check R_SetupFrame, R_SetViewSize for more...
 fixed_t yslopetab[MAXVIDHEIGHT*16];
-fixed_t *yslope;
+THREADLOCAL fixed_t *yslope;
 
-fixed_t basexscale, baseyscale;
+THREADLOCAL fixed_t basexscale, baseyscale;
 
-fixed_t cachedheight[MAXVIDHEIGHT];
-fixed_t cacheddistance[MAXVIDHEIGHT];
-fixed_t cachedxstep[MAXVIDHEIGHT];
-fixed_t cachedystep[MAXVIDHEIGHT];
+THREADLOCAL fixed_t cachedheight[MAXVIDHEIGHT];
+THREADLOCAL fixed_t cacheddistance[MAXVIDHEIGHT];
+THREADLOCAL fixed_t cachedxstep[MAXVIDHEIGHT];
+THREADLOCAL fixed_t cachedystep[MAXVIDHEIGHT];
 
-static fixed_t xoffs, yoffs;
+static THREADLOCAL fixed_t xoffs, yoffs;
 
 //
 // R_InitPlanes
@@ -177,10 +180,10 @@ void R_PortalRestoreClipValues(INT32 start, INT32 end, INT16 *ceil, INT16 *floor
 //  viewheight
 
 #ifndef NOWATER
-static INT32 bgofs;
-static INT32 wtofs=0;
-static INT32 waterofs;
-static boolean itswater;
+static THREADLOCAL INT32 bgofs;
+static THREADLOCAL INT32 wtofs=0;
+static THREADLOCAL INT32 waterofs;
+static THREADLOCAL boolean itswater;
 #endif
 
 #ifndef NOWATER
@@ -210,7 +213,7 @@ static void R_DrawTranslucentWaterSpan_8(void)
 	source = ds_source;
 	colormap = ds_colormap;
 	dest = ylookup[ds_y] + columnofs[ds_x1];
-	dsrc = screens[1] + (ds_y+bgofs)*vid.width + ds_x1;
+	dsrc = screens[1] + (viewwindowy+ds_y+bgofs)*vid.width + viewwindowx + ds_x1;
 	count = ds_x2 - ds_x1 + 1;
 
 	while (count >= 8)
@@ -276,6 +279,8 @@ void R_MapPlane(INT32 y, INT32 x1, INT32 x2)
 	// from r_splats's R_RenderFloorSplat
 	if (x1 >= vid.width) x1 = vid.width - 1;
 
+	numspans++;
+
 	angle = (currentplane->viewangle + currentplane->plangle)>>ANGLETOFINESHIFT;
 	planecos = FINECOSINE(angle);
 	planesin = FINESINE(angle);
@@ -379,6 +384,9 @@ void R_ClearPlanes(void)
 
 	numffloors = 0;
 
+	if (!freehead)
+		freehead = &freetail;
+
 	for (i = 0; i < MAXVISPLANES; i++)
 	for (*freehead = visplanes[i], visplanes[i] = NULL;
 		freehead && *freehead ;)
@@ -387,6 +395,7 @@ void R_ClearPlanes(void)
 	}
 
 	lastopening = openings;
+	numvisplanes = numspans = 0;
 
 	// texture calculation
 	memset(cachedheight, 0, sizeof (cachedheight));
@@ -413,6 +422,7 @@ static visplane_t *new_visplane(unsigned hash)
 		if (!freetail)
 			freehead = &freetail;
 	}
+	numvisplanes++;
 	check->next = visplanes[hash];
 	visplanes[hash] = check;
 	return check;
@@ -766,7 +776,7 @@ void R_DrawSinglePlane(visplane_t *pl)
 	spanfunc = basespanfunc;
 
 	if (pl->polyobj && pl->polyobj->translucency != 0) {
-		spanfunc = R_DrawTranslucentSpan_8;
+		spanfunc = transspanfunc;
 
 		// Hacked up support for alpha value in software mode Tails 09-24-2002 (sidenote: ported to polys 10-15-2014, there was no time travel involved -Red)
 		if (pl->polyobj->translucency >= 10)
@@ -807,7 +817,7 @@ void R_DrawSinglePlane(visplane_t *pl)
 
 		if (pl->ffloor->flags & FF_TRANSLUCENT)
 		{
-			spanfunc = R_DrawTranslucentSpan_8;
+			spanfunc = transspanfunc;
 
 			// Hacked up support for alpha value in software mode Tails 09-24-2002
 			if (pl->ffloor->alpha < 12)
@@ -855,10 +865,10 @@ void R_DrawSinglePlane(visplane_t *pl)
 			)
 		{
 			INT32 top, bottom;
-			UINT8 *scr;
+			size_t ofs;
 
 			itswater = true;
-			if (spanfunc == R_DrawTranslucentSpan_8)
+			if (spanfunc == transspanfunc)
 			{
 				spanfunc = R_DrawTranslucentWaterSpan_8;
 
@@ -868,21 +878,14 @@ void R_DrawSinglePlane(visplane_t *pl)
 
 				if (top < 0)
 					top = 0;
-				if (bottom > vid.height)
-					bottom = vid.height;
-
-				if (splitscreen > 2 && viewplayer == &players[displayplayers[3]]) // Only copy the part of the screen we need
-					scr = (screens[0] + (top+(viewheight))*vid.width + viewwidth);
-				else if ((splitscreen == 1 && viewplayer == &players[displayplayers[1]])
-					|| (splitscreen > 1 && viewplayer == &players[displayplayers[2]]))
-					scr = (screens[0] + (top+(viewheight))*vid.width);
-				else if (splitscreen > 1 && viewplayer == &players[displayplayers[1]])
-					scr = (screens[0] + ((top)*vid.width) + viewwidth);
-				else
-					scr = (screens[0] + ((top)*vid.width));
-
-				VID_BlitLinearScreen(scr, screens[1]+((top)*vid.width),
-				                     vid.width, bottom-top,
+				if (bottom > viewheight)
+					bottom = viewheight;
+
+				// Only copy the part of the screen we need. It stays where
+				// it is, as other views or strips may be copying theirs too.
+				ofs = (viewwindowy+top)*vid.width + viewwindowx + viewclipx1;
+				VID_BlitLinearScreen(screens[0]+ofs, screens[1]+ofs,
+				                     viewclipx2-viewclipx1+1, bottom-top,
 				                     vid.width, vid.width);
 			}
 		}
@@ -1094,7 +1097,7 @@ void R_DrawSinglePlane(visplane_t *pl)
 		ds_sv.z *= SFMULT;
 #undef SFMULT
 
-		if (spanfunc == R_DrawTranslucentSpan_8)
+		if (spanfunc == transspanfunc)
 			spanfunc = R_DrawTiltedTranslucentSpan_8;
 		else if (spanfunc == splatfunc)
 			spanfunc = R_DrawTiltedSplat_8;
@@ -1145,11 +1148,11 @@ a 'smoothing' of the texture while
 using the palette colors.
 */
 #ifdef QUINCUNX
-	if (spanfunc == R_DrawSpan_8)
+	if (spanfunc == basespanfunc)
 	{
 		INT32 i;
 		ds_transmap = transtables + ((tr_trans50-1)<<FF_TRANSSHIFT);
-		spanfunc = R_DrawTranslucentSpan_8;
+		spanfunc = transspanfunc;
 		for (i=0; i<4; i++)
 		{
 			xoffs = pl->xoffs;
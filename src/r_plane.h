@@ -51,23 +51,25 @@ typedef struct visplane_s
 	boolean noencore;
 } visplane_t;
 
-extern visplane_t *floorplane;
-extern visplane_t *ceilingplane;
+extern THREADLOCAL visplane_t *floorplane;
+extern THREADLOCAL visplane_t *ceilingplane;
 
 // Visplane related.
-extern INT16 *lastopening, *openings;
-extern size_t maxopenings;
-
-extern INT16 floorclip[MAXVIDWIDTH], ceilingclip[MAXVIDWIDTH];
-extern fixed_t frontscale[MAXVIDWIDTH], yslopetab[MAXVIDHEIGHT*16];
-extern fixed_t cachedheight[MAXVIDHEIGHT];
-extern fixed_t cacheddistance[MAXVIDHEIGHT];
-extern fixed_t cachedxstep[MAXVIDHEIGHT];
-extern fixed_t cachedystep[MAXVIDHEIGHT];
-extern fixed_t basexscale, baseyscale;
-
-extern fixed_t *yslope;
-extern lighttable_t **planezlight;
+extern THREADLOCAL INT16 *lastopening, *openings;
+extern THREADLOCAL size_t maxopenings;
+extern THREADLOCAL UINT32 numvisplanes, numspans;
+
+extern THREADLOCAL INT16 floorclip[MAXVIDWIDTH], ceilingclip[MAXVIDWIDTH];
+extern THREADLOCAL fixed_t frontscale[MAXVIDWIDTH];
+extern fixed_t yslopetab[MAXVIDHEIGHT*16];
+extern THREADLOCAL fixed_t cachedheight[MAXVIDHEIGHT];
+extern THREADLOCAL fixed_t cacheddistance[MAXVIDHEIGHT];
+extern THREADLOCAL fixed_t cachedxstep[MAXVIDHEIGHT];
+extern THREADLOCAL fixed_t cachedystep[MAXVIDHEIGHT];
+extern THREADLOCAL fixed_t basexscale, baseyscale;
+
+extern THREADLOCAL fixed_t *yslope;
+extern THREADLOCAL lighttable_t **planezlight;
 
 void R_InitPlanes(void);
 void R_PortalStoreClipValues(INT32 start, INT32 end, INT16 *ceil, INT16 *floor, fixed_t *scale);
@@ -110,6 +112,6 @@ typedef struct planemgr_s
 	polyobj_t *polyobj;
 } visffloor_t;
 
-extern visffloor_t ffloor[MAXFFLOORS];
-extern INT32 numffloors;
+extern THREADLOCAL visffloor_t ffloor[MAXFFLOORS];
+extern THREADLOCAL INT32 numffloors;
 #endif
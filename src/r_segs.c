@@ -28,47 +28,47 @@
 // OPTIMIZE: closed two sided lines as single sided
 
 // True if any of the segs textures might be visible.
-static boolean segtextured;
-static boolean markfloor; // False if the back side is the same plane.
-static boolean markceiling;
+static THREADLOCAL boolean segtextured;
+static THREADLOCAL boolean markfloor; // False if the back side is the same plane.
+static THREADLOCAL boolean markceiling;
 
-static boolean maskedtexture;
-static INT32 toptexture, bottomtexture, midtexture;
-static INT32 numthicksides, numbackffloors;
+static THREADLOCAL boolean maskedtexture;
+static THREADLOCAL INT32 toptexture, bottomtexture, midtexture;
+static THREADLOCAL INT32 numthicksides, numbackffloors;
 
-angle_t rw_normalangle;
+THREADLOCAL angle_t rw_normalangle;
 // angle to line origin
-angle_t rw_angle1;
-fixed_t rw_distance;
+THREADLOCAL angle_t rw_angle1;
+THREADLOCAL fixed_t rw_distance;
 
 //
 // regular wall
 //
-static INT32 rw_x, rw_stopx;
-static angle_t rw_centerangle;
-static fixed_t rw_offset;
-static fixed_t rw_offset2; // for splats
-static fixed_t rw_scale, rw_scalestep;
-static fixed_t rw_midtexturemid, rw_toptexturemid, rw_bottomtexturemid;
-static INT32 worldtop, worldbottom, worldhigh, worldlow;
-static INT32 worldtopslope, worldbottomslope, worldhighslope, worldlowslope; // worldtop/bottom at end of slope
-static fixed_t rw_toptextureslide, rw_midtextureslide, rw_bottomtextureslide; // Defines how to adjust Y offsets along the wall for slopes
-static fixed_t rw_midtextureback, rw_midtexturebackslide; // Values for masked midtexture height calculation
-static fixed_t pixhigh, pixlow, pixhighstep, pixlowstep;
-static fixed_t topfrac, topstep;
-static fixed_t bottomfrac, bottomstep;
-
-static lighttable_t **walllights;
-static INT16 *maskedtexturecol;
-static fixed_t *maskedtextureheight = NULL;
+static THREADLOCAL INT32 rw_x, rw_stopx;
+static THREADLOCAL angle_t rw_centerangle;
+static THREADLOCAL fixed_t rw_offset;
+static THREADLOCAL fixed_t rw_offset2; // for splats
+static THREADLOCAL fixed_t rw_scale, rw_scalestep;
+static THREADLOCAL fixed_t rw_midtexturemid, rw_toptexturemid, rw_bottomtexturemid;
+static THREADLOCAL INT32 worldtop, worldbottom, worldhigh, worldlow;
+static THREADLOCAL INT32 worldtopslope, worldbottomslope, worldhighslope, worldlowslope; // worldtop/bottom at end of slope
+static THREADLOCAL fixed_t rw_toptextureslide, rw_midtextureslide, rw_bottomtextureslide; // Defines how to adjust Y offsets along the wall for slopes
+static THREADLOCAL fixed_t rw_midtextureback, rw_midtexturebackslide; // Values for masked midtexture height calculation
+static THREADLOCAL fixed_t pixhigh, pixlow, pixhighstep, pixlowstep;
+static THREADLOCAL fixed_t topfrac, topstep;
+static THREADLOCAL fixed_t bottomfrac, bottomstep;
+
+static THREADLOCAL lighttable_t **walllights;
+static THREADLOCAL INT16 *maskedtexturecol;
+static THREADLOCAL fixed_t *maskedtextureheight = NULL;
 
 // ==========================================================================
 // R_Splats Wall Splats Drawer
 // ==========================================================================
 
 #ifdef WALLSPLATS
-static INT16 last_ceilingclip[MAXVIDWIDTH];
-static INT16 last_floorclip[MAXVIDWIDTH];
+static THREADLOCAL INT16 last_ceilingclip[MAXVIDWIDTH];
+static THREADLOCAL INT16 last_floorclip[MAXVIDWIDTH];
 
 static void R_DrawSplatColumn(column_t *column)
 {
@@ -237,7 +237,7 @@ static void R_DrawWallSplats(void)
 //  way we don't have to store extra post_t info with each column for
 //  multi-patch textures. They are not normally needed as multi-patch
 //  textures don't have holes in it. At least not for now.
-static INT32 column2s_length; // column->length : for multi-patch on 2sided wall = texture->height
+static THREADLOCAL INT32 column2s_length; // column->length : for multi-patch on 2sided wall = texture->height
 
 static void R_Render2sidedMultiPatchColumn(column_t *column)
 {
@@ -1611,7 +1611,7 @@ void R_StoreWallRange(INT32 start, INT32 stop)
 	INT32 range;
 	vertex_t segleft, segright;
 	fixed_t ceilingfrontslide, floorfrontslide, ceilingbackslide, floorbackslide;
-	static size_t maxdrawsegs = 0;
+	static THREADLOCAL size_t maxdrawsegs = 0;
 
 	maskedtextureheight = NULL;
 	//initialize segleft and segright
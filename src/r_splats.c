@@ -38,7 +38,8 @@ struct rastery_s
 	fixed_t tx1, ty1;
 	fixed_t tx2, ty2; // start/end points in texture at this line
 };
-static struct rastery_s rastertab[MAXVIDHEIGHT];
+static THREADLOCAL struct rastery_s rastertab[MAXVIDHEIGHT];
+static THREADLOCAL boolean rastertabready;
 
 static void prepare_rastertab(void);
 #endif
@@ -303,11 +304,28 @@ void R_AddFloorSplat(subsector_t *subsec, mobj_t *mobj, const char *picname, fix
 // --------------------------------------------------------------------------
 // Before each frame being rendered, clear the visible floorsplats list
 // --------------------------------------------------------------------------
-static floorsplat_t *visfloorsplats;
+// Kept apart from the splats themselves, which every view shares.
+static THREADLOCAL floorsplat_t **visfloorsplats;
+static THREADLOCAL size_t numvisfloorsplats, maxvisfloorsplats;
 
 void R_ClearVisibleFloorSplats(void)
 {
-	visfloorsplats = NULL;
+	numvisfloorsplats = 0;
+
+	if (!rastertabready)
+		prepare_rastertab();
+}
+
+static void R_AddVisibleFloorSplat(floorsplat_t *pSplat)
+{
+	if (numvisfloorsplats >= maxvisfloorsplats)
+	{
+		maxvisfloorsplats = maxvisfloorsplats ? maxvisfloorsplats*2 : 32;
+		visfloorsplats = realloc(visfloorsplats, maxvisfloorsplats * sizeof (*visfloorsplats));
+		if (!visfloorsplats)
+			I_Error("%s: Out of memory", "R_AddVisibleFloorSplat");
+	}
+	visfloorsplats[numvisfloorsplats++] = pSplat;
 }
 
 // --------------------------------------------------------------------------
@@ -323,19 +341,13 @@ void R_AddVisibleFloorSplats(subsector_t *subsec)
 	// FIXME: depending on some flag in pSplat->flags, some splats may be visible from 2 sides
 	// (above/below)
 	if (pSplat->z < viewz)
-	{
-		pSplat->nextvis = visfloorsplats;
-		visfloorsplats = pSplat;
-	}
+		R_AddVisibleFloorSplat(pSplat);
 
 	while (pSplat->next)
 	{
 		pSplat = pSplat->next;
 		if (pSplat->z < viewz)
-		{
-			pSplat->nextvis = visfloorsplats;
-			visfloorsplats = pSplat;
-		}
+			R_AddVisibleFloorSplat(pSplat);
 	}
 }
 
@@ -467,10 +479,10 @@ static void R_RenderFloorSplat(floorsplat_t *pSplat, vertex_t *verts, UINT8 *pTe
 		x1 = rastertab[y].minx>>FRACBITS;
 		x2 = rastertab[y].maxx>>FRACBITS;
 
-		if (x1 < 0)
-			x1 = 0;
-		if (x2 >= vid.width)
-			x2 = vid.width - 1;
+		if (x1 < viewclipx1)
+			x1 = viewclipx1;
+		if (x2 > viewclipx2)
+			x2 = viewclipx2;
 
 		angle = (currentplane->viewangle + currentplane->plangle)>>ANGLETOFINESHIFT;
 		planecos = FINECOSINE(angle);
@@ -525,10 +537,10 @@ static void R_RenderFloorSplat(floorsplat_t *pSplat, vertex_t *verts, UINT8 *pTe
 	{
 		x1 = rastertab[y].minx>>FRACBITS;
 		x2 = rastertab[y].maxx>>FRACBITS;
-		if (x1 < 0)
-			x1 = 0;
-		if (x2 >= vid.width)
-			x2 = vid.width - 1;
+		if (x1 < viewclipx1)
+			x1 = viewclipx1;
+		if (x2 > viewclipx2)
+			x2 = viewclipx2;
 
 //		pDest = ylookup[y] + columnofs[x1];
 		pDest = &topleft[y*vid.width + x1];
@@ -568,13 +580,15 @@ void R_DrawVisibleFloorSplats(void)
 {
 	floorsplat_t *pSplat;
 	INT32 iCount = 0, i;
+	size_t n;
 	fixed_t tr_x, tr_y, rot_x, rot_y, rot_z, xscale, yscale;
 	vertex_t *v3d;
 	vertex_t v2d[4];
 
-	pSplat = visfloorsplats;
-	while (pSplat)
+	// newest first
+	for (n = numvisfloorsplats; n--;)
 	{
+		pSplat = visfloorsplats[n];
 		iCount++;
 
 		// Draw a floor splat
@@ -609,7 +623,7 @@ void R_DrawVisibleFloorSplats(void)
 
 		R_RenderFloorSplat(pSplat, v2d, NULL);
 skipit:
-		pSplat = pSplat->nextvis;
+		;
 	}
 }
 
@@ -621,6 +635,7 @@ static void prepare_rastertab(void)
 		rastertab[iLine].minx = INT32_MAX;
 		rastertab[iLine].maxx = INT32_MIN;
 	}
+	rastertabready = true;
 }
 
 #endif // FLOORSPLATS
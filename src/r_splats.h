@@ -56,7 +56,6 @@ typedef struct floorsplat_s
 	subsector_t *subsector; // the parent subsector
 	mobj_t *mobj; // Mobj it is tied to
 	struct floorsplat_s *next;
-	struct floorsplat_s *nextvis;
 } floorsplat_t;
 
 // p_setup.c
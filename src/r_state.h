@@ -87,17 +87,19 @@ extern side_t *sides;
 //
 // POV data.
 //
-extern fixed_t viewx, viewy, viewz;
-extern angle_t viewangle, aimingangle;
-extern UINT8 viewssnum; // splitscreen view number
-extern boolean viewsky, skyVisible;
+extern THREADLOCAL fixed_t viewx, viewy, viewz;
+extern THREADLOCAL angle_t viewangle, aimingangle;
+extern THREADLOCAL UINT8 viewssnum; // splitscreen view number
+extern THREADLOCAL INT32 viewclipx1, viewclipx2; // columns of the view being drawn, less than all of it in strips
+extern boolean viewsky;
+extern THREADLOCAL boolean skyVisible;
 extern boolean skyVisiblePerPlayer[MAXSPLITSCREENPLAYERS]; // saved values of skyVisible of each splitscreen player
-extern sector_t *viewsector;
-extern player_t *viewplayer;
-extern UINT8 portalrender;
-extern sector_t *portalcullsector;
-extern line_t *portalclipline;
-extern INT32 portalclipstart, portalclipend;
+extern THREADLOCAL sector_t *viewsector;
+extern THREADLOCAL player_t *viewplayer;
+extern THREADLOCAL UINT8 portalrender;
+extern THREADLOCAL sector_t *portalcullsector;
+extern THREADLOCAL line_t *portalclipline;
+extern THREADLOCAL INT32 portalclipstart, portalclipend;
 
 extern consvar_t cv_allowmlook;
 extern consvar_t cv_maxportals;
@@ -108,10 +110,10 @@ extern angle_t doubleclipangle;
 extern INT32 viewangletox[FINEANGLES/2];
 extern angle_t xtoviewangle[MAXVIDWIDTH+1];
 
-extern fixed_t rw_distance;
-extern angle_t rw_normalangle;
+extern THREADLOCAL fixed_t rw_distance;
+extern THREADLOCAL angle_t rw_normalangle;
 
 // angle to line origin
-extern angle_t rw_angle1;
+extern THREADLOCAL angle_t rw_angle1;
 
 #endif
@@ -20,6 +20,7 @@
 #include "z_zone.h"
 #include "m_misc.h"
 #include "i_video.h" // rendermode
+#include "i_system.h" // I_GetPreciseTime
 #include "r_fps.h"
 #include "r_things.h"
 #include "r_plane.h"
@@ -29,8 +30,10 @@
 #include "dehacked.h" // get_number (for thok)
 #include "d_netfil.h" // blargh. for nameonly().
 #include "m_cheat.h" // objectplace
+#include "i_threads.h"
 #include "k_kart.h" // SRB2kart
 #include "p_local.h" // stplyr
+#include "m_perfstats.h"
 #ifdef HWRENDER
 #include "hardware/hw_md2.h"
 #endif
@@ -62,7 +65,7 @@ typedef struct
 //  which increases counter clockwise (protractor).
 // There was a lot of stuff grabbed wrong, so I changed it...
 //
-static lighttable_t **spritelights;
+static THREADLOCAL lighttable_t **spritelights;
 
 // constant arrays used for psprite clipping and initializing clipping
 INT16 negonearray[MAXVIDWIDTH];
@@ -101,11 +104,11 @@ typedef struct drawsegs_xrange_s
 } drawsegs_xrange_t;
 
 #define DS_RANGES_COUNT 3
-static drawsegs_xrange_t drawsegs_xranges[DS_RANGES_COUNT];
+static THREADLOCAL drawsegs_xrange_t drawsegs_xranges[DS_RANGES_COUNT];
 
-static drawseg_xrange_item_t *drawsegs_xrange;
-static size_t drawsegs_xrange_size = 0;
-static INT32 drawsegs_xrange_count = 0;
+static THREADLOCAL drawseg_xrange_item_t *drawsegs_xrange;
+static THREADLOCAL size_t drawsegs_xrange_size = 0;
+static THREADLOCAL INT32 drawsegs_xrange_count = 0;
 
 // ==========================================================================
 //
@@ -575,9 +578,20 @@ void R_DelSpriteDefs(UINT16 wadnum)
 //
 // GAME FUNCTIONS
 //
-UINT32 visspritecount;
-static UINT32 clippedvissprites;
-static vissprite_t *visspritechunks[MAXVISSPRITES >> VISSPRITECHUNKBITS] = {NULL};
+THREADLOCAL UINT32 visspritecount;
+static THREADLOCAL UINT32 clippedvissprites;
+// Vissprites come out of the frame arena in chunks, listed here.
+// The list is only good for the view visspriteepoch was taken in.
+static THREADLOCAL vissprite_t **visspritechunks;
+static THREADLOCAL UINT32 numvisspritechunks, maxvisspritechunks;
+static THREADLOCAL UINT32 visspriteepoch;
+
+// Sectors R_AddSprites has been through, marked with spritevalidcount.
+// sector_t has a validcount of its own, but views being rendered at the
+// same time would trample each other's marks in it.
+THREADLOCAL size_t spritevalidcount = 1;
+static THREADLOCAL size_t *sectorspritemarks;
+static THREADLOCAL size_t numsectorspritemarks;
 
 
 //
@@ -635,29 +649,54 @@ void R_InitSprites(void)
 void R_ClearSprites(void)
 {
 	visspritecount = clippedvissprites = 0;
+
+	// The skybox pass and the view proper share one frame, so their chunks
+	// can be reused; anything from an earlier frame is gone with the arena.
+	if (visspriteepoch != frameepoch)
+	{
+		visspriteepoch = frameepoch;
+		visspritechunks = NULL;
+		numvisspritechunks = maxvisspritechunks = 0;
+	}
+
+	if (numsectorspritemarks < numsectors)
+	{
+		free(sectorspritemarks);
+		numsectorspritemarks = numsectors;
+		sectorspritemarks = calloc(numsectorspritemarks, sizeof (*sectorspritemarks));
+		if (!sectorspritemarks)
+			I_Error("%s: Out of memory", "R_ClearSprites");
+	}
 }
 
 //
 // R_NewVisSprite
 //
-static vissprite_t overflowsprite;
-
 static vissprite_t *R_GetVisSprite(UINT32 num)
 {
-		UINT32 chunk = num >> VISSPRITECHUNKBITS;
+	UINT32 chunk = num >> VISSPRITECHUNKBITS;
 
-		// Allocate chunk if necessary
-		if (!visspritechunks[chunk])
-			Z_Malloc(sizeof(vissprite_t) * VISSPRITESPERCHUNK, PU_LEVEL, &visspritechunks[chunk]);
+	// Allocate chunk if necessary
+	if (chunk >= numvisspritechunks)
+	{
+		if (numvisspritechunks == maxvisspritechunks)
+		{
+			vissprite_t **chunks;
+
+			maxvisspritechunks = maxvisspritechunks ? maxvisspritechunks*2 : MAXVISSPRITES >> VISSPRITECHUNKBITS;
+			chunks = R_FrameAlloc(maxvisspritechunks * sizeof (*chunks));
+			if (numvisspritechunks)
+				M_Memcpy(chunks, visspritechunks, numvisspritechunks * sizeof (*chunks));
+			visspritechunks = chunks;
+		}
+		visspritechunks[numvisspritechunks++] = R_FrameAlloc(sizeof(vissprite_t) * VISSPRITESPERCHUNK);
+	}
 
-		return visspritechunks[chunk] + (num & VISSPRITEINDEXMASK);
+	return visspritechunks[chunk] + (num & VISSPRITEINDEXMASK);
 }
 
 static vissprite_t *R_NewVisSprite(void)
 {
-	if (visspritecount == MAXVISSPRITES)
-		return &overflowsprite;
-
 	return R_GetVisSprite(visspritecount++);
 }
 
@@ -667,11 +706,11 @@ static vissprite_t *R_NewVisSprite(void)
 // Masked means: partly transparent, i.e. stored
 //  in posts/runs of opaque pixels.
 //
-INT16 *mfloorclip;
-INT16 *mceilingclip;
+THREADLOCAL INT16 *mfloorclip;
+THREADLOCAL INT16 *mceilingclip;
 
-fixed_t spryscale = 0, sprtopscreen = 0, sprbotscreen = 0;
-fixed_t windowtop = 0, windowbottom = 0;
+THREADLOCAL fixed_t spryscale = 0, sprtopscreen = 0, sprbotscreen = 0;
+THREADLOCAL fixed_t windowtop = 0, windowbottom = 0;
 
 void R_DrawMaskedColumn(column_t *column)
 {
@@ -1293,7 +1332,7 @@ static void R_ProjectSprite(mobj_t *thing)
 	x1 = (centerxfrac + FixedMul (tx,xscale)) >>FRACBITS;
 
 	// off the right side?
-	if (x1 > viewwidth)
+	if (x1 > viewclipx2)
 		return;
 
 	offset2 = FixedMul(spritecachedinfo[lump].width, this_scale);
@@ -1301,7 +1340,7 @@ static void R_ProjectSprite(mobj_t *thing)
 	x2 = ((centerxfrac + FixedMul (tx,xscale)) >> FRACBITS) - 1;
 
 	// off the left side
-	if (x2 < 0)
+	if (x2 < viewclipx1)
 		return;
 
 	if (papersprite)
@@ -1445,8 +1484,8 @@ static void R_ProjectSprite(mobj_t *thing)
 
 	vis->mobj = thing; // Easy access! Tails 06-07-2002
 
-	vis->x1 = x1 < 0 ? 0 : x1;
-	vis->x2 = x2 >= viewwidth ? viewwidth-1 : x2;
+	vis->x1 = x1 < viewclipx1 ? viewclipx1 : x1;
+	vis->x2 = x2 > viewclipx2 ? viewclipx2 : x2;
 
 	// PORTAL SEMI-CLIPPING
 	if (portalrender)
@@ -1534,11 +1573,12 @@ static void R_ProjectSprite(mobj_t *thing)
 	if (thing->subsector->sector->numlights)
 		R_SplitSprite(vis, thing);
 
-	// Debug
-	++objectsdrawn;
+	// Debug; a sprite across strips counts for the one it starts in
+	if (x1 >= viewclipx1 || !viewclipx1)
+		++objectsdrawn;
 }
 
-static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
+static void R_ProjectPrecipitationSprite(size_t i)
 {
 	fixed_t tr_x, tr_y;
 	fixed_t gxt, gyt;
@@ -1558,22 +1598,18 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	//SoM: 3/17/2000
 	fixed_t gz ,gzt;
 
-	// uncapped/interpolation
-	interpmobjstate_t interp = {0};
+	const spritenum_t sprite = precip.state[i]->sprite;
+	const UINT32 frame = precip.frame[i];
+	sector_t *sector = precip.subsector[i]->sector;
+	fixed_t z = precip.z[i];
 
 	// do interpolation
 	if (R_UsingFrameInterpolation() && !paused)
-	{
-		R_InterpolatePrecipMobjState(thing, rendertimefrac, &interp);
-	}
-	else
-	{
-		R_InterpolatePrecipMobjState(thing, FRACUNIT, &interp);
-	}
+		z = R_InterpolateFixed(precip.oldz[i], z);
 
 	// transform the origin point
-	tr_x = interp.x - viewx;
-	tr_y = interp.y - viewy;
+	tr_x = precip.x[i] - viewx;
+	tr_y = precip.y[i] - viewy;
 
 	gxt = FixedMul(tr_x, viewcos);
 	gyt = -FixedMul(tr_y, viewsin);
@@ -1598,24 +1634,24 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 
 	// decide which patch to use for sprite relative to player
 #ifdef RANGECHECK
-	if ((unsigned)thing->sprite >= numsprites)
+	if ((unsigned)sprite >= numsprites)
 		I_Error("R_ProjectPrecipitationSprite: invalid sprite number %d ",
-			thing->sprite);
+			sprite);
 #endif
 
-	sprdef = &sprites[thing->sprite];
+	sprdef = &sprites[sprite];
 
 #ifdef RANGECHECK
-	if ((UINT8)(thing->frame&FF_FRAMEMASK) >= sprdef->numframes)
+	if ((UINT8)(frame&FF_FRAMEMASK) >= sprdef->numframes)
 		I_Error("R_ProjectPrecipitationSprite: invalid sprite frame %d : %d for %s",
-			thing->sprite, thing->frame, sprnames[thing->sprite]);
+			sprite, frame, sprnames[sprite]);
 #endif
 
-	sprframe = &sprdef->spriteframes[thing->frame & FF_FRAMEMASK];
+	sprframe = &sprdef->spriteframes[frame & FF_FRAMEMASK];
 
 #ifdef PARANOIA
 	if (!sprframe)
-		I_Error("R_ProjectPrecipitationSprite: sprframes NULL for sprite %d\n", thing->sprite);
+		I_Error("R_ProjectPrecipitationSprite: sprframes NULL for sprite %d\n", sprite);
 #endif
 
 	// use single rotation for all views
@@ -1626,14 +1662,14 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	x1 = (centerxfrac + FixedMul (tx,xscale)) >>FRACBITS;
 
 	// off the right side?
-	if (x1 > viewwidth)
+	if (x1 > viewclipx2)
 		return;
 
 	tx += spritecachedinfo[lump].width;
 	x2 = ((centerxfrac + FixedMul (tx,xscale)) >>FRACBITS) - 1;
 
 	// off the left side
-	if (x2 < 0)
+	if (x2 < viewclipx1)
 		return;
 
 	// PORTAL SPRITE CLIPPING
@@ -1642,28 +1678,17 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 		if (x2 < portalclipstart || x1 > portalclipend)
 			return;
 
-		if (P_PointOnLineSide(interp.x, interp.y, portalclipline) != 0)
+		if (P_PointOnLineSide(precip.x[i], precip.y[i], portalclipline) != 0)
 			return;
 	}
 
-	// okay, we can't return now except for vertical clipping... this is a hack, but weather isn't networked, so it should be ok
-	if (!(thing->precipflags & PCF_THUNK))
-	{
-		if (thing->precipflags & PCF_RAIN)
-			P_RainThinker(thing);
-		else
-			P_SnowThinker(thing);
-		thing->precipflags |= PCF_THUNK;
-	}
-
-
 	//SoM: 3/17/2000: Disregard sprites that are out of view..
-	gzt = interp.z + spritecachedinfo[lump].topoffset;
+	gzt = z + spritecachedinfo[lump].topoffset;
 	gz = gzt - spritecachedinfo[lump].height;
 
-	if (thing->subsector->sector->cullheight)
+	if (sector->cullheight)
 	{
-		if (R_DoCulling(thing->subsector->sector->cullheight, viewsector->cullheight, viewz, gz, gzt))
+		if (R_DoCulling(sector->cullheight, viewsector->cullheight, viewz, gz, gzt))
 			return;
 	}
 
@@ -1671,18 +1696,18 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	vis = R_NewVisSprite();
 	vis->scale = vis->sortscale = yscale; //<<detailshift;
 	vis->dispoffset = 0; // Monster Iestyn: 23/11/15
-	vis->gx = interp.x;
-	vis->gy = interp.y;
+	vis->gx = precip.x[i];
+	vis->gy = precip.y[i];
 	vis->gz = gz;
 	vis->gzt = gzt;
 	vis->thingheight = 4*FRACUNIT;
-	vis->pz = interp.z;
+	vis->pz = z;
 	vis->pzt = vis->pz + vis->thingheight;
 	vis->texturemid = vis->gzt - viewz;
 	vis->scalestep = 0;
 
-	vis->x1 = x1 < 0 ? 0 : x1;
-	vis->x2 = x2 >= viewwidth ? viewwidth-1 : x2;
+	vis->x1 = x1 < viewclipx1 ? viewclipx1 : x1;
+	vis->x2 = x2 > viewclipx2 ? viewclipx2 : x2;
 
 	// PORTAL SEMI-CLIPPING
 	if (portalrender)
@@ -1694,7 +1719,7 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	}
 
 	vis->xscale = xscale; //SoM: 4/17/2000
-	vis->sector = thing->subsector->sector;
+	vis->sector = sector;
 	vis->szt = (INT16)((centeryfrac - FixedMul(vis->gzt - viewz, yscale))>>FRACBITS);
 	vis->sz = (INT16)((centeryfrac - FixedMul(vis->gz - viewz, yscale))>>FRACBITS);
 
@@ -1703,7 +1728,7 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	vis->startfrac = 0;
 	vis->xiscale = iscale;
 
-	vis->thingscale = interp.scale;
+	vis->thingscale = FRACUNIT;
 
 	if (vis->x1 > x1)
 		vis->startfrac += vis->xiscale*(vis->x1-x1);
@@ -1713,15 +1738,15 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	vis->patch = sprframe->lumppat[0];
 
 	// specific translucency
-	if (thing->frame & FF_TRANSMASK)
-		vis->transmap = (thing->frame & FF_TRANSMASK) - 0x10000 + transtables;
+	if (frame & FF_TRANSMASK)
+		vis->transmap = (frame & FF_TRANSMASK) - 0x10000 + transtables;
 	else
 		vis->transmap = NULL;
 
 	vis->mobjflags = 0;
 	vis->cut = SC_NONE;
-	vis->extra_colormap = thing->subsector->sector->extra_colormap;
-	vis->heightsec = thing->subsector->sector->heightsec;
+	vis->extra_colormap = sector->extra_colormap;
+	vis->heightsec = sector->heightsec;
 
 	// Fullbright
 	vis->colormap = colormaps;
@@ -1730,13 +1755,46 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	vis->isScaled = false;
 }
 
+//
+// R_AddPrecipitationSprites
+// Adds this view's rain and snow, once the BSP has marked the sectors it saw.
+// The particles only move in P_RunPrecipitation, so this just reads them.
+//
+void R_AddPrecipitationSprites(void)
+{
+	// no, no infinite draw distance for precipitation. this option at zero is supposed to turn it off
+	const fixed_t limit_dist = (fixed_t)cv_drawdist_precip.value << FRACBITS;
+	size_t i, end;
+
+	if (rendermode != render_soft || !limit_dist || precip.hidden || viewssnum >= precip.numcameras)
+		return;
+
+	i = viewssnum * precip.percamera;
+	end = i + precip.percamera;
+	if (end > precip.count)
+		return;
+
+	for (; i < end; i++)
+	{
+		if (!precip.subsector[i])
+			continue;
+
+		if (sectorspritemarks[precip.subsector[i]->sector - sectors] != spritevalidcount)
+			continue;
+
+		if (P_AproxDistance(viewx - precip.x[i], viewy - precip.y[i]) > limit_dist)
+			continue;
+
+		R_ProjectPrecipitationSprite(i);
+	}
+}
+
 // R_AddSprites
 // During BSP traversal, this adds sprites by sector.
 //
 void R_AddSprites(sector_t *sec, INT32 lightlevel)
 {
 	mobj_t *thing;
-	precipmobj_t *precipthing; // Tails 08-25-2002
 	INT32 lightnum;
 	fixed_t approx_dist, limit_dist;
 
@@ -1750,11 +1808,11 @@ void R_AddSprites(sector_t *sec, INT32 lightlevel)
 	// A sector might have been split into several
 	//  subsectors during BSP building.
 	// Thus we check whether its already added.
-	if (sec->validcount == validcount)
+	if (sectorspritemarks[sec - sectors] == spritevalidcount)
 		return;
 
 	// Well, now it will be done.
-	sec->validcount = validcount;
+	sectorspritemarks[sec - sectors] = spritevalidcount;
 
 	if (!sec->numlights)
 	{
@@ -1855,92 +1913,156 @@ void R_AddSprites(sector_t *sec, INT32 lightlevel)
 			R_ProjectSprite(thing);
 		}
 	}
-
-	// no, no infinite draw distance for precipitation. this option at zero is supposed to turn it off
-	if ((limit_dist = (fixed_t)cv_drawdist_precip.value << FRACBITS))
-	{
-		for (precipthing = sec->preciplist; precipthing; precipthing = precipthing->snext)
-		{
-			if (precipthing->precipflags & PCF_INVISIBLE)
-				continue;
-
-			approx_dist = P_AproxDistance(viewx-precipthing->x, viewy-precipthing->y);
-
-			if (approx_dist > limit_dist)
-				continue;
-
-			R_ProjectPrecipitationSprite(precipthing);
-		}
-	}
 }
 
 //
 // R_SortVisSprites
 //
-static vissprite_t vsprsortedhead;
+// Sorts the vissprites by sortscale, and those of the same scale by
+// dispoffset, smallest first. Sprites that compare equal stay in the order
+// they were projected in.
+//
+static THREADLOCAL vissprite_t vsprsortedhead;
+
+// Sprite stats, see Command_Spritestats_f
+UINT32 rs_numvissprites;
+precise_t rs_sw_spritesorttime;
+static UINT32 spritestatframes, spritestatmaxsprites;
+static UINT64 spritestatsprites;
+static precise_t spritestattime, spritestatmaxtime;
+#ifdef THREADEDRENDER
+static I_mutex spritestat_mutex;
+#  define Lock_spritestats()   I_lock_mutex(&spritestat_mutex)
+#  define Unlock_spritestats() I_unlock_mutex(spritestat_mutex)
+#else
+#  define Lock_spritestats()
+#  define Unlock_spritestats()
+#endif
+
+// True if a must be drawn before b
+static inline boolean R_VisSpriteBefore(const vissprite_t *a, const vissprite_t *b)
+{
+	if (a->sortscale != b->sortscale)
+		return a->sortscale < b->sortscale;
+	return a->dispoffset < b->dispoffset;
+}
+
+#define SORTRUNLENGTH 8
 
 void R_SortVisSprites(void)
 {
-	UINT32       i;
-	vissprite_t *ds, *dsprev, *dsnext, *dsfirst;
-	vissprite_t *best = NULL;
-	vissprite_t  unsorted;
-	fixed_t      bestscale;
-	INT32        bestdispoffset;
+	precise_t sortstart = I_GetPreciseTime(), sorttime;
+	vissprite_t **src, **dst, **tmp;
+	vissprite_t *ds;
+	UINT32 i, j, width;
+
+	vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
 
 	if (!visspritecount)
+	{
+		Lock_spritestats();
+		rs_numvissprites = 0;
+		Unlock_spritestats();
 		return;
+	}
 
-	unsorted.next = unsorted.prev = &unsorted;
+	src = R_FrameAlloc(2 * visspritecount * sizeof (*src));
+	dst = src + visspritecount;
 
-	dsfirst = R_GetVisSprite(0);
+	for (i = 0; i < visspritecount; i++)
+		src[i] = R_GetVisSprite(i);
 
-	// The first's prev and last's next will be set to
-	// nonsense, but are fixed in a moment
-	for (i = 0, dsnext = dsfirst, ds = NULL; i < visspritecount; i++)
+	// Insertion sort short runs, then merge them bottom up.
+	// Both only move a sprite past ones it must be drawn before, so the sort is stable.
+	for (i = 0; i < visspritecount; i += SORTRUNLENGTH)
 	{
-		dsprev = ds;
-		ds = dsnext;
-		if (i < visspritecount - 1) dsnext = R_GetVisSprite(i + 1);
-
-		ds->next = dsnext;
-		ds->prev = dsprev;
+		UINT32 end = min(i + SORTRUNLENGTH, visspritecount);
+		for (j = i + 1; j < end; j++)
+		{
+			UINT32 k = j;
+			ds = src[j];
+			for (; k > i && R_VisSpriteBefore(ds, src[k-1]); k--)
+				src[k] = src[k-1];
+			src[k] = ds;
+		}
 	}
 
-	// Fix first and last. ds still points to the last one after the loop
-	dsfirst->prev = &unsorted;
-	unsorted.next = dsfirst;
-	if (ds)
-		ds->next = &unsorted;
-	unsorted.prev = ds;
-
-	// pull the vissprites out by scale
-	vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
-	for (i = 0; i < visspritecount; i++)
+	for (width = SORTRUNLENGTH; width < visspritecount; width *= 2)
 	{
-		bestscale = bestdispoffset = INT32_MAX;
-		for (ds = unsorted.next; ds != &unsorted; ds = ds->next)
+		for (i = 0; i < visspritecount; i += 2*width)
 		{
-			if (ds->sortscale < bestscale)
-			{
-				bestscale = ds->sortscale;
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-			// order visprites of same scale by dispoffset, smallest first
-			else if (ds->sortscale == bestscale && ds->dispoffset < bestdispoffset)
+			UINT32 mid = min(i + width, visspritecount);
+			UINT32 end = min(i + 2*width, visspritecount);
+			UINT32 l = i, r = mid;
+
+			for (j = i; j < end; j++)
 			{
-				bestdispoffset = ds->dispoffset;
-				best = ds;
+				// Only take from the right when it is strictly before the left
+				if (l < mid && (r >= end || !R_VisSpriteBefore(src[r], src[l])))
+					dst[j] = src[l++];
+				else
+					dst[j] = src[r++];
 			}
 		}
-		best->next->prev = best->prev;
-		best->prev->next = best->next;
-		best->next = &vsprsortedhead;
-		best->prev = vsprsortedhead.prev;
-		vsprsortedhead.prev->next = best;
-		vsprsortedhead.prev = best;
+		tmp = src;
+		src = dst;
+		dst = tmp;
 	}
+
+	// link them up in order
+	for (i = 0; i < visspritecount; i++)
+	{
+		ds = src[i];
+		ds->next = &vsprsortedhead;
+		ds->prev = vsprsortedhead.prev;
+		vsprsortedhead.prev->next = ds;
+		vsprsortedhead.prev = ds;
+	}
+
+	sorttime = I_GetPreciseTime() - sortstart;
+
+	Lock_spritestats();
+	rs_numvissprites = visspritecount;
+	rs_sw_spritesorttime = sorttime;
+
+	spritestatframes++;
+	spritestatsprites += visspritecount;
+	spritestattime += sorttime;
+	if (visspritecount > spritestatmaxsprites)
+		spritestatmaxsprites = visspritecount;
+	if (sorttime > spritestatmaxtime)
+		spritestatmaxtime = sorttime;
+	Unlock_spritestats();
+}
+
+#undef SORTRUNLENGTH
+
+// spritestats [reset]
+void Command_Spritestats_f(void)
+{
+	UINT64 precision = I_GetPrecisePrecision();
+
+	if (COM_Argc() > 1 && !stricmp(COM_Argv(1), "reset"))
+	{
+		spritestatframes = spritestatmaxsprites = 0;
+		spritestatsprites = 0;
+		spritestattime = spritestatmaxtime = 0;
+		return;
+	}
+
+	if (!spritestatframes)
+	{
+		CONS_Printf(M_GetText("No sprites have been sorted yet.\n"));
+		return;
+	}
+
+	CONS_Printf(M_GetText("Sorted vissprites for %u views\n"), spritestatframes);
+	CONS_Printf(M_GetText("Sprites per view: %u last, %u average, %u most\n"), rs_numvissprites,
+		(UINT32)(spritestatsprites / spritestatframes), spritestatmaxsprites);
+	CONS_Printf(M_GetText("Sort time: %u us last, %u us average, %u us most\n"),
+		(UINT32)(rs_sw_spritesorttime * 1000000 / precision),
+		(UINT32)(spritestattime * 1000000 / precision / spritestatframes),
+		(UINT32)(spritestatmaxtime * 1000000 / precision));
 }
 
 //
@@ -1948,8 +2070,7 @@ void R_SortVisSprites(void)
 // Creates and sorts a list of drawnodes for the scene being rendered.
 static drawnode_t *R_CreateDrawNode(drawnode_t *link);
 
-static drawnode_t nodebankhead;
-static drawnode_t nodehead;
+static THREADLOCAL drawnode_t nodehead;
 
 static void R_CreateDrawNodes(void)
 {
@@ -1962,6 +2083,7 @@ static void R_CreateDrawNodes(void)
 	visplane_t *plane;
 	INT32 sintersect;
 	fixed_t scale = 0;
+	precise_t pstime;
 
 	// Add the 3D floors, thicksides, and masked textures...
 	for (ds = ds_p; ds-- > drawsegs ;)
@@ -1976,8 +2098,8 @@ static void R_CreateDrawNodes(void)
 			}
 		}
 		// Check for a polyobject plane, but only if this is a front line
-		if (ds->curline->polyseg && ds->curline->polyseg->visplane && !ds->curline->side) {
-			plane = ds->curline->polyseg->visplane;
+		if (ds->curline->polyseg && po_visplanes[ds->curline->polyseg - PolyObjects] && !ds->curline->side) {
+			plane = po_visplanes[ds->curline->polyseg - PolyObjects];
 			R_PlaneBounds(plane);
 
 			if (plane->low < 0 || plane->high > vid.height || plane->high > plane->low)
@@ -1988,7 +2110,7 @@ static void R_CreateDrawNodes(void)
 				entry->plane = plane;
 				entry->seg = ds;
 			}
-			ds->curline->polyseg->visplane = NULL;
+			po_visplanes[ds->curline->polyseg - PolyObjects] = NULL;
 		}
 		if (ds->maskedtexturecol)
 		{
@@ -2039,26 +2161,28 @@ static void R_CreateDrawNodes(void)
 	// but it works getting them in for now
 	for (i = 0; i < numPolyObjects; i++)
 	{
-		if (!PolyObjects[i].visplane)
+		if (!po_visplanes[i])
 			continue;
-		plane = PolyObjects[i].visplane;
+		plane = po_visplanes[i];
 		R_PlaneBounds(plane);
 
 		if (plane->low < 0 || plane->high > vid.height || plane->high > plane->low)
 		{
-			PolyObjects[i].visplane = NULL;
+			po_visplanes[i] = NULL;
 			continue;
 		}
 		entry = R_CreateDrawNode(&nodehead);
 		entry->plane = plane;
 		// note: no seg is set, for what should be obvious reasons
-		PolyObjects[i].visplane = NULL;
+		po_visplanes[i] = NULL;
 	}
 
 	if (visspritecount == 0)
 		return;
 
+	pstime = M_PerfStart();
 	R_SortVisSprites();
+	M_PerfStopView(PS_SORT, &pstime);
 	for (rover = vsprsortedhead.prev; rover != &vsprsortedhead; rover = rover->prev)
 	{
 		if (rover->szt > vid.height || rover->sz < 0)
@@ -2223,16 +2347,7 @@ static void R_CreateDrawNodes(void)
 
 static drawnode_t *R_CreateDrawNode(drawnode_t *link)
 {
-	drawnode_t *node = nodebankhead.next;
-
-	if (node == &nodebankhead)
-	{
-		node = malloc(sizeof (*node));
-		if (!node)
-			I_Error("No more free memory to CreateDrawNode");
-	}
-	else
-		(nodebankhead.next = node->next)->prev = &nodebankhead;
+	drawnode_t *node = R_FrameAlloc(sizeof (*node));
 
 	if (link)
 	{
@@ -2250,31 +2365,19 @@ static drawnode_t *R_CreateDrawNode(drawnode_t *link)
 	return node;
 }
 
+// Nodes live in the frame arena, so finishing with one only unlinks it.
 static void R_DoneWithNode(drawnode_t *node)
 {
 	(node->next->prev = node->prev)->next = node->next;
-	(node->next = nodebankhead.next)->prev = node;
-	(node->prev = &nodebankhead)->next = node;
 }
 
 static void R_ClearDrawNodes(void)
 {
-	drawnode_t *rover;
-	drawnode_t *next;
-
-	for (rover = nodehead.next; rover != &nodehead ;)
-	{
-		next = rover->next;
-		R_DoneWithNode(rover);
-		rover = next;
-	}
-
 	nodehead.next = nodehead.prev = &nodehead;
 }
 
 void R_InitDrawNodes(void)
 {
-	nodebankhead.next = nodebankhead.prev = &nodebankhead;
 	nodehead.next = nodehead.prev = &nodehead;
 }
 
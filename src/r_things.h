@@ -24,6 +24,7 @@
 // number of sprite lumps for spritewidth,offset,topoffset lookup tables
 // Fab: this is a hack : should allocate the lookup tables per sprite
 #define MAXVISSPRITES 2048 // added 2-2-98 was 128
+// (only a limit for OpenGL now, software grows its vissprites in the frame arena)
 
 #define VISSPRITECHUNKBITS 6	// 2^6 = 64 sprites per chunk
 #define VISSPRITESPERCHUNK (1 << VISSPRITECHUNKBITS)
@@ -35,17 +36,22 @@ extern INT16 negonearray[MAXVIDWIDTH];
 extern INT16 screenheightarray[MAXVIDWIDTH];
 
 // vars for R_DrawMaskedColumn
-extern INT16 *mfloorclip;
-extern INT16 *mceilingclip;
-extern fixed_t spryscale;
-extern fixed_t sprtopscreen;
-extern fixed_t sprbotscreen;
-extern fixed_t windowtop;
-extern fixed_t windowbottom;
+extern THREADLOCAL INT16 *mfloorclip;
+extern THREADLOCAL INT16 *mceilingclip;
+extern THREADLOCAL fixed_t spryscale;
+extern THREADLOCAL fixed_t sprtopscreen;
+extern THREADLOCAL fixed_t sprbotscreen;
+extern THREADLOCAL fixed_t windowtop;
+extern THREADLOCAL fixed_t windowbottom;
 
 void R_DrawMaskedColumn(column_t *column);
 void R_SortVisSprites(void);
 
+// Stats for the last view drawn by the software renderer
+extern UINT32 rs_numvissprites;
+extern precise_t rs_sw_spritesorttime;
+void Command_Spritestats_f(void);
+
 //faB: find sprites in wadfile, replace existing, add new ones
 //     (only sprites from namelist are added or replaced)
 void R_AddSpriteDefs(UINT16 wadnum);
@@ -56,6 +62,7 @@ void R_DelSpriteDefs(UINT16 wadnum);
 
 //SoM: 6/5/2000: Light sprites correctly!
 void R_AddSprites(sector_t *sec, INT32 lightlevel);
+void R_AddPrecipitationSprites(void);
 void R_InitSprites(void);
 void R_ClearSprites(void);
 void R_DrawMasked(void);
@@ -162,7 +169,8 @@ typedef struct vissprite_s
 	fixed_t thingscale;
 } vissprite_t;
 
-extern UINT32 visspritecount;
+extern THREADLOCAL UINT32 visspritecount;
+extern THREADLOCAL size_t spritevalidcount; // R_AddSprites' validcount
 
 void R_ClipSprites(void);
 void R_ClipVisSprite(vissprite_t *spr, INT32 x1, INT32 x2);
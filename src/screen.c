@@ -40,16 +40,17 @@
 // --------------------------------------------
 // assembly or c drawer routines for 8bpp/16bpp
 // --------------------------------------------
-void (*wallcolfunc)(void); // new wall column drawer to draw posts >128 high
-void (*colfunc)(void); // standard column, up to 128 high posts
+THREADLOCAL void (*wallcolfunc)(void); // new wall column drawer to draw posts >128 high
+THREADLOCAL void (*colfunc)(void); // standard column, up to 128 high posts
 
 void (*basecolfunc)(void);
 void (*fuzzcolfunc)(void); // standard fuzzy effect column drawer
 void (*transcolfunc)(void); // translation column drawer
 void (*shadecolfunc)(void); // smokie test..
-void (*spanfunc)(void); // span drawer, use a 64x64 tile
+THREADLOCAL void (*spanfunc)(void); // span drawer, use a 64x64 tile
 void (*splatfunc)(void); // span drawer w/ transparency
 void (*basespanfunc)(void); // default span func for color mode
+void (*transspanfunc)(void); // translucent span drawer
 void (*transtransfunc)(void); // translucent translated column drawer
 void (*twosmultipatchfunc)(void); // for cols with transparent pixels
 void (*twosmultipatchtransfunc)(void); // for cols with transparent pixels AND translucency
@@ -102,6 +103,8 @@ boolean R_SSE = false;
 boolean R_3DNow = false;
 boolean R_MMXExt = false;
 boolean R_SSE2 = false;
+boolean R_AVX2 = false;
+boolean R_NEON = false;
 
 
 void SCR_SetMode(void)
@@ -122,6 +125,7 @@ void SCR_SetMode(void)
 	if (true)//vid.bpp == 1) //Always run in 8bpp. todo: remove all 16bpp code?
 	{
 		spanfunc = basespanfunc = R_DrawSpan_8;
+		transspanfunc = R_DrawTranslucentSpan_8;
 		splatfunc = R_DrawSplat_8;
 		transcolfunc = R_DrawTranslatedColumn_8;
 		transtransfunc = R_DrawTranslatedTranslucentColumn_8;
@@ -153,6 +157,36 @@ void SCR_SetMode(void)
 				twosmultipatchfunc = R_Draw2sMultiPatchColumn_8_ASM;
 			}
 		}
+#endif
+#ifdef SIMDDRAW_SSE2
+		if (R_SSE2)
+		{
+			colfunc = basecolfunc = R_DrawColumn_8_SSE2;
+			fuzzcolfunc = R_DrawTranslucentColumn_8_SSE2;
+			walldrawerfunc = R_DrawColumn_8_SSE2;
+			spanfunc = basespanfunc = R_DrawSpan_8_SSE2;
+			transspanfunc = R_DrawTranslucentSpan_8_SSE2;
+		}
+#endif
+#ifdef SIMDDRAW_AVX2
+		if (R_AVX2)
+		{
+			colfunc = basecolfunc = R_DrawColumn_8_AVX2;
+			fuzzcolfunc = R_DrawTranslucentColumn_8_AVX2;
+			walldrawerfunc = R_DrawColumn_8_AVX2;
+			spanfunc = basespanfunc = R_DrawSpan_8_AVX2;
+			transspanfunc = R_DrawTranslucentSpan_8_AVX2;
+		}
+#endif
+#ifdef SIMDDRAW_NEON
+		if (R_NEON)
+		{
+			colfunc = basecolfunc = R_DrawColumn_8_NEON;
+			fuzzcolfunc = R_DrawTranslucentColumn_8_NEON;
+			walldrawerfunc = R_DrawColumn_8_NEON;
+			spanfunc = basespanfunc = R_DrawSpan_8_NEON;
+			transspanfunc = R_DrawTranslucentSpan_8_NEON;
+		}
 #endif
 	}
 /*	else if (vid.bpp > 1)
@@ -199,7 +233,11 @@ void SCR_Startup(void)
 			R_SSE = true;
 		if (RCpuInfo->SSE2)
 			R_SSE2 = true;
-		CONS_Printf("CPU Info: 486: %i, 586: %i, MMX: %i, 3DNow: %i, MMXExt: %i, SSE2: %i\n", R_486, R_586, R_MMX, R_3DNow, R_MMXExt, R_SSE2);
+		if (RCpuInfo->AVX2)
+			R_AVX2 = true;
+		if (RCpuInfo->NEON)
+			R_NEON = true;
+		CONS_Printf("CPU Info: 486: %i, 586: %i, MMX: %i, 3DNow: %i, MMXExt: %i, SSE2: %i, AVX2: %i, NEON: %i\n", R_486, R_586, R_MMX, R_3DNow, R_MMXExt, R_SSE2, R_AVX2, R_NEON);
 	}
 
 	if (M_CheckParm("-noASM"))
@@ -222,6 +260,18 @@ void SCR_Startup(void)
 
 	if (M_CheckParm("-SSE2"))
 		R_SSE2 = true;
+	if (M_CheckParm("-noSSE2"))
+		R_SSE2 = false;
+
+	if (M_CheckParm("-AVX2"))
+		R_AVX2 = true;
+	if (M_CheckParm("-noAVX2"))
+		R_AVX2 = false;
+
+	if (M_CheckParm("-NEON"))
+		R_NEON = true;
+	if (M_CheckParm("-noNEON"))
+		R_NEON = false;
 
 	M_SetupMemcpy();
 
@@ -125,14 +125,15 @@ extern vmode_t specialmodes[NUMSPECIALMODES];
 // color mode dependent drawer function pointers
 // ---------------------------------------------
 
-extern void (*wallcolfunc)(void);
-extern void (*colfunc)(void);
+extern THREADLOCAL void (*wallcolfunc)(void);
+extern THREADLOCAL void (*colfunc)(void);
 extern void (*basecolfunc)(void);
 extern void (*fuzzcolfunc)(void);
 extern void (*transcolfunc)(void);
 extern void (*shadecolfunc)(void);
-extern void (*spanfunc)(void);
+extern THREADLOCAL void (*spanfunc)(void);
 extern void (*basespanfunc)(void);
+extern void (*transspanfunc)(void);
 extern void (*splatfunc)(void);
 extern void (*transtransfunc)(void);
 extern void (*twosmultipatchfunc)(void);
@@ -148,6 +149,8 @@ extern boolean R_MMX;
 extern boolean R_3DNow;
 extern boolean R_MMXExt;
 extern boolean R_SSE2;
+extern boolean R_AVX2;
+extern boolean R_NEON;
 
 // ----------------
 // screen variables
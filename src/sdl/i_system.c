@@ -3149,6 +3149,7 @@ void I_Quit(void)
 	quiting = SDL_FALSE;
 	I_ShutdownConsole();
 	M_SaveConfig(NULL); //save game config, cvars..
+	W_FlushMD5Cache();
 #ifndef NONET
 	D_SaveBan(); // save the ban list
 #endif
@@ -3973,6 +3974,12 @@ const CPUInfoFlags *I_CPUInfo(void)
 	}
 	WIN_CPUInfo.MMXExt      = SDL_FALSE; //SDL_HasMMXExt(); No longer in SDL2
 	WIN_CPUInfo.AMD3DNowExt = SDL_FALSE; //SDL_Has3DNowExt(); No longer in SDL2
+#if SDL_VERSION_ATLEAST(2,0,4)
+	WIN_CPUInfo.AVX2        = SDL_HasAVX2(); // also checks the OS saves the YMM registers
+#endif
+#if SDL_VERSION_ATLEAST(2,0,6)
+	WIN_CPUInfo.NEON        = SDL_HasNEON();
+#endif
 #endif
 	GetSystemInfo(&SI);
 	WIN_CPUInfo.CPUs = SI.dwNumberOfProcessors;
@@ -3990,6 +3997,12 @@ const CPUInfoFlags *I_CPUInfo(void)
 	SDL_CPUInfo.SSE         = SDL_HasSSE();
 	SDL_CPUInfo.SSE2        = SDL_HasSSE2();
 	SDL_CPUInfo.AltiVec     = SDL_HasAltiVec();
+#if SDL_VERSION_ATLEAST(2,0,4)
+	SDL_CPUInfo.AVX2        = SDL_HasAVX2();
+#endif
+#if SDL_VERSION_ATLEAST(2,0,6)
+	SDL_CPUInfo.NEON        = SDL_HasNEON();
+#endif
 	return &SDL_CPUInfo;
 #else
 	return NULL; /// \todo CPUID asm
@@ -47,8 +47,9 @@
 #endif
 
 #include "r_fps.h"
+#include "m_perfstats.h"
 
-UINT16 objectsdrawn = 0;
+THREADLOCAL UINT16 objectsdrawn = 0;
 
 //
 // STATUS BAR DATA
@@ -1785,7 +1786,7 @@ static void ST_doItemFinderIconsAndSound(void) // SRB2kart - unused.
 		return;
 
 	// Scan thinkers to find emblem mobj with these ids
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -1825,7 +1826,9 @@ static void ST_overlayDrawer(void)
 	//hu_showscores = auto hide score/time/rings when tab rankings are shown
 	if (!(hu_showscores && (netgame || multiplayer)))
 	{
+		precise_t pstime = M_PerfStart();
 		K_drawKartHUD();
+		M_PerfStop(PS_HUD, pstime);
 
 	/* SRB2kart doesn't need this stuff
 		if (maptol & TOL_NIGHTS)
@@ -1967,7 +1970,9 @@ static void ST_overlayDrawer(void)
 	{
 		if (renderisnewtic)
 		{
+			precise_t pstime = M_PerfStart();
 			LUAh_GameHUD(stplyr, luahuddrawlist_game);
+			M_PerfStop(PS_LUAHUD, pstime);
 		}
 	}
 #endif // HAVE_BLUA
@@ -2178,7 +2183,11 @@ void ST_Drawer(void)
 		}
 
 #ifdef HAVE_BLUA
-		LUA_HUD_DrawList(luahuddrawlist_game);
+		{
+			precise_t pstime = M_PerfStart();
+			LUA_HUD_DrawList(luahuddrawlist_game);
+			M_PerfStop(PS_LUAHUD, pstime);
+		}
 #endif // HAVE_BLUA
 
 		// draw Midnight Channel's overlay ontop
@@ -174,6 +174,7 @@ static void LoadPalette(const char *lumpname)
 	size_t i, palsize = W_LumpLength(lumpnum)/3;
 	UINT8 *pal;
 
+	R_FinishTranslationPrebuild(); // it reads the palette
 	Z_Free(pLocalPalette);
 
 	pLocalPalette = Z_Malloc(sizeof (*pLocalPalette)*palsize, PU_STATIC, NULL);
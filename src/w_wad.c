@@ -33,6 +33,27 @@
 #include <unistd.h>
 #endif
 
+#include <sys/stat.h>
+
+#if defined (UNIXCOMMON) && !defined (NOMMAP)
+#include <sys/mman.h>
+#define MAPWADS
+#endif
+
+// Mapped lumps are handed out wherever they sit in the file.
+#if defined (__i386__) || defined (__x86_64__) || defined (_M_IX86) || defined (_M_X64) || defined (__aarch64__)
+#define MAPUNALIGNED
+#endif
+
+#if defined (HAVE_THREADS) && defined (HAVE_ZLIB)
+#include "i_threads.h"
+#define PREFETCHLUMPS
+#endif
+
+#ifdef THREADEDRENDER
+#include "i_threads.h"
+#endif
+
 #define ZWAD
 
 #ifdef ZWAD
@@ -69,6 +90,8 @@
 #include "p_setup.h" // P_ScanThings
 #endif
 #include "m_misc.h" // M_MapNumber
+#include "m_argv.h" // M_CheckParm
+#include "command.h" // COM_Argv
 
 #ifdef HWRENDER
 #include "r_data.h"
@@ -93,17 +116,62 @@ typedef struct
 	size_t len;
 } lumpchecklist_t;
 
-// Must be a power of two
-#define LUMPNUMCACHESIZE 64
+// Terminates the per-wad name index chains; no wad can have this many lumps.
+#define NOLUMP UINT16_MAX
 
-typedef struct lumpnum_cache_s
+// Global name -> lumpnum directory, one for 8-char names and one for long
+// names. Open addressing; the name itself is read back from the lumpinfo.
+typedef struct
 {
-	char lumpname[32];
+	UINT32 hash;
 	lumpnum_t lumpnum;
-} lumpnum_cache_t;
+} lumpdirslot_t;
+
+#define LUMPDIR_EMPTY LUMPERROR
+#define LUMPDIR_DELETED (LUMPERROR - 1)
+
+typedef struct
+{
+	lumpdirslot_t *slots;
+	UINT32 size; // power of two
+	UINT32 used; // live slots and tombstones
+	boolean longnames;
+} lumpdir_t;
+
+static lumpdir_t lumpdir = {NULL, 0, 0, false};
+static lumpdir_t longlumpdir = {NULL, 0, 0, true};
+
+typedef enum
+{
+	LOOKUP_NAME,
+	LOOKUP_LONGNAME,
+	LOOKUP_NAMEPWAD,
+	LOOKUP_LONGNAMEPWAD,
+	LOOKUP_FULLNAMEPK3,
+	NUMLOOKUPS
+} lumplookup_t;
+
+static const char *lumplookupnames[NUMLOOKUPS] = {
+	"W_CheckNumForName",
+	"W_CheckNumForLongName",
+	"W_CheckNumForNamePwad",
+	"W_CheckNumForLongNamePwad",
+	"W_CheckNumForFullNamePK3",
+};
+
+static struct
+{
+	UINT32 calls;
+	UINT32 misses;
+	precise_t time;
+} lumplookupstats[NUMLOOKUPS];
 
-static lumpnum_cache_t lumpnumcache[LUMPNUMCACHESIZE];
-static UINT16 lumpnumcacheindex = 0;
+static void LumpDirFree(lumpdir_t *dir)
+{
+	Z_Free(dir->slots);
+	dir->slots = NULL;
+	dir->size = dir->used = 0;
+}
 
 //===========================================================================
 //                                                                    GLOBALS
@@ -111,6 +179,75 @@ static UINT16 lumpnumcacheindex = 0;
 UINT16 numwadfiles = 0; // number of active wadfiles
 wadfile_t *wadfiles[MAX_WADFILES]; // 0 to numwadfiles-1 are valid
 
+#ifdef MAPWADS
+// Mappings of unloaded files, see W_UnmapFile.
+static struct
+{
+	void *base;
+	size_t size;
+} *retiredmaps;
+static size_t numretiredmaps;
+#endif
+
+// Maps the whole file so lumps can be read without seeking, and uncompressed
+// ones handed out without a copy. The mapping is read-only: cached lumps are
+// shared with the file, so anything that wants to change one has to work on
+// its own copy (W_CacheLumpNumForce or W_ReadLump).
+static void W_MapFile(wadfile_t *wadfile)
+{
+	wadfile->mapped = NULL;
+#ifdef MAPWADS
+	if (!wadfile->filesize || M_CheckParm("-nommap"))
+		return;
+
+	wadfile->mapped = mmap(NULL, wadfile->filesize, PROT_READ, MAP_PRIVATE, fileno(wadfile->handle), 0);
+	if (wadfile->mapped == MAP_FAILED)
+	{
+		CONS_Debug(DBG_SETUP, "Could not map %s, reading it instead\n", wadfile->filename);
+		wadfile->mapped = NULL;
+		return;
+	}
+
+	Z_AddExternalRange(wadfile->mapped, wadfile->filesize);
+#endif
+}
+
+// Textures, HUD graphics, music and the like can hold on to lumps of a file
+// past its unloading, and there is no telling when they have all let go.
+// So an unloaded file keeps its mapping, still known to the zone so stray
+// Z_Free and Z_ChangeTag calls on its lumps do nothing, until W_Shutdown.
+static void W_UnmapFile(wadfile_t *wadfile)
+{
+#ifdef MAPWADS
+	if (!wadfile->mapped)
+		return;
+
+	retiredmaps = realloc(retiredmaps, (numretiredmaps + 1) * sizeof *retiredmaps);
+	if (!retiredmaps)
+		I_Error("W_UnmapFile: out of memory");
+	retiredmaps[numretiredmaps].base = wadfile->mapped;
+	retiredmaps[numretiredmaps].size = wadfile->filesize;
+	numretiredmaps++;
+	wadfile->mapped = NULL;
+#else
+	(void)wadfile;
+#endif
+}
+
+static void W_ReleaseMappings(void)
+{
+#ifdef MAPWADS
+	while (numretiredmaps--)
+	{
+		Z_RemoveExternalRange(retiredmaps[numretiredmaps].base);
+		munmap(retiredmaps[numretiredmaps].base, retiredmaps[numretiredmaps].size);
+	}
+	free(retiredmaps);
+	retiredmaps = NULL;
+	numretiredmaps = 0;
+#endif
+}
+
 // W_Shutdown
 // Closes all of the WAD files before quitting
 // If not done on a Mac then open wad files
@@ -122,6 +259,7 @@ void W_Shutdown(void)
 	{
 		wadfile_t *wad = wadfiles[numwadfiles];
 
+		W_UnmapFile(wad);
 		if (wad->handle)
 			fclose(wad->handle);
 		Z_Free(wad->filename);
@@ -130,8 +268,13 @@ void W_Shutdown(void)
 			Z_Free(wad->lumpinfo[wad->numlumps].fullname);
 		}
 		Z_Free(wad->lumpinfo);
+		Z_Free(wad->namehash);
 		Z_Free(wad);
 	}
+
+	W_ReleaseMappings();
+	LumpDirFree(&lumpdir);
+	LumpDirFree(&longlumpdir);
 }
 
 //===========================================================================
@@ -317,10 +460,523 @@ static inline INT32 W_MakeFileMD5(const char *filename, void *resblock)
 	return 1;
 }
 
-// Invalidates the cache of lump numbers. Call this whenever a wad is added.
-static void W_InvalidateLumpnumCache(void)
+// ==========================================================================
+//                                                            FILE MD5 CACHE
+// ==========================================================================
+
+// Hashing every addon each time it's loaded or a server asks for it adds up
+// quickly, so the sums are kept in a text file in srb2home, keyed by path,
+// size and modification time. Each line reads "md5 size mtime path".
+#define MD5CACHEFILE "md5cache.txt"
+
+typedef struct
+{
+	char *path;
+	UINT32 size, mtime;
+	UINT8 md5sum[16];
+} md5cacheentry_t;
+
+static md5cacheentry_t *md5cache;
+static size_t md5cachesize, md5cachemax;
+static boolean md5cacheloaded, md5cachedirty;
+static UINT32 md5cachehits, md5cachemisses;
+
+static boolean W_StatFile(const char *filename, UINT32 *size, UINT32 *mtime)
+{
+	struct stat st;
+
+	if (stat(filename, &st) < 0)
+		return false;
+
+	*size = (UINT32)st.st_size;
+	*mtime = (UINT32)st.st_mtime;
+	return true;
+}
+
+static md5cacheentry_t *W_FindMD5CacheEntry(const char *filename)
+{
+	size_t i;
+
+	for (i = 0; i < md5cachesize; i++)
+		if (!strcmp(md5cache[i].path, filename))
+			return &md5cache[i];
+
+	return NULL;
+}
+
+static md5cacheentry_t *W_AddMD5CacheEntry(const char *filename)
+{
+	md5cacheentry_t *entry;
+
+	if (md5cachesize >= md5cachemax)
+	{
+		md5cachemax = md5cachemax ? md5cachemax * 2 : 64;
+		md5cache = Z_Realloc(md5cache, md5cachemax * sizeof *md5cache, PU_STATIC, NULL);
+	}
+
+	entry = &md5cache[md5cachesize++];
+	entry->path = Z_StrDup(filename);
+	return entry;
+}
+
+static void W_ClearMD5Cache(void)
+{
+	while (md5cachesize)
+		Z_Free(md5cache[--md5cachesize].path);
+}
+
+static INT32 W_HexDigit(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+static void W_LoadMD5Cache(void)
+{
+	FILE *f;
+	char line[MAX_WADPATH + 64];
+
+	md5cacheloaded = true;
+
+	f = fopen(va(pandf, srb2home, MD5CACHEFILE), "r");
+	if (!f)
+		return;
+
+	while (fgets(line, sizeof line, f))
+	{
+		char md5text[33];
+		unsigned long size, mtime;
+		int pathstart = 0;
+		md5cacheentry_t *entry;
+		INT32 i, hi, lo;
+
+		line[strcspn(line, "\r\n")] = '\0';
+		if (sscanf(line, "%32s %lu %lu %n", md5text, &size, &mtime, &pathstart) < 3
+			|| !pathstart || !line[pathstart] || strlen(md5text) != 32)
+			continue;
+
+		entry = W_FindMD5CacheEntry(&line[pathstart]);
+		if (!entry)
+			entry = W_AddMD5CacheEntry(&line[pathstart]);
+		entry->size = (UINT32)size;
+		entry->mtime = (UINT32)mtime;
+		for (i = 0; i < 16; i++)
+		{
+			hi = W_HexDigit(md5text[i*2]);
+			lo = W_HexDigit(md5text[i*2 + 1]);
+			if (hi < 0 || lo < 0)
+			{
+				entry->size = entry->mtime = 0; // never matches, gets rehashed
+				break;
+			}
+			entry->md5sum[i] = (UINT8)((hi << 4) | lo);
+		}
+	}
+
+	fclose(f);
+	CONS_Debug(DBG_SETUP, "Read %s file MD5s from %s\n", sizeu1(md5cachesize), MD5CACHEFILE);
+}
+
+static void W_SaveMD5Cache(void)
+{
+	FILE *f;
+	size_t i;
+	INT32 j;
+
+	f = fopen(va(pandf, srb2home, MD5CACHEFILE), "w");
+	if (!f)
+	{
+		CONS_Debug(DBG_SETUP, "Could not write %s\n", MD5CACHEFILE);
+		return;
+	}
+
+	for (i = 0; i < md5cachesize; i++)
+	{
+		for (j = 0; j < 16; j++)
+			fprintf(f, "%02x", md5cache[i].md5sum[j]);
+		fprintf(f, " %lu %lu %s\n", (unsigned long)md5cache[i].size,
+			(unsigned long)md5cache[i].mtime, md5cache[i].path);
+	}
+
+	fclose(f);
+	md5cachedirty = false;
+}
+
+/** Writes out the MD5 cache if anything was hashed since it was last saved.
+  * Called once a batch of files has been loaded or checked, rather than
+  * after every file.
+  */
+void W_FlushMD5Cache(void)
+{
+	if (md5cachedirty)
+		W_SaveMD5Cache();
+}
+
+/** Gets the MD5 of a file, from the cache if the file hasn't changed since
+  * it was last hashed, otherwise by hashing it and remembering the result.
+  *
+  * \param filename path of file
+  * \param resblock resulting MD5 checksum
+  * \return 0 if the MD5 checksum is at resblock, 1 if the file couldn't be read
+  * \sa W_MakeFileMD5
+  */
+INT32 W_GetFileMD5(const char *filename, void *resblock)
+{
+#ifdef NOMD5
+	return W_MakeFileMD5(filename, resblock);
+#else
+	md5cacheentry_t *entry;
+	UINT32 size, mtime;
+
+	if (!W_StatFile(filename, &size, &mtime))
+		return W_MakeFileMD5(filename, resblock);
+
+	if (!md5cacheloaded)
+		W_LoadMD5Cache();
+
+	entry = W_FindMD5CacheEntry(filename);
+	if (entry && entry->size == size && entry->mtime == mtime)
+	{
+		md5cachehits++;
+		M_Memcpy(resblock, entry->md5sum, 16);
+		return 0;
+	}
+
+	md5cachemisses++;
+	if (W_MakeFileMD5(filename, resblock))
+		return 1;
+
+	if (!entry)
+		entry = W_AddMD5CacheEntry(filename);
+	entry->size = size;
+	entry->mtime = mtime;
+	M_Memcpy(entry->md5sum, resblock, 16);
+	md5cachedirty = true; // see W_FlushMD5Cache
+	return 0;
+#endif
+}
+
+// md5cache [verify|rebuild]
+// verify rehashes every cached file that's still around and fixes up
+// whatever doesn't match; rebuild starts over from the loaded files.
+void Command_Md5cache_f(void)
+{
+#ifdef NOMD5
+	CONS_Printf(M_GetText("MD5 checksums are disabled in this build.\n"));
+#else
+	const char *arg = COM_Argc() > 1 ? COM_Argv(1) : "";
+	UINT8 md5sum[16];
+	size_t i;
+
+	if (!md5cacheloaded)
+		W_LoadMD5Cache();
+
+	if (!stricmp(arg, "verify"))
+	{
+		UINT32 size, mtime, bad = 0, gone = 0;
+
+		for (i = 0; i < md5cachesize;)
+		{
+			md5cacheentry_t *entry = &md5cache[i];
+
+			if (!W_StatFile(entry->path, &size, &mtime) || W_MakeFileMD5(entry->path, md5sum))
+			{
+				// drop it, keeping the order
+				Z_Free(entry->path);
+				memmove(entry, entry + 1, (md5cachesize - i - 1) * sizeof *entry);
+				md5cachesize--;
+				gone++;
+				continue;
+			}
+
+			if (entry->size != size || entry->mtime != mtime || memcmp(entry->md5sum, md5sum, 16))
+			{
+				if (entry->size == size && entry->mtime == mtime)
+				{
+					CONS_Alert(CONS_WARNING, M_GetText("%s changed without its size or date changing\n"), entry->path);
+					bad++;
+				}
+				entry->size = size;
+				entry->mtime = mtime;
+				M_Memcpy(entry->md5sum, md5sum, 16);
+			}
+			i++;
+		}
+
+		W_SaveMD5Cache();
+		CONS_Printf(M_GetText("Verified %s cached MD5s: %u wrong, %u files gone\n"), sizeu1(md5cachesize), bad, gone);
+	}
+	else if (!stricmp(arg, "rebuild"))
+	{
+		W_ClearMD5Cache();
+		for (i = 0; i < numwadfiles; i++)
+			W_GetFileMD5(wadfiles[i]->filename, md5sum);
+		W_SaveMD5Cache();
+		CONS_Printf(M_GetText("Rebuilt MD5 cache with %s files\n"), sizeu1(md5cachesize));
+	}
+	else
+	{
+		CONS_Printf(M_GetText("md5cache [verify|rebuild]: check or redo the cached addon MD5s\n"));
+		CONS_Printf(M_GetText("%s files cached, %u hits, %u misses\n"), sizeu1(md5cachesize), md5cachehits, md5cachemisses);
+	}
+#endif
+}
+
+// FNV-1a over at most maxlen characters of a lump name.
+static UINT32 W_HashLumpName(const char *name, size_t maxlen)
+{
+	UINT32 hash = 2166136261u;
+
+	while (maxlen-- && *name)
+	{
+		hash ^= (UINT8)*name++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static const char *LumpDirName(const lumpdir_t *dir, lumpnum_t lumpnum)
+{
+	lumpinfo_t *lump_p = &wadfiles[WADFILENUM(lumpnum)]->lumpinfo[LUMPNUM(lumpnum)];
+	return dir->longnames ? lump_p->longname : lump_p->name;
+}
+
+// Finds the slot holding name, or NULL.
+static lumpdirslot_t *LumpDirFind(const lumpdir_t *dir, const char *name, UINT32 hash)
+{
+	UINT32 i;
+	lumpdirslot_t *slot;
+
+	if (!dir->size)
+		return NULL;
+
+	for (i = hash & (dir->size - 1);; i = (i + 1) & (dir->size - 1))
+	{
+		slot = &dir->slots[i];
+
+		if (slot->lumpnum == LUMPDIR_EMPTY)
+			return NULL;
+
+		if (slot->lumpnum == LUMPDIR_DELETED || slot->hash != hash)
+			continue;
+
+		if (dir->longnames ? !strcmp(LumpDirName(dir, slot->lumpnum), name)
+			: !strncmp(LumpDirName(dir, slot->lumpnum), name, 8))
+			return slot;
+	}
+}
+
+static void LumpDirGrow(lumpdir_t *dir)
+{
+	lumpdirslot_t *oldslots = dir->slots;
+	UINT32 oldsize = dir->size;
+	UINT32 i, j;
+
+	dir->size = oldsize ? oldsize*2 : 1024;
+	dir->slots = Z_Malloc(dir->size * sizeof *dir->slots, PU_STATIC, NULL);
+	for (i = 0; i < dir->size; i++)
+		dir->slots[i].lumpnum = LUMPDIR_EMPTY;
+	dir->used = 0;
+
+	// tombstones get dropped here
+	for (i = 0; i < oldsize; i++)
+	{
+		if (oldslots[i].lumpnum == LUMPDIR_EMPTY || oldslots[i].lumpnum == LUMPDIR_DELETED)
+			continue;
+
+		for (j = oldslots[i].hash & (dir->size - 1); dir->slots[j].lumpnum != LUMPDIR_EMPTY; j = (j + 1) & (dir->size - 1))
+			;
+		dir->slots[j] = oldslots[i];
+		dir->used++;
+	}
+
+	Z_Free(oldslots);
+}
+
+// Points name at lumpnum, replacing whatever it pointed at before.
+static void LumpDirSet(lumpdir_t *dir, const char *name, lumpnum_t lumpnum)
+{
+	UINT32 hash = W_HashLumpName(name, dir->longnames ? SIZE_MAX : 8);
+	lumpdirslot_t *slot = LumpDirFind(dir, name, hash);
+	UINT32 i;
+
+	if (slot)
+	{
+		slot->lumpnum = lumpnum;
+		return;
+	}
+
+	if ((dir->used + 1)*2 > dir->size)
+		LumpDirGrow(dir);
+
+	for (i = hash & (dir->size - 1); dir->slots[i].lumpnum != LUMPDIR_EMPTY; i = (i + 1) & (dir->size - 1))
+		;
+	dir->slots[i].hash = hash;
+	dir->slots[i].lumpnum = lumpnum;
+	dir->used++;
+}
+
+static int W_CompareFullNames(const void *a, const void *b);
+static lumpinfo_t *sortlumpinfo;
+
+// Builds the per-wad name index: hash chains for 8-char and long names,
+// kept in ascending lump order so the first hit is the first lump, and
+// the full names sorted so prefix lookups are a binary search.
+static void W_IndexLumps(wadfile_t *wadfile)
+{
+	UINT32 hashsize = 16;
+	UINT16 *mem;
+	INT32 i;
+
+	while (hashsize < wadfile->numlumps)
+		hashsize <<= 1;
+	wadfile->hashmask = hashsize - 1;
+
+	mem = Z_Malloc((hashsize*2 + wadfile->numlumps*3) * sizeof *mem, PU_STATIC, NULL);
+	wadfile->namehash = mem;
+	wadfile->longhash = mem + hashsize;
+	wadfile->namenext = mem + hashsize*2;
+	wadfile->longnext = wadfile->namenext + wadfile->numlumps;
+	wadfile->fullnames = wadfile->longnext + wadfile->numlumps;
+
+	for (i = 0; i < (INT32)hashsize; i++)
+		wadfile->namehash[i] = wadfile->longhash[i] = NOLUMP;
+
+	for (i = wadfile->numlumps - 1; i >= 0; i--)
+	{
+		lumpinfo_t *lump_p = &wadfile->lumpinfo[i];
+		UINT32 h;
+
+		h = W_HashLumpName(lump_p->name, 8) & wadfile->hashmask;
+		wadfile->namenext[i] = wadfile->namehash[h];
+		wadfile->namehash[h] = (UINT16)i;
+
+		h = W_HashLumpName(lump_p->longname, SIZE_MAX) & wadfile->hashmask;
+		wadfile->longnext[i] = wadfile->longhash[h];
+		wadfile->longhash[h] = (UINT16)i;
+
+		wadfile->fullnames[i] = (UINT16)i;
+	}
+
+	sortlumpinfo = wadfile->lumpinfo;
+	qsort(wadfile->fullnames, wadfile->numlumps, sizeof *wadfile->fullnames, W_CompareFullNames);
+}
+
+static int W_CompareFullNames(const void *a, const void *b)
+{
+	UINT16 la = *(const UINT16 *)a, lb = *(const UINT16 *)b;
+	int c = stricmp(sortlumpinfo[la].fullname, sortlumpinfo[lb].fullname);
+	if (c)
+		return c;
+	return la - lb;
+}
+
+// Exact-match search of one wad's index, no case folding.
+static UINT16 W_FindLumpPwad(const wadfile_t *wadfile, const char *name, boolean longname, UINT16 startlump)
+{
+	UINT16 i;
+
+	if (longname)
+	{
+		for (i = wadfile->longhash[W_HashLumpName(name, SIZE_MAX) & wadfile->hashmask]; i != NOLUMP; i = wadfile->longnext[i])
+			if (i >= startlump && !strcmp(wadfile->lumpinfo[i].longname, name))
+				return i;
+	}
+	else
+	{
+		for (i = wadfile->namehash[W_HashLumpName(name, 8) & wadfile->hashmask]; i != NOLUMP; i = wadfile->namenext[i])
+			if (i >= startlump && !strncmp(wadfile->lumpinfo[i].name, name, 8))
+				return i;
+	}
+
+	return INT16_MAX;
+}
+
+// Enters a newly added wad into the global directories. Going backwards
+// means the first lump of a name in this wad is the one that sticks, and
+// since this wad is the newest it wins over all the older ones.
+static void W_AddToLumpDirectory(UINT16 wadnum)
+{
+	wadfile_t *wadfile = wadfiles[wadnum];
+	INT32 i;
+
+	for (i = wadfile->numlumps - 1; i >= 0; i--)
+	{
+		lumpinfo_t *lump_p = &wadfile->lumpinfo[i];
+
+		if (lump_p->name[0])
+			LumpDirSet(&lumpdir, lump_p->name, (wadnum<<16) + i);
+		if (lump_p->longname[0])
+			LumpDirSet(&longlumpdir, lump_p->longname, (wadnum<<16) + i);
+	}
+}
+
+#ifdef DELFILE
+// Repoints every name owned by a wad that is going away at the next wad
+// down that has it. wadfiles[wadnum] must already be gone.
+static void W_RemoveFromLumpDirectory(wadfile_t *wadfile, UINT16 wadnum)
+{
+	lumpdir_t *dirs[2] = {&lumpdir, &longlumpdir};
+	INT32 i, d, w;
+
+	for (d = 0; d < 2; d++)
+	{
+		lumpdir_t *dir = dirs[d];
+
+		for (i = 0; i < (INT32)dir->size; i++)
+		{
+			lumpdirslot_t *slot = &dir->slots[i];
+			const char *name;
+			UINT16 check = INT16_MAX;
+
+			if (slot->lumpnum == LUMPDIR_EMPTY || slot->lumpnum == LUMPDIR_DELETED
+				|| WADFILENUM(slot->lumpnum) != wadnum)
+				continue;
+
+			name = dir->longnames ? wadfile->lumpinfo[LUMPNUM(slot->lumpnum)].longname
+				: wadfile->lumpinfo[LUMPNUM(slot->lumpnum)].name;
+
+			for (w = numwadfiles - 1; w >= 0; w--)
+			{
+				if (!wadfiles[w])
+					continue;
+				check = W_FindLumpPwad(wadfiles[w], name, dir->longnames, 0);
+				if (check != INT16_MAX)
+					break;
+			}
+
+			slot->lumpnum = (check != INT16_MAX) ? (lumpnum_t)((w<<16) + check) : LUMPDIR_DELETED;
+		}
+	}
+}
+#endif
+
+// Prints how often the lump lookups were called and how long they took.
+void Command_Lumpstats_f(void)
 {
-	memset(lumpnumcache, 0, sizeof (lumpnumcache));
+	UINT64 precision = I_GetPrecisePrecision();
+	INT32 i;
+
+	if (COM_Argc() > 1 && !stricmp(COM_Argv(1), "reset"))
+	{
+		memset(lumplookupstats, 0, sizeof lumplookupstats);
+		return;
+	}
+
+	CONS_Printf("\x82%s", M_GetText("Lump lookups\n"));
+	for (i = 0; i < NUMLOOKUPS; i++)
+	{
+		CONS_Printf("%-26s: %8u calls, %7u misses, %6u us\n", lumplookupnames[i],
+			lumplookupstats[i].calls, lumplookupstats[i].misses,
+			(UINT32)(lumplookupstats[i].time * 1000000 / precision));
+	}
+	CONS_Printf(M_GetText("Directory: %u names, %u long names\n"), lumpdir.used, longlumpdir.used);
 }
 
 /** Detect a file type.
@@ -737,7 +1393,7 @@ UINT16 W_InitFile(const char *filename)
 	// Let's not add a wad file if the MD5 matches
 	// an MD5 of an already added WAD file!
 	//
-	W_MakeFileMD5(filename, md5sum);
+	W_GetFileMD5(filename, md5sum);
 
 	for (i = 0; i < numwadfiles; i++)
 	{
@@ -786,9 +1442,11 @@ UINT16 W_InitFile(const char *filename)
 	wadfile->numlumps = (UINT16)numlumps;
 	wadfile->lumpinfo = lumpinfo;
 	wadfile->important = important;
+	W_IndexLumps(wadfile);
 	fseek(handle, 0, SEEK_END);
 	wadfile->filesize = (unsigned)ftell(handle);
 	wadfile->type = type;
+	W_MapFile(wadfile);
 
 	// already generated, just copy it over
 	M_Memcpy(&wadfile->md5sum, &md5sum, 16);
@@ -809,6 +1467,7 @@ UINT16 W_InitFile(const char *filename)
 	CONS_Printf(M_GetText("Added file %s (%u lumps)\n"), filename, numlumps);
 	wadfiles[numwadfiles] = wadfile;
 	numwadfiles++; // must come BEFORE W_LoadDehackedLumps, so any addfile called by COM_BufInsertText called by Lua doesn't overwrite what we just loaded
+	W_AddToLumpDirectory(numwadfiles - 1);
 
 		// Read shaders from file
 		W_ReadFileShaders(wadfile);
@@ -839,7 +1498,6 @@ UINT16 W_InitFile(const char *filename)
 		G_LoadGameData();
 	DEH_UpdateMaxFreeslots();
 
-	W_InvalidateLumpnumCache();
 	return wadfile->numlumps;
 }
 
@@ -853,10 +1511,13 @@ void W_UnloadWadFile(UINT16 num)
 		return;
 	CONS_Printf(M_GetText("Removing WAD %s...\n"), wadfiles[num]->filename);
 
+	W_FinishPrefetch();
 	DEH_UnloadDehackedWad(num);
 	wadfiles[num] = NULL;
 	lumpcache = delwad->lumpcache;
 	numwadfiles--;
+	W_RemoveFromLumpDirectory(delwad, num);
+	Z_Free(delwad->namehash);
 #ifdef HWRENDER
 	if (rendermode != render_soft && rendermode != render_none)
 		HWR_FreeTextureCache();
@@ -868,6 +1529,7 @@ void W_UnloadWadFile(UINT16 num)
 			Z_ChangeTag(lumpcache[i], PU_PURGELEVEL);
 	}
 	Z_Free(lumpcache);
+	W_UnmapFile(delwad);
 	fclose(delwad->handle);
 	Z_Free(delwad->filename);
 	Z_Free(delwad);
@@ -907,6 +1569,7 @@ INT32 W_InitMultipleFiles(char **filenames, boolean addons)
 	if (!numwadfiles)
 		I_Error("W_InitMultipleFiles: no files found");
 
+	W_FlushMD5Cache();
 	return overallrc;
 }
 
@@ -949,8 +1612,9 @@ const char *W_CheckNameForNum(lumpnum_t lumpnum)
 //
 UINT16 W_CheckNumForNamePwad(const char *name, UINT16 wad, UINT16 startlump)
 {
-	UINT16 i;
+	UINT16 i = INT16_MAX;
 	static char uname[9];
+	precise_t t = I_GetPreciseTime();
 
 	if (!TestValidLump(wad,0))
 		return INT16_MAX;
@@ -960,20 +1624,19 @@ UINT16 W_CheckNumForNamePwad(const char *name, UINT16 wad, UINT16 startlump)
 	strupr(uname);
 
 	//
-	// scan forward
+	// look up the index
 	// start at 'startlump', useful parameter when there are multiple
 	//                       resources with the same name
 	//
 	if (startlump < wadfiles[wad]->numlumps)
-	{
-		lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
-		for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
-			if (memcmp(lump_p->name, uname, sizeof(uname) - 1) == 0)
-				return i;
-	}
+		i = W_FindLumpPwad(wadfiles[wad], uname, false, startlump);
 
-	// not found.
-	return INT16_MAX;
+	lumplookupstats[LOOKUP_NAMEPWAD].calls++;
+	if (i == INT16_MAX)
+		lumplookupstats[LOOKUP_NAMEPWAD].misses++;
+	lumplookupstats[LOOKUP_NAMEPWAD].time += I_GetPreciseTime() - t;
+
+	return i;
 }
 
 //
@@ -984,8 +1647,9 @@ UINT16 W_CheckNumForNamePwad(const char *name, UINT16 wad, UINT16 startlump)
 //
 UINT16 W_CheckNumForLongNamePwad(const char *name, UINT16 wad, UINT16 startlump)
 {
-	UINT16 i;
+	UINT16 i = INT16_MAX;
 	static char uname[256 + 1];
+	precise_t t = I_GetPreciseTime();
 
 	if (!TestValidLump(wad,0))
 		return INT16_MAX;
@@ -994,20 +1658,19 @@ UINT16 W_CheckNumForLongNamePwad(const char *name, UINT16 wad, UINT16 startlump)
 	strupr(uname);
 
 	//
-	// scan forward
+	// look up the index
 	// start at 'startlump', useful parameter when there are multiple
 	//                       resources with the same name
 	//
 	if (startlump < wadfiles[wad]->numlumps)
-	{
-		lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
-		for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
-			if (!strcmp(lump_p->longname, uname))
-				return i;
-	}
+		i = W_FindLumpPwad(wadfiles[wad], uname, true, startlump);
 
-	// not found.
-	return INT16_MAX;
+	lumplookupstats[LOOKUP_LONGNAMEPWAD].calls++;
+	if (i == INT16_MAX)
+		lumplookupstats[LOOKUP_LONGNAMEPWAD].misses++;
+	lumplookupstats[LOOKUP_LONGNAMEPWAD].time += I_GetPreciseTime() - t;
+
+	return i;
 }
 
 UINT16
@@ -1060,18 +1723,39 @@ UINT16 W_CheckNumForFolderEndPK3(const char *name, UINT16 wad, UINT16 startlump)
 // Returns lump position in PK3's lumpinfo, or INT16_MAX if not found.
 UINT16 W_CheckNumForFullNamePK3(const char *name, UINT16 wad, UINT16 startlump)
 {
-	INT32 i;
-	lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
+	wadfile_t *wadfile = wadfiles[wad];
 	size_t name_length = strlen(name);
-	for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
+	UINT16 found = INT16_MAX;
+	INT32 lo = 0, hi = wadfile->numlumps;
+	precise_t t = I_GetPreciseTime();
+
+	// Everything starting with name sits together in the sorted list,
+	// starting at the first entry that doesn't sort before it.
+	while (lo < hi)
 	{
-		if (!strnicmp(name, lump_p->fullname, name_length))
-		{
-			return i;
-		}
+		INT32 mid = (lo + hi)/2;
+		if (stricmp(wadfile->lumpinfo[wadfile->fullnames[mid]].fullname, name) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
-	// Not found at all?
-	return INT16_MAX;
+
+	for (; lo < wadfile->numlumps; lo++)
+	{
+		UINT16 i = wadfile->fullnames[lo];
+
+		if (strnicmp(name, wadfile->lumpinfo[i].fullname, name_length))
+			break;
+		if (i >= startlump && i < found)
+			found = i;
+	}
+
+	lumplookupstats[LOOKUP_FULLNAMEPK3].calls++;
+	if (found == INT16_MAX)
+		lumplookupstats[LOOKUP_FULLNAMEPK3].misses++;
+	lumplookupstats[LOOKUP_FULLNAMEPK3].time += I_GetPreciseTime() - t;
+
+	return found;
 }
 
 //
@@ -1080,43 +1764,29 @@ UINT16 W_CheckNumForFullNamePK3(const char *name, UINT16 wad, UINT16 startlump)
 //
 lumpnum_t W_CheckNumForName(const char *name)
 {
-	INT32 i;
-	lumpnum_t check = INT16_MAX;
+	char uname[9];
+	lumpdirslot_t *slot;
+	precise_t t;
 
 	if (!*name) // some doofus gave us an empty string?
 		return LUMPERROR;
 
-	// Check the lumpnumcache first. Loop backwards so that we check
-	// most recent entries first
-	for (i = lumpnumcacheindex + LUMPNUMCACHESIZE; i > lumpnumcacheindex; i--)
-	{
-		if (!lumpnumcache[i & (LUMPNUMCACHESIZE - 1)].lumpname[8]
-			&& strncmp(lumpnumcache[i & (LUMPNUMCACHESIZE - 1)].lumpname, name, 8) == 0)
-		{
-			lumpnumcacheindex = i & (LUMPNUMCACHESIZE - 1);
-			return lumpnumcache[lumpnumcacheindex].lumpnum;
-		}
-	}
+	t = I_GetPreciseTime();
 
-	// scan wad files backwards so patch lump files take precedence
-	for (i = numwadfiles - 1; i >= 0; i--)
-	{
-		check = W_CheckNumForNamePwad(name,(UINT16)i,0);
-		if (check != INT16_MAX)
-			break; //found it
-	}
+	memset(uname, 0, sizeof uname);
+	strncpy(uname, name, sizeof(uname)-1);
+	strupr(uname);
 
-	if (check == INT16_MAX) return LUMPERROR;
-	else
-	{
-		// Update the cache.
-		lumpnumcacheindex = (lumpnumcacheindex + 1) & (LUMPNUMCACHESIZE - 1);
-		memset(lumpnumcache[lumpnumcacheindex].lumpname, '\0', 32);
-		strncpy(lumpnumcache[lumpnumcacheindex].lumpname, name, 8);
-		lumpnumcache[lumpnumcacheindex].lumpnum = (i<<16)+check;
+	// The directory already points at the lump from the newest wad,
+	// so patch lump files take precedence
+	slot = LumpDirFind(&lumpdir, uname, W_HashLumpName(uname, 8));
 
-		return lumpnumcache[lumpnumcacheindex].lumpnum;
-	}
+	lumplookupstats[LOOKUP_NAME].calls++;
+	if (!slot)
+		lumplookupstats[LOOKUP_NAME].misses++;
+	lumplookupstats[LOOKUP_NAME].time += I_GetPreciseTime() - t;
+
+	return slot ? slot->lumpnum : LUMPERROR;
 }
 
 //
@@ -1127,48 +1797,28 @@ lumpnum_t W_CheckNumForName(const char *name)
 //
 lumpnum_t W_CheckNumForLongName(const char *name)
 {
-	INT32 i;
-	lumpnum_t check = INT16_MAX;
+	static char uname[256 + 1];
+	lumpdirslot_t *slot;
+	precise_t t;
 
 	if (!*name) // some doofus gave us an empty string?
 		return LUMPERROR;
 
-	// Check the lumpnumcache first. Loop backwards so that we check
-	// most recent entries first
-	for (i = lumpnumcacheindex + LUMPNUMCACHESIZE; i > lumpnumcacheindex; i--)
-	{
-		if (strcmp(lumpnumcache[i & (LUMPNUMCACHESIZE - 1)].lumpname, name) == 0)
-		{
-			lumpnumcacheindex = i & (LUMPNUMCACHESIZE - 1);
-			return lumpnumcache[lumpnumcacheindex].lumpnum;
-		}
-	}
+	t = I_GetPreciseTime();
 
-	if (check == INT16_MAX)
-	{
-		// scan wad files backwards so patch lump files take precedence
-		for (i = numwadfiles - 1; i >= 0; i--)
-		{
-			check = W_CheckNumForLongNamePwad(name,(UINT16)i,0);
-			if (check != INT16_MAX)
-				break; //found it
-		}
-	}
+	strlcpy(uname, name, sizeof uname);
+	strupr(uname);
 
-	if (check == INT16_MAX) return LUMPERROR;
-	else
-	{
-		if (strlen(name) < 32)
-		{
-			// Update the cache.
-			lumpnumcacheindex = (lumpnumcacheindex + 1) & (LUMPNUMCACHESIZE - 1);
-			memset(lumpnumcache[lumpnumcacheindex].lumpname, '\0', 32);
-			strlcpy(lumpnumcache[lumpnumcacheindex].lumpname, name, 32);
-			lumpnumcache[lumpnumcacheindex].lumpnum = (i << 16) + check;
-		}
+	// The directory already points at the lump from the newest wad,
+	// so patch lump files take precedence
+	slot = LumpDirFind(&longlumpdir, uname, W_HashLumpName(uname, SIZE_MAX));
 
-		return (i << 16) + check;
-	}
+	lumplookupstats[LOOKUP_LONGNAME].calls++;
+	if (!slot)
+		lumplookupstats[LOOKUP_LONGNAME].misses++;
+	lumplookupstats[LOOKUP_LONGNAME].time += I_GetPreciseTime() - t;
+
+	return slot ? slot->lumpnum : LUMPERROR;
 }
 
 // Look for valid map data through all added files in descendant order.
@@ -1362,6 +2012,33 @@ void zerr(int ret)
         CONS_Printf("zlib version mismatch!\n");
     }
 }
+
+// Inflates a raw deflate stream in one go. Touches nothing but its
+// arguments, so the prefetch workers can call it too.
+// Returns Z_STREAM_END on success, or the zlib error.
+static int W_InflateLump(UINT8 *raw, unsigned long rawsize, UINT8 *dest, unsigned long destsize)
+{
+	z_stream strm;
+	int zErr;
+
+	strm.zalloc = Z_NULL;
+	strm.zfree = Z_NULL;
+	strm.opaque = Z_NULL;
+
+	strm.total_in = strm.avail_in = rawsize;
+	strm.total_out = strm.avail_out = destsize;
+
+	strm.next_in = raw;
+	strm.next_out = dest;
+
+	zErr = inflateInit2(&strm, -15);
+	if (zErr != Z_OK)
+		return zErr;
+
+	zErr = inflate(&strm, Z_FINISH);
+	(void)inflateEnd(&strm);
+	return zErr;
+}
 #endif
 
 #define NO_PNG_LUMPS
@@ -1381,6 +2058,19 @@ static void ErrorIfPNG(UINT8 *d, size_t s, char *f, char *l)
 }
 #endif
 
+#ifdef THREADEDRENDER
+// Worker views cache lumps as they draw. The handles are shared and the
+// cache slot is filled before the read, so it's all done under one lock.
+static I_mutex lump_mutex;
+#  define Lock_lumps()   do { if (viewthreadsactive) I_lock_mutex(&lump_mutex); } while (0)
+#  define Unlock_lumps() do { if (viewthreadsactive) I_unlock_mutex(lump_mutex); } while (0)
+#else
+#  define Lock_lumps()
+#  define Unlock_lumps()
+#endif
+
+static size_t W_ReadLumpHeaderPwadUnlocked(UINT16 wad, UINT16 lump, void *dest, size_t size, size_t offset);
+
 /** Reads bytes from the head of a lump.
   * Note: If the lump is compressed, the whole thing has to be read anyway.
   *
@@ -1393,10 +2083,23 @@ static void ErrorIfPNG(UINT8 *d, size_t s, char *f, char *l)
   * \sa W_ReadLump, W_RawReadLumpHeader
   */
 size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, size_t offset)
+{
+	size_t bytesread;
+
+	Lock_lumps();
+	bytesread = W_ReadLumpHeaderPwadUnlocked(wad, lump, dest, size, offset);
+	Unlock_lumps();
+
+	return bytesread;
+}
+
+static size_t W_ReadLumpHeaderPwadUnlocked(UINT16 wad, UINT16 lump, void *dest, size_t size, size_t offset)
 {
 	size_t lumpsize;
 	lumpinfo_t *l;
 	FILE *handle;
+	UINT8 *mapped = NULL;
+	size_t mapsize = 0;
 
 	if (!TestValidLump(wad,lump))
 		return 0;
@@ -1411,24 +2114,37 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 		size = lumpsize - offset;
 
 	// Let's get the raw lump data.
-	// We setup the desired file handle to read the lump data.
+	// If the file is mapped it's right there, otherwise we setup the
+	// desired file handle to read the lump data.
 	l = wadfiles[wad]->lumpinfo + lump;
 	handle = wadfiles[wad]->handle;
-	fseek(handle, (long)(l->position + offset), SEEK_SET);
+	if (wadfiles[wad]->mapped)
+	{
+		mapped = (UINT8 *)wadfiles[wad]->mapped + l->position + offset;
+		mapsize = (l->position + offset < wadfiles[wad]->filesize) ? wadfiles[wad]->filesize - (l->position + offset) : 0;
+	}
+	else
+		fseek(handle, (long)(l->position + offset), SEEK_SET);
 
 	// But let's not copy it yet. We support different compression formats on lumps, so we need to take that into account.
 	switch(wadfiles[wad]->lumpinfo[lump].compression)
 	{
 	case CM_NOCOMPRESSION:		// If it's uncompressed, we directly write the data into our destination, and return the bytes read.
-#ifdef NO_PNG_LUMPS
 		{
-			size_t bytesread = fread(dest, 1, size, handle);
+			size_t bytesread;
+
+			if (mapped)
+			{
+				bytesread = min(size, mapsize);
+				M_Memcpy(dest, mapped, bytesread);
+			}
+			else
+				bytesread = fread(dest, 1, size, handle);
+#ifdef NO_PNG_LUMPS
 			ErrorIfPNG(dest, bytesread, wadfiles[wad]->filename, l->fullname);
+#endif
 			return bytesread;
 		}
-#else
-		return fread(dest, 1, size, handle);
-#endif
 	case CM_LZF:		// Is it LZF compressed? Used by ZWADs.
 		{
 #ifdef ZWAD
@@ -1436,11 +2152,20 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 			char *decData; // Lump's decompressed real data.
 			size_t retval; // Helper var, lzf_decompress returns 0 when an error occurs.
 
-			rawData = Z_Malloc(l->disksize, PU_STATIC, NULL);
 			decData = Z_Malloc(l->size, PU_STATIC, NULL);
 
-			if (fread(rawData, 1, l->disksize, handle) < l->disksize)
-				I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+			if (mapped)
+			{
+				if (mapsize < l->disksize)
+					I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+				rawData = (char *)mapped;
+			}
+			else
+			{
+				rawData = Z_Malloc(l->disksize, PU_STATIC, NULL);
+				if (fread(rawData, 1, l->disksize, handle) < l->disksize)
+					I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+			}
 			retval = lzf_decompress(rawData, l->disksize, decData, l->size);
 #ifndef AVOID_ERRNO
 			if (retval == 0) // If this was returned, check if errno was set
@@ -1461,7 +2186,8 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 			if (!decData) // Did we get no data at all?
 				return 0;
 			M_Memcpy(dest, decData + offset, size);
-			Z_Free(rawData);
+			if (!mapped)
+				Z_Free(rawData);
 			Z_Free(decData);
 #ifdef NO_PNG_LUMPS
 			ErrorIfPNG(dest, size, wadfiles[wad]->filename, l->fullname);
@@ -1480,49 +2206,35 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 			UINT8 *decData; // Lump's decompressed real data.
 
 			int zErr; // Helper var.
-			z_stream strm;
 			unsigned long rawSize = l->disksize;
 			unsigned long decSize = l->size;
 
-			rawData = Z_Malloc(rawSize, PU_STATIC, NULL);
 			decData = Z_Malloc(decSize, PU_STATIC, NULL);
 
-			if (fread(rawData, 1, rawSize, handle) < rawSize)
-				I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
-
-			strm.zalloc = Z_NULL;
-			strm.zfree = Z_NULL;
-			strm.opaque = Z_NULL;
-
-			strm.total_in = strm.avail_in = rawSize;
-			strm.total_out = strm.avail_out = decSize;
-
-			strm.next_in = rawData;
-			strm.next_out = decData;
-
-			zErr = inflateInit2(&strm, -15);
-			if (zErr == Z_OK)
+			if (mapped)
 			{
-				zErr = inflate(&strm, Z_FINISH);
-				if (zErr == Z_STREAM_END)
-				{
-					M_Memcpy(dest, decData, size);
-				}
-				else
-				{
-					size = 0;
-					zerr(zErr);
-				}
-				(void)inflateEnd(&strm);
+				if (mapsize < rawSize)
+					I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+				rawData = mapped;
+			}
+			else
+			{
+				rawData = Z_Malloc(rawSize, PU_STATIC, NULL);
+				if (fread(rawData, 1, rawSize, handle) < rawSize)
+					I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
 			}
+
+			zErr = W_InflateLump(rawData, rawSize, decData, decSize);
+			if (zErr == Z_STREAM_END)
+				M_Memcpy(dest, decData, size);
 			else
 			{
-				CONS_Printf("whopet\n");
 				size = 0;
 				zerr(zErr);
 			}
 
-			Z_Free(rawData);
+			if (!mapped)
+				Z_Free(rawData);
 			Z_Free(decData);
 
 #ifdef NO_PNG_LUMPS
@@ -1537,6 +2249,312 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 	return -1;
 }
 
+// Returns an uncompressed lump straight out of the file mapping, or NULL
+// if it has to be read into a zone block instead.
+static void *W_MappedLumpPwad(UINT16 wad, UINT16 lump)
+{
+	wadfile_t *wadfile = wadfiles[wad];
+	lumpinfo_t *l = &wadfile->lumpinfo[lump];
+	UINT8 *ptr;
+
+	if (!wadfile->mapped || l->compression != CM_NOCOMPRESSION
+		|| !l->size || l->position + l->size > wadfile->filesize)
+		return NULL;
+
+	ptr = (UINT8 *)wadfile->mapped + l->position;
+
+#ifndef MAPUNALIGNED
+	if ((size_t)ptr & 3)
+		return NULL;
+#endif
+
+#ifdef NO_PNG_LUMPS
+	ErrorIfPNG(ptr, l->size, wadfile->filename, l->fullname);
+#endif
+	return ptr;
+}
+
+// ==========================================================================
+//                                                             LUMP PREFETCH
+// ==========================================================================
+
+#ifdef PREFETCHLUMPS
+// Deflated lumps queued by W_PrefetchLumpPwad get inflated by a few worker
+// threads into zone blocks the main thread allocated for them up front.
+// The workers never call into the zone; W_CacheLumpNumPwad hands a block
+// over to the lump cache once it is done, waiting for it if need be.
+#define PREFETCHTHREADS 3
+#define PREFETCHHASHSIZE 1024 // power of two
+
+typedef enum
+{
+	PF_QUEUED,
+	PF_DONE,
+	PF_FAILED,
+	PF_COLLECTED
+} prefetchstate_t;
+
+typedef struct
+{
+	UINT16 wad, lump;
+	UINT8 *raw; // compressed data, in the file mapping or read into a zone block
+	boolean ownraw;
+	unsigned long rawsize;
+	UINT8 *dest; // PU_STATIC block without a user until collected
+	unsigned long size;
+	prefetchstate_t state;
+	INT32 next; // hash chain
+} prefetchjob_t;
+
+static prefetchjob_t *prefetchjobs;
+static INT32 numprefetchjobs, maxprefetchjobs;
+static INT32 nextprefetchjob; // next job a worker picks up
+static INT32 prefetchhash[PREFETCHHASHSIZE];
+static INT32 prefetchworkers;
+static boolean prefetchwaiting;
+
+// Everything above is shared with the workers and guarded by this.
+static I_mutex prefetch_mutex;
+static I_cond prefetch_cond;
+
+static struct
+{
+	UINT32 lumps;
+	UINT32 waits;
+	size_t bytes;
+	precise_t waittime;
+} prefetchstats;
+
+static inline INT32 W_PrefetchHash(UINT16 wad, UINT16 lump)
+{
+	return ((wad * 0x9E37) ^ lump) & (PREFETCHHASHSIZE - 1);
+}
+
+static void W_PrefetchWorker(void *userdata)
+{
+	(void)userdata;
+
+	I_lock_mutex(&prefetch_mutex);
+	while (nextprefetchjob < numprefetchjobs && !I_thread_is_stopped())
+	{
+		INT32 i = nextprefetchjob++;
+		UINT8 *raw = prefetchjobs[i].raw;
+		unsigned long rawsize = prefetchjobs[i].rawsize;
+		UINT8 *dest = prefetchjobs[i].dest;
+		unsigned long size = prefetchjobs[i].size;
+		int zErr;
+
+		I_unlock_mutex(prefetch_mutex);
+		zErr = W_InflateLump(raw, rawsize, dest, size);
+		I_lock_mutex(&prefetch_mutex);
+
+		prefetchjobs[i].state = (zErr == Z_STREAM_END) ? PF_DONE : PF_FAILED;
+		if (prefetchwaiting)
+			I_wake_all_cond(&prefetch_cond);
+	}
+	prefetchworkers--;
+	I_unlock_mutex(prefetch_mutex);
+}
+
+// Call with prefetch_mutex held.
+static prefetchjob_t *W_FindPrefetchJob(UINT16 wad, UINT16 lump)
+{
+	INT32 i;
+
+	if (!numprefetchjobs)
+		return NULL;
+
+	for (i = prefetchhash[W_PrefetchHash(wad, lump)]; i != -1; i = prefetchjobs[i].next)
+		if (prefetchjobs[i].wad == wad && prefetchjobs[i].lump == lump)
+			return &prefetchjobs[i];
+
+	return NULL;
+}
+
+// Waits for the job if a worker hasn't gotten to it yet, then moves its
+// block into the lump cache. Call with prefetch_mutex held.
+static void W_CollectPrefetchJob(prefetchjob_t *job, INT32 tag)
+{
+	lumpcache_t *lumpcache = wadfiles[job->wad]->lumpcache;
+	lumpinfo_t *l = &wadfiles[job->wad]->lumpinfo[job->lump];
+
+	if (job->state == PF_QUEUED)
+	{
+		precise_t t = I_GetPreciseTime();
+
+		prefetchwaiting = true;
+		while (job->state == PF_QUEUED)
+			I_hold_cond(&prefetch_cond, prefetch_mutex);
+		prefetchwaiting = false;
+
+		prefetchstats.waits++;
+		prefetchstats.waittime += I_GetPreciseTime() - t;
+	}
+
+	if (job->ownraw)
+		Z_Free(job->raw);
+
+	// Failed ones get read again the usual way, which reports the error.
+	if (job->state == PF_DONE && !lumpcache[job->lump])
+	{
+#ifdef NO_PNG_LUMPS
+		ErrorIfPNG(job->dest, job->size, wadfiles[job->wad]->filename, l->fullname);
+#else
+		(void)l;
+#endif
+		Z_SetUser(job->dest, &lumpcache[job->lump]);
+		Z_ChangeTag(job->dest, tag);
+	}
+	else
+		Z_Free(job->dest);
+
+	job->state = PF_COLLECTED;
+}
+
+// Returns true if the lump was prefetched and is now in the cache.
+static boolean W_CollectPrefetchedLump(UINT16 wad, UINT16 lump, INT32 tag)
+{
+	prefetchjob_t *job;
+	boolean collected = false;
+
+	if (!numprefetchjobs)
+		return false;
+
+	I_lock_mutex(&prefetch_mutex);
+	job = W_FindPrefetchJob(wad, lump);
+	if (job && job->state != PF_COLLECTED)
+	{
+		W_CollectPrefetchJob(job, tag);
+		collected = (wadfiles[wad]->lumpcache[lump] != NULL);
+	}
+	I_unlock_mutex(prefetch_mutex);
+
+	return collected;
+}
+#endif
+
+/** Queues a lump to be inflated in the background, so a later
+  * W_CacheLumpNumPwad finds it ready. Only deflated lumps that aren't
+  * cached yet are worth it; anything else is ignored.
+  *
+  * \sa W_FinishPrefetch
+  */
+void W_PrefetchLumpPwad(UINT16 wad, UINT16 lump)
+{
+#ifdef PREFETCHLUMPS
+	wadfile_t *wadfile;
+	lumpinfo_t *l;
+	prefetchjob_t job;
+	INT32 hash;
+
+	if (!TestValidLump(wad, lump))
+		return;
+
+	wadfile = wadfiles[wad];
+	l = &wadfile->lumpinfo[lump];
+	if (l->compression != CM_DEFLATE || !l->size || !l->disksize || wadfile->lumpcache[lump])
+		return;
+
+	job.wad = wad;
+	job.lump = lump;
+	job.rawsize = l->disksize;
+	job.size = l->size;
+	job.state = PF_QUEUED;
+
+	I_lock_mutex(&prefetch_mutex);
+	if (W_FindPrefetchJob(wad, lump))
+	{
+		I_unlock_mutex(prefetch_mutex);
+		return;
+	}
+	I_unlock_mutex(prefetch_mutex);
+
+	// The file handle isn't ours to share, so without a mapping the
+	// compressed data is read here and only the inflating is left over.
+	if (wadfile->mapped && l->position + l->disksize <= wadfile->filesize)
+	{
+		job.raw = (UINT8 *)wadfile->mapped + l->position;
+		job.ownraw = false;
+	}
+	else
+	{
+		job.raw = Z_Malloc(job.rawsize, PU_STATIC, NULL);
+		job.ownraw = true;
+		fseek(wadfile->handle, (long)l->position, SEEK_SET);
+		if (fread(job.raw, 1, job.rawsize, wadfile->handle) < job.rawsize)
+		{
+			Z_Free(job.raw);
+			return;
+		}
+	}
+	job.dest = Z_Malloc(job.size, PU_STATIC, NULL);
+
+	I_lock_mutex(&prefetch_mutex);
+	{
+		if (!numprefetchjobs)
+			memset(prefetchhash, -1, sizeof prefetchhash);
+
+		if (numprefetchjobs >= maxprefetchjobs)
+		{
+			maxprefetchjobs = maxprefetchjobs ? maxprefetchjobs * 2 : 256;
+			prefetchjobs = Z_Realloc(prefetchjobs, maxprefetchjobs * sizeof *prefetchjobs, PU_STATIC, NULL);
+		}
+
+		hash = W_PrefetchHash(wad, lump);
+		job.next = prefetchhash[hash];
+		prefetchhash[hash] = numprefetchjobs;
+		prefetchjobs[numprefetchjobs++] = job;
+
+		prefetchstats.lumps++;
+		prefetchstats.bytes += job.size;
+
+		if (prefetchworkers < PREFETCHTHREADS)
+		{
+			prefetchworkers++;
+			I_spawn_thread("lump-prefetch", W_PrefetchWorker, NULL);
+		}
+	}
+	I_unlock_mutex(prefetch_mutex);
+#else
+	(void)wad;
+	(void)lump;
+#endif
+}
+
+void W_PrefetchLumpNum(lumpnum_t lumpnum)
+{
+	W_PrefetchLumpPwad(WADFILENUM(lumpnum), LUMPNUM(lumpnum));
+}
+
+/** Waits for every queued lump and moves whatever wasn't asked for yet
+  * into the cache as PU_CACHE, then forgets the queue.
+  */
+void W_FinishPrefetch(void)
+{
+#ifdef PREFETCHLUMPS
+	INT32 i;
+
+	if (!numprefetchjobs)
+		return;
+
+	I_lock_mutex(&prefetch_mutex);
+	{
+		for (i = 0; i < numprefetchjobs; i++)
+			if (prefetchjobs[i].state != PF_COLLECTED)
+				W_CollectPrefetchJob(&prefetchjobs[i], PU_CACHE);
+
+		// Workers still on their way out only look at the counters.
+		numprefetchjobs = nextprefetchjob = 0;
+	}
+	I_unlock_mutex(prefetch_mutex);
+
+	CONS_Debug(DBG_SETUP, "Prefetched %u lumps (%s k), waited on %u for %.2f ms\n",
+		prefetchstats.lumps, sizeu1(prefetchstats.bytes>>10), prefetchstats.waits,
+		(double)prefetchstats.waittime * 1000.0 / I_GetPrecisePrecision());
+	memset(&prefetchstats, 0, sizeof prefetchstats);
+#endif
+}
+
 size_t W_ReadLumpHeader(lumpnum_t lumpnum, void *dest, size_t size, size_t offset)
 {
 	return W_ReadLumpHeaderPwad(WADFILENUM(lumpnum), LUMPNUM(lumpnum), dest, size, offset);
@@ -1565,20 +2583,39 @@ void W_ReadLumpPwad(UINT16 wad, UINT16 lump, void *dest)
 void *W_CacheLumpNumPwad(UINT16 wad, UINT16 lump, INT32 tag)
 {
 	lumpcache_t *lumpcache;
+	void *cached;
 
 	if (!TestValidLump(wad,lump))
 		return NULL;
 
 	lumpcache = wadfiles[wad]->lumpcache;
+	Lock_lumps();
+#ifdef PREFETCHLUMPS
+	if (!lumpcache[lump] && W_CollectPrefetchedLump(wad, lump, tag))
+	{
+		cached = lumpcache[lump];
+		Unlock_lumps();
+		return cached;
+	}
+#endif
 	if (!lumpcache[lump])
 	{
-		void *ptr = Z_Malloc(W_LumpLengthPwad(wad, lump), tag, &lumpcache[lump]);
-		W_ReadLumpHeaderPwad(wad, lump, ptr, 0, 0);  // read the lump in full
+		void *ptr = W_MappedLumpPwad(wad, lump);
+
+		if (ptr) // no copy needed, the zone ignores it
+			lumpcache[lump] = ptr;
+		else
+		{
+			ptr = Z_Malloc(W_LumpLengthPwad(wad, lump), tag, &lumpcache[lump]);
+			W_ReadLumpHeaderPwad(wad, lump, ptr, 0, 0);  // read the lump in full
+		}
 	}
 	else
 		Z_ChangeTag(lumpcache[lump], tag);
+	cached = lumpcache[lump];
+	Unlock_lumps();
 
-	return lumpcache[lump];
+	return cached;
 }
 
 void *W_CacheLumpNum(lumpnum_t lumpnum, INT32 tag)
@@ -110,7 +110,12 @@ typedef struct wadfile_s
 	aatree_t *hwrcache; // patches are cached in renderer's native format
 #endif
 	UINT16 numlumps; // this wad's number of resources
+	UINT32 hashmask; // lump name index, see W_IndexLumps
+	UINT16 *namehash, *namenext; // first lump per bucket, next lump with the same name hash
+	UINT16 *longhash, *longnext;
+	UINT16 *fullnames; // lumps sorted by full name, case insensitive
 	FILE *handle;
+	void *mapped; // whole file mapped read-only, or NULL
 	UINT32 filesize; // for network
 	UINT8 md5sum[16];
 	boolean important;
@@ -182,6 +187,11 @@ void *W_CacheLumpNumForce(lumpnum_t lumpnum, INT32 tag);
 
 boolean W_IsLumpCached(lumpnum_t lump, void *ptr);
 
+// Background inflating of lumps about to be cached, see P_SetupLevel
+void W_PrefetchLumpPwad(UINT16 wad, UINT16 lump);
+void W_PrefetchLumpNum(lumpnum_t lumpnum);
+void W_FinishPrefetch(void);
+
 void *W_CacheLumpName(const char *name, INT32 tag);
 void *W_CachePatchName(const char *name, INT32 tag);
 
@@ -195,8 +205,13 @@ void *W_CachePatchNum(lumpnum_t lumpnum, INT32 tag); // return a patch_t
 
 void W_UnlockCachedPatch(void *patch);
 
+INT32 W_GetFileMD5(const char *filename, void *resblock); // cached, see md5cache
+void W_FlushMD5Cache(void);
 void W_VerifyFileMD5(UINT16 wadfilenum, const char *matchmd5);
 
+void Command_Lumpstats_f(void);
+void Command_Md5cache_f(void);
+
 int W_VerifyNMUSlumps(const char *filename);
 
 #endif // __W_WAD__
@@ -24,6 +24,17 @@
 ///        caught with this direct-malloc version. We also suspected that SRB2's
 ///        allocator was fragmenting badly. Finally, this version is a bit
 ///        simpler (about half the lines of code).
+///
+///        Every block keeps its memblock_t inline, right in front of the
+///        memhdr_t, so an allocation is a single trip to the heap. Blocks are
+///        linked into one list per tag, so purging a range of tags only visits
+///        the blocks that are actually being freed.
+///
+///        Small unaligned PU_STATIC and PU_LEVEL/PU_LEVSPEC allocations are
+///        carved out of size-class slabs owned by a per-tag arena. Freeing a
+///        slab block only puts the slot back on its slab's free list; once a
+///        Z_FreeTags pass empties a slab the whole slab goes back to the heap
+///        at once. Valgrind builds skip the slabs so overruns are still caught.
 
 #include "doomdef.h"
 #include "doomstat.h"
@@ -33,6 +44,19 @@
 #include "m_misc.h" // M_Memcpy
 #include "lua_script.h"
 
+#ifdef THREADEDRENDER
+#include "i_threads.h"
+
+static I_mutex zone_mutex;
+// The zone is used long before the thread system is up, so it only locks
+// while views are being drawn on worker threads.
+#  define Lock_zone()   do { if (viewthreadsactive) I_lock_mutex(&zone_mutex); } while (0)
+#  define Unlock_zone() do { if (viewthreadsactive) I_unlock_mutex(zone_mutex); } while (0)
+#else
+#  define Lock_zone()
+#  define Unlock_zone()
+#endif
+
 #ifdef HWRENDER
 #include "hardware/hw_main.h" // For hardware memory info
 #endif
@@ -49,7 +73,15 @@ static boolean Z_calloc = false;
 //#define ZDEBUG2
 #endif
 
+#ifndef HAVE_VALGRIND
+#define ZONESLABS
+#endif
+
+// Every tag must be below this; tags are used to index the per-tag lists.
+#define NUMZONETAGS 128
+
 struct memblock_s;
+struct zslab_s;
 
 typedef struct
 {
@@ -60,12 +92,11 @@ typedef struct
 // Some code might want aligned memory. Assume it wants memory n bytes
 // aligned -- then we allocate n-1 extra bytes and return a pointer to
 // the first byte aligned as requested.
-// Thus, "real" is the pointer we get from malloc() and will free()
-// later, but "hdr" is where the memhdr_t starts.
-// For non-aligned allocations they will be the same.
+// The memblock_t lives at the very start of what we get from malloc()
+// (or of the slab slot), so freeing the block frees everything, but "hdr"
+// is where the memhdr_t starts, right before the pointer we hand out.
 typedef struct memblock_s
 {
-	void *real;
 	memhdr_t *hdr;
 
 	void **user;
@@ -74,6 +105,8 @@ typedef struct memblock_s
 	size_t size; // including the header and blocks
 	size_t realsize; // size of real data only
 
+	struct zslab_s *slab; // slab this block was carved from, or NULL
+
 #ifdef ZDEBUG
 	const char *ownerfile;
 	INT32 ownerline;
@@ -82,6 +115,91 @@ typedef struct memblock_s
 	struct memblock_s *next, *prev;
 } ATTRPACK memblock_t;
 
+// Bytes in front of the data of an unaligned block.
+#define ZONEHEADSIZE (sizeof (memblock_t) + sizeof (memhdr_t))
+
+#define Block2Ptr(block) ((UINT8 *)(block)->hdr + sizeof *(block)->hdr)
+
+// Per-tag bookkeeping: every live block is in exactly one of these lists.
+typedef struct
+{
+	memblock_t head;
+	size_t bytes; // total of block->size
+	UINT32 blocks;
+	size_t slabbytes; // part of bytes that lives in slab slots
+	UINT32 slabblocks;
+} ztag_t;
+
+static ztag_t zonetags[NUMZONETAGS];
+
+// Ranges registered with Z_AddExternalRange, sorted by start.
+typedef struct
+{
+	UINT8 *start, *end;
+} zexternal_t;
+
+static zexternal_t *zexternal = NULL;
+static size_t numzexternal = 0;
+static size_t zexternalbytes = 0;
+
+//
+// Slabs
+//
+
+#ifdef ZONESLABS
+#define SLABSIZE (64<<10)
+
+// Data sizes served by the slabs, largest must fit mobj_t.
+static const size_t slabclasssizes[] = {
+	16, 32, 48, 64, 96, 128, 160, 192, 256, 320, 416, 512
+};
+#define NUMSLABCLASSES (sizeof slabclasssizes / sizeof *slabclasssizes)
+#define MAXSLABALLOC 512
+
+struct zslabclass_s;
+
+// Slot layout: [memblock_t][memhdr_t][data], slotsize bytes each.
+// Free slots are chained through their first bytes.
+typedef struct zslab_s
+{
+	struct zslabclass_s *cls;
+	struct zslab_s *next, *prev;
+	UINT8 *freeslots; // recycled slots
+	UINT8 *slots; // first slot
+	UINT16 used;
+	UINT16 bump; // slots never handed out start here
+	UINT16 total;
+} zslab_t;
+
+typedef struct zslabclass_s
+{
+	size_t slotsize;
+	zslab_t *partial; // slabs with at least one free slot
+	zslab_t *full;
+	UINT32 numslabs;
+	UINT32 numempty;
+	struct zarena_s *arena;
+} zslabclass_t;
+
+typedef struct zarena_s
+{
+	const char *name;
+	zslabclass_t classes[NUMSLABCLASSES];
+	UINT32 numslabs;
+	UINT32 usedslots;
+	size_t usedbytes; // slot bytes handed out
+} zarena_t;
+
+static zarena_t staticarena;
+static zarena_t levelarena;
+
+// Set while Z_FreeTags runs, so empty slabs are kept until the end of the
+// pass and released in one go.
+static boolean zonebulkfree = false;
+
+static UINT8 slabclassfor[MAXSLABALLOC/16 + 1];
+#endif
+
 #ifdef ZDEBUG
 #define Ptr2Memblock(s, f) Ptr2Memblock2(s, f, __FILE__, __LINE__)
 static memblock_t *Ptr2Memblock2(void *ptr, const char* func, const char *file, INT32 line)
@@ -131,20 +249,254 @@ static memblock_t *Ptr2Memblock(void *ptr, const char* func)
 
 }
 
-static memblock_t head;
+static inline void Z_LinkBlock(memblock_t *block, INT32 tag)
+{
+	ztag_t *zt;
+
+	if (tag < 0 || tag >= NUMZONETAGS)
+		I_Error("Z_Malloc: bad tag %d", tag);
+
+	zt = &zonetags[tag];
+
+	block->tag = tag;
+	block->prev = &zt->head;
+	block->next = zt->head.next;
+	zt->head.next = block;
+	block->next->prev = block;
+
+	zt->bytes += block->size;
+	zt->blocks++;
+	if (block->slab)
+	{
+		zt->slabbytes += block->size;
+		zt->slabblocks++;
+	}
+}
+
+static inline void Z_UnlinkBlock(memblock_t *block)
+{
+	ztag_t *zt = &zonetags[block->tag];
+
+	block->prev->next = block->next;
+	block->next->prev = block->prev;
+
+	zt->bytes -= block->size;
+	zt->blocks--;
+	if (block->slab)
+	{
+		zt->slabbytes -= block->size;
+		zt->slabblocks--;
+	}
+}
 
 static void Command_Memfree_f(void);
 #ifdef ZDEBUG
 static void Command_Memdump_f(void);
 #endif
 
+// malloc() that doesn't accept failure.
+static void *xm(size_t size)
+{
+	const size_t padedsize = size+sizeof (size_t);
+	void *p = malloc(padedsize);
+
+	if (p == NULL)
+	{
+		// Oh crumbs: we're out of heap. Try purging the cache and reallocating.
+		Z_FreeTags(PU_PURGELEVEL, INT32_MAX);
+		p = malloc(padedsize);
+
+		if (p == NULL)
+		{
+#if defined (_NDS) | defined (_PSP)
+			// Temporary-ish debugging measure
+			Command_Memfree_f();
+#endif
+			I_Error("Out of memory allocating %s bytes", sizeu1(size));
+		}
+	}
+
+	return p;
+}
+
+#ifdef ZONESLABS
+static void Z_InitArena(zarena_t *arena, const char *name)
+{
+	size_t i;
+
+	arena->name = name;
+	for (i = 0; i < NUMSLABCLASSES; i++)
+	{
+		arena->classes[i].slotsize = ZONEHEADSIZE + slabclasssizes[i];
+		arena->classes[i].arena = arena;
+	}
+}
+
+static inline zarena_t *Z_ArenaForTag(INT32 tag)
+{
+	switch (tag)
+	{
+		case PU_STATIC:
+			return &staticarena;
+		case PU_LEVEL:
+		case PU_LEVSPEC:
+			return &levelarena;
+		default:
+			return NULL;
+	}
+}
+
+static inline void Z_SlabListInsert(zslab_t **list, zslab_t *slab)
+{
+	slab->prev = NULL;
+	slab->next = *list;
+	if (*list)
+		(*list)->prev = slab;
+	*list = slab;
+}
+
+static inline void Z_SlabListRemove(zslab_t **list, zslab_t *slab)
+{
+	if (slab->prev)
+		slab->prev->next = slab->next;
+	else
+		*list = slab->next;
+	if (slab->next)
+		slab->next->prev = slab->prev;
+}
+
+static void Z_ReleaseSlab(zslab_t *slab)
+{
+	zslabclass_t *cls = slab->cls;
+
+	Z_SlabListRemove(&cls->partial, slab);
+	cls->numslabs--;
+	cls->numempty--;
+	cls->arena->numslabs--;
+	free(slab);
+}
+
+// Hands out one slot, already formatted as [memblock_t][memhdr_t].
+static memblock_t *Z_SlabAlloc(zarena_t *arena, size_t size)
+{
+	zslabclass_t *cls = &arena->classes[slabclassfor[(size + 15)>>4]];
+	zslab_t *slab = cls->partial;
+	UINT8 *slot;
+
+	if (slab == NULL)
+	{
+		slab = xm(SLABSIZE);
+		slab->cls = cls;
+		slab->freeslots = NULL;
+		slab->slots = (UINT8 *)slab + ((sizeof *slab + 15) & ~(size_t)15);
+		slab->used = slab->bump = 0;
+		slab->total = (UINT16)((SLABSIZE - (slab->slots - (UINT8 *)slab)) / cls->slotsize);
+		Z_SlabListInsert(&cls->partial, slab);
+		cls->numslabs++;
+		cls->numempty++;
+		arena->numslabs++;
+	}
+
+	if (slab->freeslots)
+	{
+		slot = slab->freeslots;
+		slab->freeslots = *(UINT8 **)slot;
+	}
+	else
+		slot = slab->slots + slab->bump++ * cls->slotsize;
+
+	if (slab->used++ == 0)
+		cls->numempty--;
+
+	if (slab->used == slab->total)
+	{
+		Z_SlabListRemove(&cls->partial, slab);
+		Z_SlabListInsert(&cls->full, slab);
+	}
+
+	arena->usedslots++;
+	arena->usedbytes += cls->slotsize;
+
+	((memblock_t *)slot)->slab = slab;
+	((memblock_t *)slot)->size = cls->slotsize;
+	((memblock_t *)slot)->hdr = (memhdr_t *)(slot + sizeof (memblock_t));
+	return (memblock_t *)slot;
+}
+
+static void Z_SlabFree(memblock_t *block)
+{
+	zslab_t *slab = block->slab;
+	zslabclass_t *cls = slab->cls;
+	UINT8 *slot = (UINT8 *)block;
+
+	if (slab->used == slab->total)
+	{
+		Z_SlabListRemove(&cls->full, slab);
+		Z_SlabListInsert(&cls->partial, slab);
+	}
+
+	*(UINT8 **)slot = slab->freeslots;
+	slab->freeslots = slot;
+
+	cls->arena->usedslots--;
+	cls->arena->usedbytes -= cls->slotsize;
+
+	if (--slab->used == 0)
+	{
+		cls->numempty++;
+
+		// Keep one empty slab around so spawn/remove churn doesn't bounce
+		// off the heap; Z_FreeTags cleans up the rest in bulk.
+		if (!zonebulkfree && cls->numempty > 1)
+			Z_ReleaseSlab(slab);
+	}
+}
+
+static void Z_ReleaseEmptySlabs(zarena_t *arena)
+{
+	zslab_t *slab, *next;
+	size_t i;
+
+	for (i = 0; i < NUMSLABCLASSES; i++)
+	{
+		zslabclass_t *cls = &arena->classes[i];
+
+		if (!cls->numempty)
+			continue;
+
+		for (slab = cls->partial; slab; slab = next)
+		{
+			next = slab->next;
+			if (slab->used == 0)
+				Z_ReleaseSlab(slab);
+		}
+	}
+}
+#endif
+
 void Z_Init(void)
 {
 	UINT32 total, memfree;
+	INT32 i;
 
-	memset(&head, 0x00, sizeof(head));
+	memset(zonetags, 0x00, sizeof(zonetags));
 
-	head.next = head.prev = &head;
+	for (i = 0; i < NUMZONETAGS; i++)
+		zonetags[i].head.next = zonetags[i].head.prev = &zonetags[i].head;
+
+#ifdef ZONESLABS
+	{
+		size_t c = 0, s;
+		for (s = 0; s <= MAXSLABALLOC/16; s++)
+		{
+			while (slabclasssizes[c] < s<<4)
+				c++;
+			slabclassfor[s] = (UINT8)c;
+		}
+	}
+	Z_InitArena(&staticarena, "Static");
+	Z_InitArena(&levelarena, "Level");
+#endif
 
 	memfree = I_GetFreeMem(&total)>>20;
 	CONS_Printf("System memory: %uMB - Free: %uMB\n", total>>20, memfree);
@@ -157,6 +509,56 @@ void Z_Init(void)
 #endif
 }
 
+void Z_AddExternalRange(void *start, size_t size)
+{
+	size_t i;
+
+	zexternal = realloc(zexternal, (numzexternal + 1) * sizeof *zexternal);
+	if (!zexternal)
+		I_Error("Z_AddExternalRange: out of memory");
+
+	for (i = numzexternal; i > 0 && zexternal[i-1].start > (UINT8 *)start; i--)
+		zexternal[i] = zexternal[i-1];
+
+	zexternal[i].start = start;
+	zexternal[i].end = (UINT8 *)start + size;
+	numzexternal++;
+	zexternalbytes += size;
+}
+
+void Z_RemoveExternalRange(void *start)
+{
+	size_t i;
+
+	for (i = 0; i < numzexternal; i++)
+	{
+		if (zexternal[i].start != start)
+			continue;
+
+		zexternalbytes -= zexternal[i].end - zexternal[i].start;
+		numzexternal--;
+		memmove(&zexternal[i], &zexternal[i+1], (numzexternal - i) * sizeof *zexternal);
+		return;
+	}
+}
+
+boolean Z_IsExternal(const void *ptr)
+{
+	size_t lo = 0, hi = numzexternal;
+
+	// find the last range starting at or before ptr
+	while (lo < hi)
+	{
+		size_t mid = (lo + hi)/2;
+		if (zexternal[mid].start <= (const UINT8 *)ptr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return (lo && (const UINT8 *)ptr < zexternal[lo-1].end);
+}
+
 #ifdef ZDEBUG
 void Z_Free2(void *ptr, const char *file, INT32 line)
 #else
@@ -168,6 +570,9 @@ void Z_Free(void *ptr)
 	if (ptr == NULL)
 		return;
 
+	if (numzexternal && Z_IsExternal(ptr))
+		return;
+
 #ifdef ZDEBUG2
 	CONS_Debug(DBG_MEMORY, "Z_Free %s:%d\n", file, line);
 #endif
@@ -183,6 +588,8 @@ void Z_Free(void *ptr)
 	CONS_Debug(DBG_MEMORY, "Z_Free at %s:%d\n", file, line);
 #endif
 
+	Lock_zone();
+
 #ifdef HAVE_BLUA
 	// anything that isn't by lua gets passed to lua just in case.
 	if (block->tag != PU_LUA)
@@ -196,39 +603,22 @@ void Z_Free(void *ptr)
 	if (block->user != NULL)
 		*block->user = NULL;
 
-	// Free the memory and get rid of the block.
-	free(block->real);
-	block->prev->next = block->next;
-	block->next->prev = block->prev;
-	free(block);
+	// Get rid of the block, and the memory with it.
+	Z_UnlinkBlock(block);
 #ifdef VALGRIND_DESTROY_MEMPOOL
 	VALGRIND_DESTROY_MEMPOOL(block);
 #endif
-}
-
-// malloc() that doesn't accept failure.
-static void *xm(size_t size)
-{
-	const size_t padedsize = size+sizeof (size_t);
-	void *p = malloc(padedsize);
-
-	if (p == NULL)
+#ifdef ZONESLABS
+	if (block->slab)
 	{
-		// Oh crumbs: we're out of heap. Try purging the cache and reallocating.
-		Z_FreeTags(PU_PURGELEVEL, INT32_MAX);
-		p = malloc(padedsize);
-
-		if (p == NULL)
-		{
-#if defined (_NDS) | defined (_PSP)
-			// Temporary-ish debugging measure
-			Command_Memfree_f();
-#endif
-			I_Error("Out of memory allocating %s bytes", sizeu1(size));
-		}
+		block->hdr->id = 0; // catch double frees of recycled slots
+		Z_SlabFree(block);
+		Unlock_zone();
+		return;
 	}
-
-	return p;
+#endif
+	free(block);
+	Unlock_zone();
 }
 
 // Z_Malloc
@@ -245,28 +635,43 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	size_t extrabytes = (1<<alignbits) - 1;
 	size_t padsize = 0;
 	memblock_t *block;
-	void *ptr;
 	memhdr_t *hdr;
 	void *given;
-	size_t blocksize = extrabytes + sizeof *hdr + size;
+	size_t blocksize = extrabytes + ZONEHEADSIZE + size;
 
 #ifdef ZDEBUG2
 	CONS_Debug(DBG_MEMORY, "Z_Malloc %s:%d\n", file, line);
 #endif
 
-	block = xm(sizeof *block);
+	Lock_zone();
+
+#ifdef ZONESLABS
+	if (!alignbits && size <= MAXSLABALLOC && Z_ArenaForTag(tag))
+	{
+		block = Z_SlabAlloc(Z_ArenaForTag(tag), size);
+		hdr = block->hdr;
+		given = (UINT8 *)hdr + sizeof *hdr;
+	}
+	else
+#endif
+	{
 #ifdef HAVE_VALGRIND
-	padsize += (1<<sizeof(size_t))*2;
+		padsize += (1<<sizeof(size_t))*2;
 #endif
-	ptr = xm(blocksize + padsize*2);
+		block = xm(blocksize + padsize*2);
+
+		// This horrible calculation makes sure that "given" is aligned
+		// properly.
+		given = (void *)((size_t)((UINT8 *)block + extrabytes + ZONEHEADSIZE + padsize/2)
+			& ~extrabytes);
 
-	// This horrible calculation makes sure that "given" is aligned
-	// properly.
-	given = (void *)((size_t)((UINT8 *)ptr + extrabytes + sizeof *hdr + padsize/2)
-		& ~extrabytes);
+		// The mem header lives 'sizeof (memhdr_t)' bytes before given.
+		hdr = (memhdr_t *)((UINT8 *)given - sizeof *hdr);
 
-	// The mem header lives 'sizeof (memhdr_t)' bytes before given.
-	hdr = (memhdr_t *)((UINT8 *)given - sizeof *hdr);
+		block->hdr = hdr;
+		block->size = blocksize;
+		block->slab = NULL;
+	}
 
 #ifdef VALGRIND_CREATE_MEMPOOL
 	VALGRIND_CREATE_MEMPOOL(block, padsize, Z_calloc);
@@ -276,21 +681,13 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	VALGRIND_MEMPOOL_ALLOC(block, hdr, size + sizeof *hdr);
 #endif
 
-	block->next = head.next;
-	block->prev = &head;
-	head.next = block;
-	block->next->prev = block;
-
-	block->real = ptr;
-	block->hdr = hdr;
-	block->tag = tag;
 	block->user = NULL;
 #ifdef ZDEBUG
 	block->ownerline = line;
 	block->ownerfile = file;
 #endif
-	block->size = blocksize;
 	block->realsize = size;
+	Z_LinkBlock(block, tag);
 
 	hdr->id = ZONEID;
 	hdr->block = block;
@@ -308,6 +705,8 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 		I_Error("Z_Malloc: attempted to allocate purgable block "
 			"(size %s) with no user", sizeu1(size));
 
+	Unlock_zone();
+
 	return given;
 }
 
@@ -397,18 +796,44 @@ void *Z_ReallocAlign(void *ptr, size_t size,INT32 tag, void *user,  INT32 alignb
 	return rez;
 }
 
+static void Z_CheckTags(INT32 i, INT32 lowtag, INT32 hightag);
+
 void Z_FreeTags(INT32 lowtag, INT32 hightag)
 {
 	memblock_t *block, *next;
+	INT32 tag;
+
+	if (lowtag < 0)
+		lowtag = 0;
+	if (hightag >= NUMZONETAGS)
+		hightag = NUMZONETAGS - 1;
+
+	Z_CheckTags(420, lowtag, hightag);
+
+	Lock_zone();
 
-	Z_CheckHeap(420);
-	for (block = head.next; block != &head; block = next)
+#ifdef ZONESLABS
+	zonebulkfree = true;
+#endif
+
+	for (tag = lowtag; tag <= hightag; tag++)
 	{
-		next = block->next; // get link before freeing
+		memblock_t *head = &zonetags[tag].head;
 
-		if (block->tag >= lowtag && block->tag <= hightag)
-			Z_Free((UINT8 *)block->hdr + sizeof *block->hdr);
+		for (block = head->next; block != head; block = next)
+		{
+			next = block->next; // get link before freeing
+			Z_Free(Block2Ptr(block));
+		}
 	}
+
+#ifdef ZONESLABS
+	zonebulkfree = false;
+	Z_ReleaseEmptySlabs(&staticarena);
+	Z_ReleaseEmptySlabs(&levelarena);
+#endif
+
+	Unlock_zone();
 }
 
 //
@@ -437,19 +862,23 @@ void Z_CheckMemCleanup(void)
 }
 
 
-/** Checks the heap, as well as the memhdr_ts, for any corruption or
-  * other problems.
-  * \param i Identifies from where in the code Z_CheckHeap was called.
+/** Checks the blocks of a range of tags, as well as their memhdr_ts, for
+  * any corruption or other problems.
+  * \param i Identifies from where in the code the check was called.
+  * \param lowtag The lowest tag to check.
+  * \param hightag The highest tag to check.
   * \author Graue <graue@oceanbase.org>
   */
-void Z_CheckHeap(INT32 i)
+static void Z_CheckTags(INT32 i, INT32 lowtag, INT32 hightag)
 {
 	memblock_t *block;
 	memhdr_t *hdr;
 	UINT32 blocknumon = 0;
 	void *given;
+	INT32 tag;
 
-	for (block = head.next; block != &head; block = block->next)
+	for (tag = lowtag; tag <= hightag; tag++)
+	for (block = zonetags[tag].head.next; block != &zonetags[tag].head; block = block->next)
 	{
 		blocknumon++;
 		hdr = block->hdr;
@@ -505,6 +934,18 @@ void Z_CheckHeap(INT32 i)
 				" lacks proper forward link", i, blocknumon
 #ifdef ZDEBUG
 				, block->ownerfile, block->ownerline
+#endif
+			       );
+		}
+		if (block->tag != tag)
+		{
+			I_Error("Z_CheckHeap %d: block %u"
+#ifdef ZDEBUG
+				"(owned by %s:%d)"
+#endif
+				" is in the wrong tag list", i, blocknumon
+#ifdef ZDEBUG
+				, block->ownerfile, block->ownerline
 #endif
 			       );
 		}
@@ -542,6 +983,16 @@ void Z_CheckHeap(INT32 i)
 	}
 }
 
+/** Checks the heap, as well as the memhdr_ts, for any corruption or
+  * other problems.
+  * \param i Identifies from where in the code Z_CheckHeap was called.
+  * \sa Z_CheckTags
+  */
+void Z_CheckHeap(INT32 i)
+{
+	Z_CheckTags(i, 0, NUMZONETAGS - 1);
+}
+
 #ifdef PARANOIA
 void Z_ChangeTag2(void *ptr, INT32 tag, const char *file, INT32 line)
 #else
@@ -554,6 +1005,9 @@ void Z_ChangeTag2(void *ptr, INT32 tag)
 	if (ptr == NULL)
 		return;
 
+	if (numzexternal && Z_IsExternal(ptr))
+		return;
+
 	hdr = (memhdr_t *)((UINT8 *)ptr - sizeof *hdr);
 
 #ifdef VALGRIND_MAKE_MEM_DEFINED
@@ -584,7 +1038,14 @@ void Z_ChangeTag2(void *ptr, INT32 tag)
 		I_Error("Internal memory management error: "
 			"tried to make block purgable but it has no owner");
 
-	block->tag = tag;
+	if (block->tag == tag)
+		return;
+
+	// A slab block keeps its slot; it just moves to the other tag's list.
+	Lock_zone();
+	Z_UnlinkBlock(block);
+	Z_LinkBlock(block, tag);
+	Unlock_zone();
 }
 
 /** Calculates memory usage for a given set of tags.
@@ -597,14 +1058,15 @@ void Z_ChangeTag2(void *ptr, INT32 tag)
 size_t Z_TagsUsage(INT32 lowtag, INT32 hightag)
 {
 	size_t cnt = 0;
-	memblock_t *rover;
+	INT32 tag;
 
-	for (rover = head.next; rover != &head; rover = rover->next)
-	{
-		if (rover->tag < lowtag || rover->tag > hightag)
-			continue;
-		cnt += rover->size + sizeof *rover;
-	}
+	if (lowtag < 0)
+		lowtag = 0;
+	if (hightag >= NUMZONETAGS)
+		hightag = NUMZONETAGS - 1;
+
+	for (tag = lowtag; tag <= hightag; tag++)
+		cnt += zonetags[tag].bytes;
 
 	return cnt;
 }
@@ -614,6 +1076,28 @@ size_t Z_TagUsage(INT32 tagnum)
 	return Z_TagsUsage(tagnum, tagnum);
 }
 
+#ifdef ZONESLABS
+static void Z_PrintArenaOccupancy(zarena_t *arena)
+{
+	UINT32 totalslots = 0;
+	size_t i;
+
+	for (i = 0; i < NUMSLABCLASSES; i++)
+	{
+		zslabclass_t *cls = &arena->classes[i];
+		zslab_t *slab;
+
+		for (slab = cls->partial; slab; slab = slab->next)
+			totalslots += slab->total;
+		for (slab = cls->full; slab; slab = slab->next)
+			totalslots += slab->total;
+	}
+
+	CONS_Printf(M_GetText("%-6s slabs      : %7s KB in %u slabs, %u/%u slots used\n"), arena->name,
+		sizeu1((arena->numslabs * (size_t)SLABSIZE)>>10), arena->numslabs, arena->usedslots, totalslots);
+}
+#endif
+
 void Command_Memfree_f(void)
 {
 	UINT32 freebytes, totalbytes;
@@ -629,6 +1113,8 @@ void Command_Memfree_f(void)
 	CONS_Printf(M_GetText("Special thinker   : %7s KB\n"), sizeu1(Z_TagUsage(PU_LEVSPEC)>>10));
 	CONS_Printf(M_GetText("All purgable      : %7s KB\n"),
 		sizeu1(Z_TagsUsage(PU_PURGELEVEL, INT32_MAX)>>10));
+	if (numzexternal)
+		CONS_Printf(M_GetText("Mapped files      : %7s KB\n"), sizeu1(zexternalbytes>>10));
 
 #ifdef HWRENDER
 	if (rendermode != render_soft && rendermode != render_none)
@@ -640,6 +1126,24 @@ void Command_Memfree_f(void)
 	}
 #endif
 
+#ifdef ZONESLABS
+	{
+		INT32 tag;
+
+		CONS_Printf("\x82%s", M_GetText("Slab Occupancy\n"));
+		Z_PrintArenaOccupancy(&staticarena);
+		Z_PrintArenaOccupancy(&levelarena);
+
+		for (tag = 0; tag < NUMZONETAGS; tag++)
+		{
+			if (!zonetags[tag].slabblocks)
+				continue;
+			CONS_Printf(M_GetText("  Tag %3d         : %7s KB in %u of %u blocks\n"), tag,
+				sizeu1(zonetags[tag].slabbytes>>10), zonetags[tag].slabblocks, zonetags[tag].blocks);
+		}
+	}
+#endif
+
 	CONS_Printf("\x82%s", M_GetText("System Memory Info\n"));
 	freebytes = I_GetFreeMem(&totalbytes);
 	CONS_Printf(M_GetText("    Total physical memory: %7u KB\n"), totalbytes>>10);
@@ -650,8 +1154,8 @@ void Command_Memfree_f(void)
 static void Command_Memdump_f(void)
 {
 	memblock_t *block;
-	INT32 mintag = 0, maxtag = INT32_MAX;
-	INT32 i;
+	INT32 mintag = 0, maxtag = NUMZONETAGS - 1;
+	INT32 i, tag;
 
 	if ((i = COM_CheckParm("-min")))
 		mintag = atoi(COM_Argv(i + 1));
@@ -659,11 +1163,17 @@ static void Command_Memdump_f(void)
 	if ((i = COM_CheckParm("-max")))
 		maxtag = atoi(COM_Argv(i + 1));
 
-	for (block = head.next; block != &head; block = block->next)
-		if (block->tag >= mintag && block->tag <= maxtag)
+	if (mintag < 0)
+		mintag = 0;
+	if (maxtag >= NUMZONETAGS)
+		maxtag = NUMZONETAGS - 1;
+
+	for (tag = mintag; tag <= maxtag; tag++)
+		for (block = zonetags[tag].head.next; block != &zonetags[tag].head; block = block->next)
 		{
 			char *filename = strrchr(block->ownerfile, PATHSEP[0]);
-			CONS_Printf("[%3d] %s (%s) bytes @ %s:%d\n", block->tag, sizeu1(block->size), sizeu2(block->realsize), filename ? filename + 1 : block->ownerfile, block->ownerline);
+			CONS_Printf("[%3d] %s (%s) bytes%s @ %s:%d\n", block->tag, sizeu1(block->size), sizeu2(block->realsize),
+				block->slab ? " slab" : "", filename ? filename + 1 : block->ownerfile, block->ownerline);
 		}
 }
 #endif
@@ -687,6 +1197,12 @@ void Z_SetUser2(void *ptr, void **newuser)
 	if (ptr == NULL)
 		return;
 
+	if (numzexternal && Z_IsExternal(ptr))
+	{
+		*newuser = ptr;
+		return;
+	}
+
 	hdr = (memhdr_t *)((UINT8 *)ptr - sizeof *hdr);
 
 #ifdef VALGRIND_MAKE_MEM_DEFINED
@@ -707,6 +1223,8 @@ void Z_SetUser2(void *ptr, void **newuser)
 		I_Error("Internal memory management error: "
 			"tried to make block purgable but it has no owner");
 
+	Lock_zone();
 	block->user = (void*)newuser;
 	*newuser = ptr;
+	Unlock_zone();
 }
@@ -99,6 +99,12 @@ void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignb
 size_t Z_TagUsage(INT32 tagnum);
 size_t Z_TagsUsage(INT32 lowtag, INT32 hightag);
 
+// Memory the zone doesn't own (mapped wad files) whose pointers may still be
+// handed to Z_Free, Z_ChangeTag and Z_SetUser; those leave it alone.
+void Z_AddExternalRange(void *start, size_t size);
+void Z_RemoveExternalRange(void *start);
+boolean Z_IsExternal(const void *ptr);
+
 char *Z_StrDup(const char *in);
 
 // This is used to get the local FILE : LINE info from CPP